@@ -0,0 +1,158 @@
+/**
+ * @file bench_allocations.cpp
+ * @brief 一次 RPC 往返的堆分配次数基准测试
+ * 
+ * 不经过网络，按客户端和服务器的热路径模拟一次往返：
+ * 客户端编码请求，服务器扫描信封、解析参数、回显结果并编码响应，客户端扫描响应、解析结果。
+ * 比较两种信封编码方式每次往返的堆分配次数和耗时：
+ * - tree：make_request() / make_response_ok() 构造消息对象后编码（参数和结果移入消息）
+ * - parts：从 MessageParts 直接编码（见 message_parts.hpp），只有参数和结果经过 JSON 树
+ * 
+ * 两种方式共用同一个输出缓冲区，参数在每次往返中重新构造；
+ * 解析参数和结果的分配在两种方式中相同。
+ * 
+ * 用法：bench_allocations [每种组合的往返次数]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/id_generator.hpp"
+#include "zenoh_rpc/message_parts.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/// 全局堆分配计数
+std::atomic<size_t> g_allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/// 防止编译器优化掉结果
+volatile size_t g_sink = 0;
+
+/**
+ * @struct Result
+ * @brief 一种组合的测量结果
+ */
+struct Result {
+    double ns_per_call;         ///< 每次往返的耗时
+    double allocs_per_call;     ///< 每次往返的堆分配次数
+};
+
+/**
+ * @brief 模拟一次往返
+ * @param use_parts 为 true 时从 MessageParts 编码
+ * @param shape 参数模板（每次往返复制一份，模拟调用方构造参数）
+ * @param id 请求ID
+ * @param type 编码类型
+ * @param buffer 复用的输出缓冲区
+ */
+void round_trip(bool use_parts, const json& shape, const std::string& id, EncodingType type, std::string& buffer) {
+    json params = shape;
+    if (use_parts) {
+        encode_message_into(MessageParts::request("svc.process", params, id), type, buffer);
+    } else {
+        encode_into(make_request("svc.process", std::move(params), id), type, buffer);
+    }
+    
+    // 服务器：扫描信封，解析参数，回显为结果
+    json result;
+    std::string reply_id;
+    {
+        Envelope request = scan_envelope(buffer.data(), buffer.size(), type);
+        result = request.parse_params();
+        reply_id = request.id;
+    }
+    if (use_parts) {
+        encode_message_into(MessageParts::response_ok(result, reply_id), type, buffer);
+    } else {
+        encode_into(make_response_ok(std::move(result), reply_id), type, buffer);
+    }
+    
+    // 客户端：扫描响应，解析结果
+    Envelope response = scan_envelope(buffer.data(), buffer.size(), type);
+    json value = response.parse_result();
+    g_sink = g_sink + value.size() + response.id.size();
+}
+
+/**
+ * @brief 测量一种组合
+ */
+Result measure(bool use_parts, const json& shape, const std::string& id, EncodingType type, size_t count) {
+    std::string buffer;
+    round_trip(use_parts, shape, id, type, buffer);
+    
+    size_t allocations = g_allocations.load();
+    bench::Stopwatch watch;
+    for (size_t i = 0; i < count; ++i) {
+        round_trip(use_parts, shape, id, type, buffer);
+    }
+    double seconds = watch.seconds();
+    return Result{seconds * 1e9 / count, static_cast<double>(g_allocations.load() - allocations) / count};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 100000));
+    
+    json records = json::array();
+    for (int i = 0; i < 8; ++i) {
+        records.push_back({{"id", i}, {"name", "sensor-" + std::to_string(i)}, {"value", i * 0.5}});
+    }
+    struct Shape {
+        const char* name;
+        json params;
+    };
+    std::vector<Shape> shapes = {
+        {"scalars", json::array({1, 2})},
+        {"object", json{{"x", 1.5}, {"y", -2.0}, {"label", "point"}}},
+        {"records", json{{"records", records}}},
+    };
+    
+    // 二进制编码的客户端使用数字 id，其他编码使用默认的 UUID
+    IdGenerator numeric(IdMode::NUMERIC);
+    std::string uuid = gen_uuid();
+    
+    std::cout << "round trips per run: " << count << std::endl;
+    std::cout << "params\tencoding\tmode\tns/call\tallocs/call" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& shape : shapes) {
+        for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK, EncodingType::BINARY}) {
+            std::string id = type == EncodingType::BINARY ? numeric.next() : uuid;
+            for (bool use_parts : {false, true}) {
+                Result result = measure(use_parts, shape.params, id, type, count);
+                std::cout << shape.name << "\t" << codec_for(type).name() << "\t" << (use_parts ? "parts" : "tree") << "\t"
+                          << result.ns_per_call << "\t" << result.allocs_per_call << std::endl;
+            }
+        }
+    }
+    return 0;
+}
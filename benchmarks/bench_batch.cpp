@@ -0,0 +1,95 @@
+/**
+ * @file bench_batch.cpp
+ * @brief 批量调用基准测试
+ * 
+ * 在本机 peer 模式回环上比较不同批量大小（1-1024）下的调用吞吐量。
+ * 每种批量大小发送相同数量的调用，批量大小为 N 时只需要 1/N 的查询往返。
+ * 
+ * 用法：bench_batch [每种批量大小的调用次数] [服务器批量并行度]
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/zenoh_rpc.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+const std::string kKeyExpr = "bench/batch";
+
+/**
+ * @class BenchDispatcher
+ * @brief 基准测试使用的方法分发器
+ */
+class BenchDispatcher : public DispatcherBase {
+public:
+    BenchDispatcher() {
+        register_method("add", [](const json& params) -> json {
+            return params[0].get<int64_t>() + params[1].get<int64_t>();
+        });
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t total = static_cast<size_t>(bench::arg_or(argc, argv, 1, 16384));
+    const size_t parallelism = static_cast<size_t>(bench::arg_or(argc, argv, 2, 1));
+
+    BenchDispatcher dispatcher;
+    // 并行块在服务器的执行器中执行
+    ExecutorOptions executor_options;
+    executor_options.num_threads = std::max<size_t>(parallelism, 1);
+    Executor executor(executor_options);
+    ServerOptions options;
+    options.executor = &executor;
+    options.batch_parallelism = parallelism;
+    Session server_session = bench::make_listen_session();
+    Server server(kKeyExpr, dispatcher, server_session, options);
+    server.start();
+
+    Session client_session = bench::make_connect_session();
+    Client client(kKeyExpr, client_session);
+    bench::wait_for_discovery();
+
+    // 预热
+    for (int i = 0; i < 100; ++i) {
+        client.call("add", json::array({i, i}));
+    }
+
+    std::cout << "calls per batch size: " << total << ", server batch parallelism: " << parallelism << std::endl;
+    std::cout << "batch\tqueries\tcalls/sec\tus/call" << std::endl;
+    for (size_t batch_size : {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024}) {
+        std::vector<BatchCall> calls;
+        calls.reserve(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            calls.push_back({"add", json::array({i, 1})});
+        }
+
+        size_t queries = (total + batch_size - 1) / batch_size;
+        size_t failures = 0;
+        bench::Stopwatch watch;
+        for (size_t q = 0; q < queries; ++q) {
+            for (const auto& result : client.call_batch(calls)) {
+                if (!result) {
+                    failures++;
+                }
+            }
+        }
+        double elapsed = watch.seconds();
+        size_t done = queries * batch_size;
+
+        std::cout << batch_size << "\t" << queries << "\t"
+                  << static_cast<long>(done / elapsed) << "\t\t"
+                  << elapsed * 1e6 / done << std::endl;
+        if (failures > 0) {
+            std::cerr << "  batch " << batch_size << ": " << failures << " calls failed" << std::endl;
+        }
+    }
+
+    server.stop();
+    return 0;
+}
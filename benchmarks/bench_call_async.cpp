@@ -0,0 +1,100 @@
+/**
+ * @file bench_call_async.cpp
+ * @brief 异步调用吞吐量基准测试
+ * 
+ * 在本机 peer 模式回环上测量 Client::call_async 的吞吐量（calls/sec）
+ * 与在途请求深度（同时未完成的调用数）之间的关系。
+ * 深度 1 等价于同步 Client::call。
+ * 
+ * 用法：bench_call_async [每个深度的调用次数]
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/zenoh_rpc.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+const std::string kKeyExpr = "bench/call_async";
+
+/**
+ * @brief 以固定在途深度发起 total 次调用
+ * @param client RPC 客户端
+ * @param depth 在途深度
+ * @param total 调用总数
+ * @return 每秒完成的调用数
+ */
+double run_depth(Client& client, size_t depth, size_t total) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t in_flight = 0;
+    std::atomic<size_t> failures{0};
+
+    bench::Stopwatch watch;
+    for (size_t sent = 0; sent < total; ++sent) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return in_flight < depth; });
+            ++in_flight;
+        }
+        client.call_async("echo", json::array({sent}), [&](std::exception_ptr error, json) {
+            if (error) {
+                failures++;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            --in_flight;
+            cv.notify_one();
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return in_flight == 0; });
+    }
+    double elapsed = watch.seconds();
+
+    if (failures > 0) {
+        std::cerr << "  depth " << depth << ": " << failures << " calls failed" << std::endl;
+    }
+    return total / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t total = static_cast<size_t>(bench::arg_or(argc, argv, 1, 20000));
+
+    // 服务器端：直接声明可查询对象，避免服务器日志影响测量
+    Session server_session = bench::make_listen_session();
+    auto queryable = server_session.declare_queryable(kKeyExpr, [](const zenoh::Query& query) {
+        auto payload = query.get_payload();
+        if (!payload.has_value()) {
+            return;
+        }
+        json request = decode_json(payload->get().as_string());
+        json response = make_response_ok(request["params"], request["id"].get<std::string>());
+        query.reply(query.get_keyexpr(), encode_json(response));
+    });
+
+    Session client_session = bench::make_connect_session();
+    Client client(kKeyExpr, client_session);
+    bench::wait_for_discovery();
+
+    // 预热
+    for (int i = 0; i < 100; ++i) {
+        client.call("echo", json::array({i}));
+    }
+
+    std::cout << "calls per depth: " << total << std::endl;
+    std::cout << "depth\tcalls/sec" << std::endl;
+    for (size_t depth : {1, 2, 4, 8, 16, 32, 64, 128, 256, 512}) {
+        double rate = run_depth(client, depth, total);
+        std::cout << depth << "\t" << static_cast<long>(rate) << std::endl;
+    }
+    return 0;
+}
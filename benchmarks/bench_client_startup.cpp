@@ -0,0 +1,82 @@
+/**
+ * @file bench_client_startup.cpp
+ * @brief 客户端创建开销基准测试
+ * 
+ * 在本机 peer 模式回环上比较两种会话方式创建 N 个客户端并各完成一次调用的耗时：
+ * - private：每个客户端打开独占会话（SessionSharing::PRIVATE）
+ * - shared：客户端从全局会话池获取同一个会话（默认）
+ * 
+ * 同时输出打开的会话数，也就是到服务器的传输连接数。
+ * 
+ * 用法：bench_client_startup [客户端数]
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/zenoh_rpc.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+const std::string kKeyExpr = "bench/client_startup";
+
+/**
+ * @brief 创建 count 个客户端并各调用一次
+ * @param sharing 会话共享方式
+ * @param count 客户端数
+ */
+void run(SessionSharing sharing, size_t count) {
+    std::vector<std::unique_ptr<Client>> clients;
+    clients.reserve(count);
+    
+    bench::Stopwatch watch;
+    for (size_t i = 0; i < count; ++i) {
+        clients.push_back(std::make_unique<Client>(kKeyExpr, SessionMode::PEER,
+                                                   std::vector<std::string>{bench::kLoopbackEndpoint}, "json",
+                                                   std::chrono::milliseconds(5000), sharing));
+    }
+    double open_ms = watch.seconds() * 1e3;
+    size_t sessions = sharing == SessionSharing::SHARED ? SessionPool::global().size() : count;
+    
+    // 新会话需要等待连接建立和声明传播，首次调用的耗时包含这部分
+    size_t failures = 0;
+    for (auto& client : clients) {
+        try {
+            client->call("echo", json::array({1}));
+        } catch (const RpcError&) {
+            ++failures;
+        }
+    }
+    double total_ms = watch.seconds() * 1e3;
+    
+    std::cout << (sharing == SessionSharing::SHARED ? "shared" : "private") << "\t" << count << "\t" << sessions
+              << "\t" << open_ms << "\t" << total_ms << std::endl;
+    if (failures > 0) {
+        std::cerr << "  " << failures << " calls failed" << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 16));
+    
+    Session server_session = bench::make_listen_session();
+    DispatcherBase dispatcher;
+    dispatcher.register_method("echo", [](const json& params) -> json { return params; });
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    bench::wait_for_discovery();
+    
+    std::cout << "mode\tclients\tsessions\topen_ms\ttotal_ms" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    run(SessionSharing::PRIVATE, count);
+    run(SessionSharing::SHARED, count);
+    
+    server.stop();
+    return 0;
+}
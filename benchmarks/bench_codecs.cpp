@@ -0,0 +1,121 @@
+/**
+ * @file bench_codecs.cpp
+ * @brief 注册表中各编解码器的大小和速度对比基准测试
+ * 
+ * 对每个编解码器编码一个带代表性参数的 JSON-RPC 请求，测量：
+ * - 编码后的字节数
+ * - 编码耗时（复用同一个输出缓冲区）
+ * - 完整解码耗时
+ * - 服务器路径的耗时：扫描信封并解析参数
+ *   （CBOR、UBJSON、BSON 没有专门的扫描器，先解码再转为 MessagePack 扫描）
+ * 
+ * 参数分为三种：数字数组（1024 个浮点数）、嵌套对象（64 条记录）、字符串（64 个 64 字节的字符串）。
+ * 结果可用于为每个服务选择编码。
+ * 
+ * 用法：bench_codecs [每种组合的迭代次数]
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/envelope.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/// 防止编译器优化掉结果
+volatile size_t g_sink = 0;
+
+/**
+ * @struct Result
+ * @brief 一种组合的测量结果
+ */
+struct Result {
+    size_t bytes;
+    double encode_ns;
+    double decode_ns;
+    double scan_ns;
+};
+
+/**
+ * @brief 测量一个编解码器
+ * @param codec 编解码器
+ * @param request 要编码的请求
+ * @param count 迭代次数
+ */
+Result measure(const Codec& codec, const json& request, size_t count) {
+    Result measured{0, 0.0, 0.0, 0.0};
+    std::string buffer;
+    
+    bench::Stopwatch watch;
+    for (size_t i = 0; i < count; ++i) {
+        codec.encode_into(request, buffer);
+        g_sink = g_sink + buffer.size();
+    }
+    measured.encode_ns = watch.seconds() * 1e9 / count;
+    measured.bytes = buffer.size();
+    
+    watch.reset();
+    for (size_t i = 0; i < count; ++i) {
+        json decoded = codec.decode(buffer.data(), buffer.size());
+        g_sink = g_sink + decoded.size();
+    }
+    measured.decode_ns = watch.seconds() * 1e9 / count;
+    
+    watch.reset();
+    for (size_t i = 0; i < count; ++i) {
+        Envelope envelope = scan_envelope(buffer.data(), buffer.size(), codec.type());
+        json params = envelope.parse_params();
+        g_sink = g_sink + params.size() + envelope.method.size();
+    }
+    measured.scan_ns = watch.seconds() * 1e9 / count;
+    return measured;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 20000));
+    
+    json numbers = json::array();
+    for (int i = 0; i < 1024; ++i) {
+        numbers.push_back(i * 0.25 - 100.0);
+    }
+    json records = json::array();
+    for (int i = 0; i < 64; ++i) {
+        records.push_back({{"id", i}, {"name", "sensor-" + std::to_string(i)}, {"active", i % 2 == 0},
+                           {"position", {{"x", i * 1.5}, {"y", -i * 0.5}, {"z", 0.0}}},
+                           {"tags", json::array({"a", "b"})}});
+    }
+    json strings = json::array();
+    for (int i = 0; i < 64; ++i) {
+        strings.push_back(std::string(64, static_cast<char>('a' + i % 26)));
+    }
+    struct Shape {
+        const char* name;
+        json params;
+    };
+    std::vector<Shape> shapes = {
+        {"numbers", json{{"values", numbers}}},
+        {"nested", json{{"records", records}}},
+        {"strings", json{{"lines", strings}}},
+    };
+    
+    CodecRegistry& registry = CodecRegistry::instance();
+    std::cout << "iterations per run: " << count << std::endl;
+    std::cout << "params\tcodec\tbytes\tencode_ns\tdecode_ns\tscan+params_ns" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& shape : shapes) {
+        json request = make_request("svc.process", shape.params, "1");
+        for (const auto& name : registry.names()) {
+            Result result = measure(*registry.find(name), request, count);
+            std::cout << shape.name << "\t" << name << "\t" << result.bytes << "\t" << result.encode_ns << "\t"
+                      << result.decode_ns << "\t" << result.scan_ns << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_common.hpp
+ * @brief 基准测试公共工具
+ * 
+ * 提供基准测试程序共用的辅助功能：
+ * - 本机 peer 模式回环会话（服务器监听、客户端直连，不依赖路由器和多播）
+ * - 计时与结果输出
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "zenoh_rpc/session.hpp"
+
+namespace bench {
+
+/// 默认回环端点
+inline const std::string kLoopbackEndpoint = "tcp/127.0.0.1:7460";
+
+/**
+ * @brief 创建监听回环端点的 peer 模式配置（服务器端）
+ * @param endpoint 监听端点
+ * @return Zenoh 配置
+ */
+inline zenoh::Config listen_config(const std::string& endpoint = kLoopbackEndpoint) {
+    zenoh::Config config = zenoh::Config::create_default();
+    config.insert_json5("mode", "\"peer\"");
+    config.insert_json5("listen/endpoints", "[\"" + endpoint + "\"]");
+    config.insert_json5("scouting/multicast/enabled", "false");
+    return config;
+}
+
+/**
+ * @brief 创建连接回环端点的 peer 模式配置（客户端）
+ * @param endpoint 连接端点
+ * @return Zenoh 配置
+ */
+inline zenoh::Config connect_config(const std::string& endpoint = kLoopbackEndpoint) {
+    zenoh::Config config = zenoh::Config::create_default();
+    config.insert_json5("mode", "\"peer\"");
+    config.insert_json5("connect/endpoints", "[\"" + endpoint + "\"]");
+    config.insert_json5("scouting/multicast/enabled", "false");
+    return config;
+}
+
+/**
+ * @brief 创建监听回环端点的 peer 模式会话（服务器端）
+ * @param endpoint 监听端点
+ * @return 新建的会话
+ */
+inline zenoh_rpc::Session make_listen_session(const std::string& endpoint = kLoopbackEndpoint) {
+    return zenoh_rpc::Session(listen_config(endpoint));
+}
+
+/**
+ * @brief 创建连接回环端点的 peer 模式会话（客户端）
+ * @param endpoint 连接端点
+ * @return 新建的会话
+ */
+inline zenoh_rpc::Session make_connect_session(const std::string& endpoint = kLoopbackEndpoint) {
+    return zenoh_rpc::Session(connect_config(endpoint));
+}
+
+/**
+ * @brief 等待两个会话完成连接和声明传播
+ */
+inline void wait_for_discovery() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+}
+
+/**
+ * @class Stopwatch
+ * @brief 简单的单调时钟计时器
+ */
+class Stopwatch {
+public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    /// 重新开始计时
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+
+    /// 已经过的秒数
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief 从命令行读取整数参数
+ * @param argc 参数个数
+ * @param argv 参数列表
+ * @param index 参数位置
+ * @param fallback 缺省值
+ * @return 参数值
+ */
+inline long arg_or(int argc, char** argv, int index, long fallback) {
+    return argc > index ? std::strtol(argv[index], nullptr, 10) : fallback;
+}
+
+} // namespace bench
@@ -0,0 +1,139 @@
+/**
+ * @file bench_dispatch.cpp
+ * @brief 方法分发微基准测试
+ * 
+ * 在注册 10 到 10000 个方法时比较单次分发（查找加调用）的耗时和堆分配次数：
+ * - legacy：旧实现（unordered_map<std::string, std::function>，先把方法名复制成 std::string）
+ * - registry：未发布的分发器（互斥锁保护的有序注册表，以 std::string_view 查找）
+ * - published：发布后的分发器（完美哈希表快照）
+ * 
+ * 方法名形如 "service.method_123"，超过短字符串优化的长度，复制时需要分配内存。
+ * 
+ * 用法：bench_dispatch [每种方式的分发次数]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/jsonrpc_server.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/// 全局堆分配计数
+std::atomic<size_t> g_allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/// 防止编译器优化掉分发结果
+volatile int64_t g_sink = 0;
+
+/**
+ * @struct Result
+ * @brief 一种分发方式的测量结果
+ */
+struct Result {
+    double ns_per_call;        ///< 每次分发的纳秒数
+    double allocs_per_call;    ///< 每次分发的堆分配次数
+};
+
+/**
+ * @brief 按给定的请求顺序调用 count 次 dispatch
+ * @param requests 请求（method 和 params 字段）
+ * @param count 分发次数
+ * @param dispatch 分发函数
+ */
+template<typename Dispatch>
+Result measure(const std::vector<json>& requests, size_t count, Dispatch dispatch) {
+    size_t allocations = g_allocations.load();
+    bench::Stopwatch watch;
+    int64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const json& request = requests[i % requests.size()];
+        total += dispatch(request).template get<int64_t>();
+    }
+    double seconds = watch.seconds();
+    g_sink = g_sink + total;
+    return Result{seconds * 1e9 / count, static_cast<double>(g_allocations.load() - allocations) / count};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 2000000));
+    
+    std::cout << "dispatches per run: " << count << std::endl;
+    std::cout << "methods\tmode\tns/call\tallocs/call" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    
+    for (size_t methods : {10, 100, 1000, 10000}) {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < methods; ++i) {
+            names.push_back("service.method_" + std::to_string(i));
+        }
+        
+        // 请求按随机顺序访问所有方法，避免只命中缓存中的少数条目
+        std::vector<json> requests;
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<size_t> pick(0, methods - 1);
+        for (size_t i = 0; i < 4096; ++i) {
+            requests.push_back(json{{"method", names[pick(rng)]}, {"params", json::array({1})}});
+        }
+        
+        std::unordered_map<std::string, std::function<json(const json&)>> legacy;
+        DispatcherBase dispatcher;
+        for (size_t i = 0; i < methods; ++i) {
+            int64_t value = static_cast<int64_t>(i);
+            legacy[names[i]] = [value](const json&) -> json { return value; };
+            dispatcher.register_method(names[i], [value](const json&) -> json { return value; });
+        }
+        
+        Result legacy_result = measure(requests, count, [&](const json& request) {
+            std::string method = request["method"];
+            auto it = legacy.find(method);
+            return it->second(request["params"]);
+        });
+        Result registry_result = measure(requests, count, [&](const json& request) {
+            return dispatcher.dispatch(request["method"].get_ref<const std::string&>(), request["params"]);
+        });
+        dispatcher.publish();
+        Result published_result = measure(requests, count, [&](const json& request) {
+            return dispatcher.dispatch(request["method"].get_ref<const std::string&>(), request["params"]);
+        });
+        
+        for (const auto& [mode, result] : {std::pair<const char*, Result>{"legacy", legacy_result},
+                                           {"registry", registry_result},
+                                           {"published", published_result}}) {
+            std::cout << methods << "\t" << mode << "\t" << result.ns_per_call << "\t"
+                      << std::setprecision(2) << result.allocs_per_call << std::setprecision(1) << std::endl;
+        }
+    }
+    return 0;
+}
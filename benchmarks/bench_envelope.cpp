@@ -0,0 +1,108 @@
+/**
+ * @file bench_envelope.cpp
+ * @brief 信封编码大小和 CPU 开销的对比基准测试
+ * 
+ * 对 JSON、MessagePack 和二进制信封比较一次完整调用在编解码上的开销：
+ * - 请求和响应的字节数
+ * - 客户端编码请求、服务器扫描请求并解析参数、服务器编码响应、
+ *   客户端扫描响应并解析结果的总耗时
+ * 
+ * JSON 和 MessagePack 使用默认的 UUID 请求ID，二进制信封使用数字请求ID（客户端的默认设置）。
+ * 参数分为小参数（两个整数）和较大的参数（包含 1KB 字符串和 64 个数字的对象）。
+ * 
+ * 用法：bench_envelope [每种组合的调用次数]
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/id_generator.hpp"
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/// 防止编译器优化掉结果
+volatile size_t g_sink = 0;
+
+/**
+ * @struct Result
+ * @brief 一种组合的测量结果
+ */
+struct Result {
+    size_t request_bytes;
+    size_t response_bytes;
+    double ns_per_call;
+};
+
+/**
+ * @brief 模拟 count 次调用的编解码过程
+ * @param type 编码类型
+ * @param params 请求参数
+ * @param result 方法结果
+ * @param count 调用次数
+ */
+Result measure(EncodingType type, const json& params, const json& result, size_t count) {
+    IdGenerator ids(type == EncodingType::BINARY ? IdMode::NUMERIC : IdMode::UUID);
+    std::string request_buffer;
+    std::string response_buffer;
+    Result measured{0, 0, 0.0};
+    
+    bench::Stopwatch watch;
+    for (size_t i = 0; i < count; ++i) {
+        // 客户端：构造并编码请求
+        std::string id = ids.next();
+        encode_into(make_request("math.process", params, id), type, request_buffer);
+        
+        // 服务器：扫描信封，解析参数，编码响应
+        Envelope request = scan_envelope(request_buffer.data(), request_buffer.size(), type);
+        json parsed = request.parse_params();
+        encode_into(make_response_ok(result, request.id), type, response_buffer);
+        
+        // 客户端：扫描响应，解析结果
+        Envelope response = scan_envelope(response_buffer.data(), response_buffer.size(), type);
+        json value = response.parse_result();
+        g_sink = g_sink + parsed.size() + value.size() + (response.id == id ? 1 : 0);
+    }
+    measured.ns_per_call = watch.seconds() * 1e9 / count;
+    measured.request_bytes = request_buffer.size();
+    measured.response_bytes = response_buffer.size();
+    return measured;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 200000));
+    
+    json large_params = {{"text", std::string(1024, 'x')}, {"values", json::array()}};
+    for (int i = 0; i < 64; ++i) {
+        large_params["values"].push_back(i * 1.5);
+    }
+    struct Shape {
+        const char* name;
+        json params;
+        json result;
+    };
+    std::vector<Shape> shapes = {
+        {"small", json::array({1, 2}), json(3)},
+        {"large", large_params, json{{"ok", true}, {"count", 64}}},
+    };
+    
+    std::cout << "calls per run: " << count << std::endl;
+    std::cout << "params\tencoding\trequest_bytes\tresponse_bytes\tns/call" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& shape : shapes) {
+        for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK, EncodingType::BINARY}) {
+            Result result = measure(type, shape.params, shape.result, count);
+            const char* name = type == EncodingType::JSON ? "json" : type == EncodingType::MSGPACK ? "msgpack" : "binary";
+            std::cout << shape.name << "\t" << name << "\t" << result.request_bytes << "\t"
+                      << result.response_bytes << "\t" << result.ns_per_call << std::endl;
+        }
+    }
+    return 0;
+}
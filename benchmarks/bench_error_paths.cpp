@@ -0,0 +1,139 @@
+/**
+ * @file bench_error_paths.cpp
+ * @brief 错误路径的分发开销基准测试
+ * 
+ * 不经过网络，比较分发器报告常见错误的两种方式每次调用的耗时：
+ * - throw：dispatch() 抛出 RpcError，调用者捕获后读取错误代码
+ * - result：try_dispatch() 返回 RpcResult，不构造异常对象
+ * 
+ * 错误场景：
+ * - missing：方法不存在（-32601）
+ * - typed：类型化方法的参数类型不符（-32602）
+ * - reject：处理函数拒绝请求（throw 方式抛出 InvalidParamsError，result 方式返回 RpcResult::err()）
+ * 
+ * 栈展开在多个线程同时抛出异常时还会相互竞争，因此分别以 1 个线程和多个线程测量。
+ * 
+ * 用法：bench_error_paths [每个线程的调用次数] [线程数]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/jsonrpc_server.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/// 防止编译器优化掉错误代码
+std::atomic<int64_t> g_sink{0};
+
+/**
+ * @class ErrorDispatcher
+ * @brief 以两种方式拒绝请求的分发器
+ */
+class ErrorDispatcher : public DispatcherBase {
+public:
+    ErrorDispatcher() {
+        register_method<int(int, int)>("add", [](int a, int b) { return a + b; });
+        register_method("reject_throw", [](const json& params) -> json {
+            if (!params.contains("amount")) {
+                throw InvalidParamsError("Missing amount");
+            }
+            return params["amount"];
+        });
+        register_result_method("reject_result", [](const json& params) {
+            if (!params.contains("amount")) {
+                return RpcResult::err(-32602, "Missing amount");
+            }
+            return RpcResult::ok(params["amount"]);
+        });
+        publish();
+    }
+};
+
+/**
+ * @struct Case
+ * @brief 一个错误场景
+ */
+struct Case {
+    const char* name;           ///< 场景名
+    const char* throw_method;   ///< throw 方式调用的方法
+    const char* result_method;  ///< result 方式调用的方法
+    json params;                ///< 请求参数
+};
+
+/**
+ * @brief 在多个线程中重复调用，返回每次调用的平均耗时
+ * @param dispatcher 分发器
+ * @param c 错误场景
+ * @param use_result 为 true 时使用 try_dispatch()
+ * @param count 每个线程的调用次数
+ * @param threads 线程数
+ */
+double measure(ErrorDispatcher& dispatcher, const Case& c, bool use_result, size_t count, size_t threads) {
+    auto run = [&] {
+        int64_t codes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (use_result) {
+                RpcResult result = dispatcher.try_dispatch(c.result_method, c.params);
+                codes += result.error().code;
+            } else {
+                try {
+                    dispatcher.dispatch(c.throw_method, c.params);
+                } catch (const RpcError& e) {
+                    codes += e.get_code();
+                }
+            }
+        }
+        g_sink.fetch_add(codes, std::memory_order_relaxed);
+    };
+    
+    bench::Stopwatch watch;
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(run);
+    }
+    run();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return watch.seconds() * 1e9 / static_cast<double>(count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 200000));
+    const size_t max_threads = static_cast<size_t>(
+        bench::arg_or(argc, argv, 2, std::min<unsigned>(8, std::max(1u, std::thread::hardware_concurrency()))));
+    
+    ErrorDispatcher dispatcher;
+    std::vector<Case> cases = {
+        {"missing", "service.missing", "service.missing", json::array({1, 2})},
+        {"typed", "add", "add", json::array({1, "two"})},
+        {"reject", "reject_throw", "reject_result", json::object()},
+    };
+    
+    std::cout << "calls per thread: " << count << std::endl;
+    std::cout << "case\tmode\tthreads\tns/call" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& c : cases) {
+        for (size_t threads : {size_t{1}, max_threads}) {
+            for (bool use_result : {false, true}) {
+                double ns = measure(dispatcher, c, use_result, count, threads);
+                std::cout << c.name << "\t" << (use_result ? "result" : "throw") << "\t" << threads << "\t" << ns
+                          << std::endl;
+            }
+            if (max_threads == 1) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
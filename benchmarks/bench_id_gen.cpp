@@ -0,0 +1,105 @@
+/**
+ * @file bench_id_gen.cpp
+ * @brief 请求 ID 生成微基准测试
+ * 
+ * 比较三种 ID 生成方式的单次耗时：
+ * - legacy：旧实现（std::stringstream 加 32 次 mt19937 抽样，仅单线程，多线程下存在数据竞争）
+ * - uuid：线程局部 xoshiro256** 直接格式化到固定缓冲区
+ * - compact：前缀加单调计数器
+ * 
+ * 用法：bench_id_gen [每种方式的生成次数] [线程数]
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/id_generator.hpp"
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+/**
+ * @brief 旧的 UUID 生成实现（用于对比）
+ */
+std::string legacy_gen_uuid() {
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    static std::uniform_int_distribution<> dis(0, 15);
+    static std::uniform_int_distribution<> dis2(8, 11);
+    
+    std::stringstream ss;
+    int i;
+    ss << std::hex;
+    for (i = 0; i < 8; i++) {
+        ss << dis(gen);
+    }
+    ss << "-";
+    for (i = 0; i < 4; i++) {
+        ss << dis(gen);
+    }
+    ss << "-4";
+    for (i = 0; i < 3; i++) {
+        ss << dis(gen);
+    }
+    ss << "-";
+    ss << dis2(gen);
+    for (i = 0; i < 3; i++) {
+        ss << dis(gen);
+    }
+    ss << "-";
+    for (i = 0; i < 12; i++) {
+        ss << dis(gen);
+    }
+    return ss.str();
+}
+
+/// 防止编译器优化掉生成结果
+volatile size_t g_sink = 0;
+
+/**
+ * @brief 在 threads 个线程中各调用 count 次 generate
+ * @return 每次调用的平均纳秒数（按总调用次数和墙钟时间计算）
+ */
+template<typename Generate>
+double measure(size_t count, size_t threads, Generate generate) {
+    bench::Stopwatch watch;
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            size_t total = 0;
+            for (size_t i = 0; i < count; ++i) {
+                total += generate().size();
+            }
+            g_sink = g_sink + total;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return watch.seconds() * 1e9 / (count * threads);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 1, 1000000));
+    const size_t threads = static_cast<size_t>(bench::arg_or(argc, argv, 2, 4));
+
+    IdGenerator compact(IdMode::COMPACT);
+
+    std::cout << "ids per run: " << count << std::endl;
+    std::cout << "method\tthreads\tns/id" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "legacy\t1\t" << measure(count, 1, legacy_gen_uuid) << std::endl;
+    std::cout << "uuid\t1\t" << measure(count, 1, gen_uuid) << std::endl;
+    std::cout << "compact\t1\t" << measure(count, 1, [&] { return compact.next(); }) << std::endl;
+    std::cout << "uuid\t" << threads << "\t" << measure(count, threads, gen_uuid) << std::endl;
+    std::cout << "compact\t" << threads << "\t" << measure(count, threads, [&] { return compact.next(); }) << std::endl;
+    return 0;
+}
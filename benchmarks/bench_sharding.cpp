@@ -0,0 +1,171 @@
+/**
+ * @file bench_sharding.cpp
+ * @brief 分片服务器的扩展性基准测试
+ * 
+ * 在本机 peer 模式回环上测量 ShardedServer 的吞吐量（requests/sec）与分片数的关系。
+ * 每个分片打开自己的会话并监听独立的端口，客户端会话连接所有分片端口；
+ * 多个客户端线程以固定的在途深度调用一个做少量计算的方法。
+ * 分片数 1 相当于一个会话加一个工作线程。
+ * 
+ * 每一轮使用新的端口段，避免上一轮关闭的连接影响下一轮。
+ * 
+ * 用法：bench_sharding [最大分片数] [每个客户端线程的调用次数] [每次调用的计算量]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_common.hpp"
+#include "zenoh_rpc/zenoh_rpc.hpp"
+
+using namespace zenoh_rpc;
+
+namespace {
+
+const std::string kKeyExpr = "bench/sharding";
+
+/// 第一轮的起始端口
+constexpr int kBasePort = 7480;
+
+/// 每个客户端线程的在途深度
+constexpr size_t kDepth = 16;
+
+/// 客户端线程数
+constexpr size_t kClientThreads = 4;
+
+/**
+ * @brief 分片 i 在第 round 轮的端点
+ */
+std::string endpoint(size_t round, size_t shard) {
+    return "tcp/127.0.0.1:" + std::to_string(kBasePort + round * 32 + shard);
+}
+
+/**
+ * @brief 连接所有分片端点的客户端配置
+ */
+zenoh::Config connect_all(size_t round, size_t shards) {
+    std::string endpoints = "[";
+    for (size_t i = 0; i < shards; ++i) {
+        endpoints += (i > 0 ? ",\"" : "\"") + endpoint(round, i) + "\"";
+    }
+    endpoints += "]";
+    zenoh::Config config = zenoh::Config::create_default();
+    config.insert_json5("mode", "\"peer\"");
+    config.insert_json5("connect/endpoints", endpoints);
+    config.insert_json5("scouting/multicast/enabled", "false");
+    return config;
+}
+
+/**
+ * @brief 以固定在途深度发起 total 次调用
+ * @param client RPC 客户端
+ * @param total 调用总数
+ * @param work 每次调用的计算量
+ * @param failures 失败计数
+ */
+void drive(Client& client, size_t total, int64_t work, std::atomic<size_t>& failures) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t in_flight = 0;
+    
+    for (size_t sent = 0; sent < total; ++sent) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return in_flight < kDepth; });
+            ++in_flight;
+        }
+        client.try_call_async("work", json::array({work}), [&](RpcResult result) {
+            if (!result) {
+                failures++;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            --in_flight;
+            cv.notify_one();
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return in_flight == 0; });
+}
+
+/**
+ * @brief 测量一种分片数
+ * @return 每秒完成的调用数
+ */
+double run(DispatcherBase& dispatcher, size_t round, size_t shards, size_t count, int64_t work) {
+    ShardedServerOptions options;
+    options.shards = shards;
+    ShardedServer server(kKeyExpr, dispatcher, [&](size_t shard) {
+        return bench::listen_config(endpoint(round, shard));
+    }, options);
+    server.start();
+    
+    Session session(connect_all(round, shards));
+    bench::wait_for_discovery();
+    
+    std::vector<std::unique_ptr<Client>> clients;
+    for (size_t i = 0; i < kClientThreads; ++i) {
+        clients.push_back(std::make_unique<Client>(kKeyExpr, session));
+        clients.back()->call("work", json::array({0}));  // 得知分片数
+    }
+    
+    std::atomic<size_t> failures{0};
+    bench::Stopwatch watch;
+    std::vector<std::thread> threads;
+    for (auto& client : clients) {
+        threads.emplace_back([&, c = client.get()] { drive(*c, count, work, failures); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double elapsed = watch.seconds();
+    
+    if (failures > 0) {
+        std::cerr << "  shards " << shards << ": " << failures << " calls failed" << std::endl;
+    }
+    clients.clear();
+    server.stop();
+    return static_cast<double>(count * kClientThreads) / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t max_shards = static_cast<size_t>(
+        bench::arg_or(argc, argv, 1, std::min<unsigned>(16, std::max(1u, std::thread::hardware_concurrency()))));
+    const size_t count = static_cast<size_t>(bench::arg_or(argc, argv, 2, 5000));
+    const int64_t work = bench::arg_or(argc, argv, 3, 20000);
+    
+    DispatcherBase dispatcher;
+    dispatcher.register_method<int64_t(int64_t)>("work", [](int64_t n) {
+        // 模拟处理器的计算量
+        uint64_t x = 88172645463325252ull;
+        for (int64_t i = 0; i < n; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        return static_cast<int64_t>(x & 0xffff);
+    });
+    
+    std::cout << "client threads: " << kClientThreads << ", depth: " << kDepth << ", calls per thread: " << count
+              << ", work: " << work << std::endl;
+    std::cout << "shards\treq/s\tspeedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    double baseline = 0;
+    size_t round = 0;
+    for (size_t shards = 1; shards <= max_shards; shards *= 2, ++round) {
+        double rate = run(dispatcher, round, shards, count, work);
+        if (baseline == 0) {
+            baseline = rate;
+        }
+        std::cout << shards << "\t" << rate << "\t" << rate / baseline << std::endl;
+    }
+    return 0;
+}
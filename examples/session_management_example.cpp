@@ -29,11 +29,9 @@ class ExampleDispatcher : public DispatcherBase {
 public:
     ExampleDispatcher() {
         // 注册示例方法
-        register_method("add", [](const json& params) -> json {
-            if (!params.is_array() || params.size() != 2) {
-                throw InvalidParamsError("add method requires exactly 2 parameters");
-            }
-            return params[0].get<double>() + params[1].get<double>();
+        // 类型化注册：参数个数和类型由签名检查，不符时回复 -32602
+        register_method<double(double, double)>("add", [](double a, double b) {
+            return a + b;
         });
         
         register_method("echo", [](const json& params) -> json {
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "jsonrpc_proto.hpp"
+#include "message_parts.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file binary_envelope.hpp
+ * @brief 紧凑的二进制 RPC 信封（EncodingType::BINARY）
+ * 
+ * JSON 和 MessagePack 信封每条消息都重复 "jsonrpc":"2.0"、"method"、"params"、"id"
+ * 这些键，高频的小调用中信封往往比参数还大。二进制信封把这些字段放进固定的头部，
+ * 参数、结果和错误信息仍然以 MessagePack 编码：
+ * 
+ * @code
+ * 单个消息：
+ *   u8   magic = 0xc1          （MessagePack 中从不使用的字节，可与 JSON/MessagePack 区分）
+ *   u8   version = 1
+ *   u8   flags                 （低两位为消息类型，见 binary_format::Kind）
+ *   id   u64（小端）；带 TEXT_ID 标志时为 u16 长度 + 字节（通知没有 id）
+ *   方法 u16 长度 + 方法名；带 METHOD_ID 标志时为 u32 方法ID（只有请求和通知）
+ *   i32  错误代码（只有错误响应）
+ *   body MessagePack：请求为参数（可以为空，表示没有参数），成功响应为结果，
+ *        错误响应为 {"message": ..., "data": ...}
+ * 
+ * 批量消息：
+ *   u8 magic, u8 version, u8 flags = BATCH, u32 条目数，
+ *   每个条目为 u32 长度 + 单个消息
+ * @endcode
+ * 
+ * 所有多字节整数都是小端。由十进制数字组成、可以放进 u64 的字符串 id
+ * （没有前导零）以 8 字节整数传输，解码后还原为同样的字符串；
+ * 其他 id 以 TEXT_ID 形式传输。使用二进制编码的客户端默认生成数字 id（IdMode::NUMERIC）。
+ * 
+ * 编码和解码都以 JSON-RPC 消息对象为接口，客户端和服务器的其余代码不区分编码；
+ * 扫描见 envelope.hpp 中的 scan_message()。
+ */
+
+namespace binary_format {
+
+constexpr uint8_t kMagic = 0xc1;     ///< 首字节
+constexpr uint8_t kVersion = 1;      ///< 格式版本
+
+/**
+ * @enum Kind
+ * @brief 消息类型（flags 的低两位）
+ */
+enum Kind : uint8_t {
+    REQUEST = 0,        ///< 请求
+    NOTIFICATION = 1,   ///< 通知
+    RESPONSE_OK = 2,    ///< 成功响应
+    RESPONSE_ERR = 3    ///< 错误响应
+};
+
+constexpr uint8_t kKindMask = 0x03;   ///< 消息类型掩码
+constexpr uint8_t kMethodId = 0x04;   ///< 方法以 u32 方法ID 表示
+constexpr uint8_t kTextId = 0x08;     ///< id 以长度加字节表示
+constexpr uint8_t kBatch = 0x80;      ///< 批量消息
+
+} // namespace binary_format
+
+/**
+ * @brief 把 JSON-RPC 消息编码为二进制信封
+ * @param message 请求、通知、响应或它们组成的批量数组
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ * @throws std::invalid_argument 当消息无法用二进制信封表示时
+ *         （不是对象、id 不是字符串、错误代码不是整数等）
+ */
+void encode_binary_into(const json& message, std::string& out);
+
+/**
+ * @brief 把消息的组成部分编码为二进制信封
+ * @param parts 消息的组成部分
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ * @throws std::invalid_argument 当方法名或 id 超过 65535 字节时
+ * 
+ * 与编码 parts.to_json() 的结果逐字节相同，但不构造消息对象。
+ */
+void encode_binary_into(const MessageParts& parts, std::string& out);
+
+/**
+ * @brief 把 JSON-RPC 消息编码为二进制信封
+ * @param message 要编码的消息
+ * @return 编码后的字节
+ * @throws std::invalid_argument 当消息无法用二进制信封表示时
+ */
+std::string encode_binary(const json& message);
+
+/**
+ * @brief 把二进制信封解码为 JSON-RPC 消息
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @return 与编码前等价的 JSON-RPC 消息（带 "jsonrpc": "2.0"）
+ * @throws ParseError 当载荷格式错误时
+ * 
+ * 以方法ID表示的方法解码为数字 "method"。
+ */
+json decode_binary(const char* data, std::size_t size);
+
+} // namespace zenoh_rpc
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "jsonrpc_proto.hpp"
+#include "message_parts.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file codec.hpp
+ * @brief 可扩展的编解码器注册表
+ * 
+ * 每种编码由一个 Codec 对象描述：编码类型、名称（客户端构造时使用）、
+ * MIME 类型（标记 Zenoh 载荷的 Encoding）以及编码和解码函数。
+ * 注册表内置以下编解码器：
+ * - "json"：JSON
+ * - "msgpack"：MessagePack
+ * - "binary"：二进制信封（见 binary_envelope.hpp）
+ * - "cbor"：CBOR（RFC 8949）
+ * - "ubjson"：Universal Binary JSON
+ * - "bson"：BSON（顶层必须是文档，批量数组包装为 {"batch": [...]}）
+ * 
+ * JSON、MessagePack 和二进制信封有专门的信封扫描器，并直接从 MessageParts 编码
+ * （见 message_parts.hpp）；其他编解码器的载荷先完整解码，再转为 MessagePack 扫描
+ * （见 envelope.hpp）。CBOR、UBJSON 和 BSON 的首字节与 JSON 或 MessagePack 重叠，
+ * 只能通过 MIME 类型识别，不参与 sniff_encoding()。
+ * 
+ * 自定义编解码器使用 kFirstCustomEncoding 及以上的编码类型，注册后即可在
+ * Client 构造函数中按名称使用，服务器按请求的 MIME 类型以同样的编码回复
+ * （Zenoh 未预定义的 MIME 类型以 "zenoh/bytes;<mime>" 的形式到达，见 mime_base()）：
+ * @code
+ * class MyCodec : public Codec {
+ * public:
+ *     MyCodec() : Codec(EncodingType{kFirstCustomEncoding}, "my", "application/x-my") {}
+ *     void encode_into(const json& message, std::string& out) const override { ... }
+ *     json decode(const char* data, std::size_t size) const override { ... }
+ * };
+ * CodecRegistry::instance().add(std::make_shared<MyCodec>());
+ * Client client("service", session, "my");
+ * @endcode
+ */
+
+/// 自定义编解码器可以使用的第一个编码类型值
+constexpr uint8_t kFirstCustomEncoding = 64;
+
+/**
+ * @class Codec
+ * @brief 一种消息编码
+ * 
+ * 编解码器注册后一直存活到程序结束，实现必须是线程安全的（通常是无状态的）。
+ */
+class Codec {
+public:
+    /**
+     * @brief 构造函数
+     * @param type 编码类型
+     * @param name 编码名称（如 "cbor"）
+     * @param mime MIME 类型（如 "application/cbor"）
+     */
+    Codec(EncodingType type, std::string name, std::string mime)
+        : type_(type), name_(std::move(name)), mime_(std::move(mime)) {}
+    
+    virtual ~Codec() = default;
+    
+    Codec(const Codec&) = delete;
+    Codec& operator=(const Codec&) = delete;
+    
+    /**
+     * @brief 编码类型
+     */
+    EncodingType type() const { return type_; }
+    
+    /**
+     * @brief 编码名称
+     */
+    const std::string& name() const { return name_; }
+    
+    /**
+     * @brief MIME 类型
+     */
+    const std::string& mime() const { return mime_; }
+    
+    /**
+     * @brief 编码到调用方提供的缓冲区
+     * @param message 要编码的消息
+     * @param out 输出缓冲区（先清空，保留已有容量）
+     * @throws std::invalid_argument 当消息无法以这种编码表示时
+     */
+    virtual void encode_into(const json& message, std::string& out) const = 0;
+    
+    /**
+     * @brief 把消息的组成部分编码到调用方提供的缓冲区
+     * @param parts 消息的组成部分
+     * @param out 输出缓冲区（先清空，保留已有容量）
+     * @throws std::invalid_argument 当消息无法以这种编码表示时
+     * 
+     * 默认以 parts.to_json() 构造消息对象后调用 encode_into()；
+     * 能够直接写入的编码覆盖此函数，省去消息对象的分配和复制。
+     */
+    virtual void encode_message_into(const MessageParts& parts, std::string& out) const {
+        encode_into(parts.to_json(), out);
+    }
+    
+    /**
+     * @brief 解码连续字节视图
+     * @param data 载荷起始地址
+     * @param size 载荷字节数
+     * @return 解码后的消息
+     * @throws ParseError 当解码失败时
+     */
+    virtual json decode(const char* data, std::size_t size) const = 0;
+    
+    /**
+     * @brief 编码为新的字符串
+     * @param message 要编码的消息
+     * @return 编码后的字节
+     */
+    std::string encode(const json& message) const {
+        std::string out;
+        encode_into(message, out);
+        return out;
+    }
+
+private:
+    EncodingType type_;
+    std::string name_;
+    std::string mime_;
+};
+
+/**
+ * @class CodecRegistry
+ * @brief 按编码类型、名称和 MIME 类型查找编解码器
+ * 
+ * 按编码类型查找不加锁（每个类型一个原子指针），用于每条消息的编码和解码；
+ * 按名称和 MIME 类型查找加锁，客户端只在构造时按名称查找一次。
+ */
+class CodecRegistry {
+public:
+    /**
+     * @brief 全局注册表（首次使用时注册内置编解码器）
+     */
+    static CodecRegistry& instance();
+    
+    /**
+     * @brief 注册编解码器
+     * @param codec 编解码器
+     * @throws std::invalid_argument 当 codec 为空，或名称、MIME 类型已被其他编码类型使用时
+     * 
+     * 同一编码类型再次注册时替换原有的编解码器；被替换的对象仍然保留，
+     * 正在使用它的线程不受影响。
+     */
+    void add(std::shared_ptr<const Codec> codec);
+    
+    /**
+     * @brief 按编码类型查找
+     * @param type 编码类型
+     * @return 编解码器；没有注册时为 nullptr
+     */
+    const Codec* find(EncodingType type) const {
+        return by_type_[static_cast<uint8_t>(type)].load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief 按名称查找
+     * @param name 编码名称
+     * @return 编解码器；没有注册时为 nullptr
+     */
+    const Codec* find(const std::string& name) const;
+    
+    /**
+     * @brief 按 MIME 类型查找
+     * @param mime MIME 类型（忽略 ";" 之后的部分）
+     * @return 编解码器；没有注册时为 nullptr
+     */
+    const Codec* find_mime(const std::string& mime) const;
+    
+    /**
+     * @brief 已注册的编码名称（按注册顺序）
+     */
+    std::vector<std::string> names() const;
+
+private:
+    CodecRegistry();
+    
+    /**
+     * @brief 当前使用的编解码器（持有 mutex_ 时调用）
+     */
+    std::vector<const Codec*> active_locked() const;
+    
+    mutable std::mutex mutex_;                              ///< 保护 codecs_
+    std::vector<std::shared_ptr<const Codec>> codecs_;      ///< 注册过的全部编解码器（只增不减）
+    std::array<std::atomic<const Codec*>, 256> by_type_{};  ///< 编码类型到当前编解码器的映射
+};
+
+/**
+ * @brief 按编码类型获取编解码器
+ * @param type 编码类型
+ * @return 编解码器
+ * @throws std::invalid_argument 当编码类型没有注册时
+ */
+const Codec& codec_for(EncodingType type);
+
+} // namespace zenoh_rpc
@@ -0,0 +1,505 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "zenoh_rpc/coro.hpp requires a C++20 compiler with coroutine support (-std=c++20)"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jsonrpc_client.hpp"
+#include "jsonrpc_server.hpp"
+
+namespace zenoh_rpc {
+namespace coro {
+
+/**
+ * @file coro.hpp
+ * @brief C++20 协程客户端和服务器接口（可选）
+ * 
+ * 本文件在 C++17 核心库之上提供协程层，包括：
+ * - 惰性启动的协程任务 Task<T>
+ * - 恢复协程的小型调度器 Scheduler
+ * - 挂起而不阻塞线程的远程调用 co_await coro::call(...)
+ * - 以协程实现的服务器方法 coro::register_method(...)
+ * 
+ * Zenoh 回复回调只把等待中的协程交给调度器，协程在调度器线程中恢复，
+ * 因此一串服务间调用（A 调用 B，B 再调用 C）不会在每一跳占用一个等待线程。
+ * 
+ * 库本身按 C++17 编译，本文件全部为内联实现，只有以 C++20 编译的
+ * 目标才需要包含它（不由 zenoh_rpc.hpp 自动包含）。
+ * 
+ * 使用示例：
+ * @code
+ * coro::Scheduler scheduler;
+ * coro::register_method(dispatcher, "total", scheduler, [&](json params) -> coro::Task<json> {
+ *     json price = co_await coro::call(inventory, scheduler, "price", params);
+ *     json tax = co_await coro::call(billing, scheduler, "tax", price);
+ *     co_return price.get<double>() + tax.get<double>();
+ * });
+ * @endcode
+ */
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @struct PromiseBase
+ * @brief Task 承诺对象的公共部分
+ * 
+ * 任务惰性启动；结束时通过对称转移恢复等待它的协程，不增加调用栈深度。
+ */
+struct PromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();  ///< 等待此任务的协程
+    std::exception_ptr error;                                      ///< 任务抛出的异常
+    
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+        
+        void await_resume() const noexcept {}
+    };
+    
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;  ///< 任务结果
+    
+    Task<T> get_return_object() noexcept;
+    
+    template<typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+    
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    
+    void return_void() const noexcept {}
+    
+    void result() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/**
+ * @struct Detached
+ * @brief 立即启动、结束时自行销毁的协程
+ * 
+ * 用于从普通函数启动 Task；异常由协程体自行处理。
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @class Task
+ * @brief 惰性启动的协程任务
+ * @tparam T 结果类型（默认为 void）
+ * 
+ * 任务创建时不执行，被 co_await 时才开始运行，结果或异常返回给等待者。
+ * 任务只能移动，只能被等待一次；从普通函数启动任务使用
+ * Scheduler::spawn() 或 sync_wait()。
+ */
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+    
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+    
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+    
+    bool await_ready() const noexcept { return false; }
+    
+    /// 记录等待者并直接转入任务执行
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    
+    /// 返回任务结果，任务抛出的异常在等待者中重新抛出
+    T await_resume() {
+        return handle_.promise().result();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> Promise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * @class Scheduler
+ * @brief 恢复协程的调度器
+ * 
+ * 持有固定数量的线程，按提交顺序恢复协程。Zenoh 回复回调和
+ * 其他完成通知只调用 post()，不在回调线程中执行协程体。
+ * 
+ * 析构时执行完队列中剩余的协程后再结束线程；
+ * 析构之后提交的协程在提交线程中直接恢复。
+ */
+class Scheduler {
+public:
+    /**
+     * @brief 构造函数
+     * @param num_threads 调度线程数（至少为1）
+     */
+    explicit Scheduler(size_t num_threads = 1) {
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+        threads_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+    
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+    
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        ready_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+    
+    /**
+     * @brief 提交要恢复的协程
+     * @param handle 已挂起的协程
+     */
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!stopped_) {
+                queue_.push_back(handle);
+                ready_.notify_one();
+                return;
+            }
+        }
+        handle.resume();
+    }
+    
+    /**
+     * @brief 切换到调度器线程
+     * @return 可等待对象：co_await scheduler.schedule() 之后的代码在调度器线程中执行
+     */
+    auto schedule() {
+        struct ScheduleAwaiter {
+            Scheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.post(handle); }
+            void await_resume() const noexcept {}
+        };
+        return ScheduleAwaiter{*this};
+    }
+    
+    /**
+     * @brief 在调度器线程中启动任务，不等待结果
+     * @param task 要执行的任务
+     * 
+     * 任务抛出的异常记录到标准错误输出。
+     */
+    template<typename T>
+    void spawn(Task<T> task);
+    
+    /// 等待恢复的协程数量
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+    
+    /// 调度线程数
+    size_t num_threads() const { return threads_.size(); }
+
+private:
+    void run() {
+        while (true) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                handle = queue_.front();
+                queue_.pop_front();
+            }
+            handle.resume();
+        }
+    }
+    
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stopped_ = false;
+    std::vector<std::thread> threads_;
+};
+
+namespace detail {
+
+/**
+ * @brief 启动任务并在结束时调用完成回调
+ * @param scheduler 先切换到的调度器（为空时在当前线程开始执行）
+ * @param task 要执行的任务
+ * @param done 完成回调：void 任务为 done(error)，其他为 done(error, optional<T>)
+ */
+template<typename T, typename Done>
+Detached start(Scheduler* scheduler, Task<T> task, Done done) {
+    if (scheduler) {
+        co_await scheduler->schedule();
+    }
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<T>) {
+        try {
+            co_await std::move(task);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        done(error);
+    } else {
+        std::optional<T> value;
+        try {
+            value.emplace(co_await std::move(task));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        done(error, std::move(value));
+    }
+}
+
+/// 记录分离任务的异常
+inline void report_spawn_error(std::exception_ptr error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << "Spawned task failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Spawned task failed" << std::endl;
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+void Scheduler::spawn(Task<T> task) {
+    if constexpr (std::is_void_v<T>) {
+        detail::start(this, std::move(task), [](std::exception_ptr error) {
+            if (error) {
+                detail::report_spawn_error(error);
+            }
+        });
+    } else {
+        detail::start(this, std::move(task), [](std::exception_ptr error, std::optional<T>) {
+            if (error) {
+                detail::report_spawn_error(error);
+            }
+        });
+    }
+}
+
+/**
+ * @brief 阻塞当前线程直到任务完成
+ * @param task 要执行的任务
+ * @return 任务结果
+ * @throws 任务抛出的异常
+ * 
+ * 任务在当前线程中开始执行，第一次挂起后由恢复它的线程继续执行。
+ * 用于 main() 等非协程代码的入口，不能在调度器线程中调用。
+ */
+template<typename T>
+T sync_wait(Task<T> task) {
+    // promise 由完成回调共同持有：set_value 返回前调用线程可能已经离开本函数
+    auto promise = std::make_shared<std::promise<T>>();
+    std::future<T> future = promise->get_future();
+    if constexpr (std::is_void_v<T>) {
+        detail::start(nullptr, std::move(task), [promise](std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value();
+            }
+        });
+    } else {
+        detail::start(nullptr, std::move(task), [promise](std::exception_ptr error, std::optional<T> value) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::move(*value));
+            }
+        });
+    }
+    return future.get();
+}
+
+/**
+ * @class CallAwaitable
+ * @brief 远程调用的可等待对象
+ * 
+ * 挂起时通过 Client::call_async 的回调形式发送请求，
+ * 回复、错误或超时到达后由调度器恢复等待的协程。
+ * 等待期间不占用任何线程。
+ */
+class [[nodiscard]] CallAwaitable {
+public:
+    CallAwaitable(Client& client, Scheduler& scheduler, std::string method, json params,
+                  std::optional<std::chrono::milliseconds> timeout)
+        : client_(client), scheduler_(scheduler), method_(std::move(method)),
+          params_(std::move(params)), timeout_(timeout) {}
+    
+    bool await_ready() const noexcept { return false; }
+    
+    void await_suspend(std::coroutine_handle<> handle) {
+        // 回调可能在 call_async 返回前执行并恢复协程，此后不能再访问成员
+        client_.call_async(method_, std::move(params_), [this, handle](std::exception_ptr error, json result) {
+            error_ = error;
+            result_ = std::move(result);
+            scheduler_.post(handle);
+        }, timeout_);
+    }
+    
+    json await_resume() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return std::move(result_);
+    }
+
+private:
+    Client& client_;
+    Scheduler& scheduler_;
+    std::string method_;
+    json params_;
+    std::optional<std::chrono::milliseconds> timeout_;
+    std::exception_ptr error_;
+    json result_;
+};
+
+/**
+ * @brief 以协程方式调用远程方法
+ * @param client 客户端
+ * @param scheduler 恢复协程的调度器
+ * @param method 要调用的方法名
+ * @param params 方法参数（默认为空对象）
+ * @param timeout 超时时间（可选，使用客户端的默认值）
+ * @return 可等待对象，co_await 得到方法结果
+ * @throws TimeoutError 当请求超时时（在 co_await 处抛出）
+ * @throws RpcError 当远程方法执行出错时（在 co_await 处抛出）
+ * 
+ * 与 Client::call 相同，但挂起当前协程而不是阻塞线程。
+ */
+inline CallAwaitable call(Client& client, Scheduler& scheduler, const std::string& method,
+                          json params = json::object(),
+                          std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+    return CallAwaitable(client, scheduler, method, std::move(params), timeout);
+}
+
+/// 协程方法处理函数：参数按值传入，保存在协程帧中
+using CoroutineHandler = std::function<Task<json>(json params)>;
+
+/**
+ * @brief 注册以协程实现的服务器方法
+ * @param dispatcher 方法分发器
+ * @param method_name 方法名称
+ * @param scheduler 执行协程的调度器
+ * @param handler 协程处理函数
+ * 
+ * 基于 DispatcherBase::register_async_method：方法被调用时创建协程并交给调度器，
+ * 协程 co_return 的结果或抛出的异常通过回复句柄回复。
+ * Zenoh 回调线程（或服务器执行器线程）在协程创建后立即返回，
+ * 协程在 co_await 下游调用期间不占用线程。
+ * 
+ * 处理函数必须按值接收参数：按引用接收的参数在协程第一次挂起前就已失效。
+ */
+inline void register_method(DispatcherBase& dispatcher, const std::string& method_name,
+                            Scheduler& scheduler, CoroutineHandler handler) {
+    dispatcher.register_async_method(method_name,
+        [&scheduler, handler = std::move(handler)](const json& params, ReplyHandle reply) {
+            detail::start(&scheduler, handler(params), [reply](std::exception_ptr error, std::optional<json> result) {
+                if (error) {
+                    reply.reject(error);
+                } else {
+                    reply.resolve(std::move(*result));
+                }
+            });
+        });
+}
+
+} // namespace coro
+} // namespace zenoh_rpc
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "jsonrpc_proto.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file envelope.hpp
+ * @brief JSON-RPC 信封的单遍扫描
+ * 
+ * 扫描器在编码后的载荷（JSON、MessagePack 或二进制信封）上走一遍，只提取信封字段：
+ * - "jsonrpc"、"method"、"id" 解码为字符串
+ * - "params"、"result"、"error" 只记录在载荷中的原始字节范围和值的类型
+ * 
+ * 扫描时检查整个载荷的语法，但不构造 JSON 树、不为参数和结果分配内存。
+ * 参数和结果在需要时再从原始字节解析（parse_params() 等），
+ * 方法不存在或参数超过大小限制的请求可以在解析参数之前拒绝。
+ * 
+ * 二进制信封（见 binary_envelope.hpp）的信封字段本来就在固定头部中，
+ * 参数、结果和错误信息的原始字节为 MessagePack。
+ * 
+ * 其他注册的编码（CBOR、UBJSON、BSON 和自定义编解码器，见 codec.hpp）没有专门的扫描器：
+ * 载荷由编解码器完整解码后转为 MessagePack 再扫描，原始字节引用 Envelope::storage。
+ * 
+ * 原始字节范围引用扫描时的载荷，载荷必须比 Envelope 活得更久。
+ */
+
+/**
+ * @enum ValueKind
+ * @brief 信封字段值的类型
+ */
+enum class ValueKind : uint8_t {
+    ABSENT,     ///< 字段不存在
+    NULL_VALUE, ///< null
+    BOOLEAN,    ///< true / false
+    NUMBER,     ///< 整数或浮点数
+    STRING,     ///< 字符串
+    ARRAY,      ///< 数组
+    OBJECT,     ///< 对象
+    BINARY      ///< MessagePack bin / ext
+};
+
+/**
+ * @struct Envelope
+ * @brief 扫描得到的单个 JSON-RPC 消息
+ * 
+ * 消息不是对象时 is_object 为 false，其余字段保持默认值。
+ * 同一个键出现多次时以最后一次为准（与 nlohmann::json 一致）。
+ */
+struct Envelope {
+    EncodingType encoding = EncodingType::JSON;   ///< 载荷编码
+    bool is_object = false;                       ///< 消息是否为对象
+    bool version_ok = false;                      ///< "jsonrpc" 是否为 "2.0"
+    
+    ValueKind method_kind = ValueKind::ABSENT;    ///< "method" 的类型
+    std::string method;                           ///< 方法名（method_kind 为 STRING 时有效）
+    uint32_t method_id = 0;                       ///< 方法ID（二进制信封以方法ID表示方法时 method_kind 为 NUMBER）
+    
+    ValueKind id_kind = ValueKind::ABSENT;        ///< "id" 的类型
+    std::string id;                               ///< 请求ID（id_kind 为 STRING 时有效）
+    
+    ValueKind params_kind = ValueKind::ABSENT;    ///< "params" 的类型
+    std::string_view params;                      ///< "params" 的原始字节
+    
+    ValueKind result_kind = ValueKind::ABSENT;    ///< "result" 的类型
+    std::string_view result;                      ///< "result" 的原始字节
+    
+    ValueKind error_kind = ValueKind::ABSENT;     ///< "error" 的类型
+    std::string_view error;                       ///< "error" 的原始字节
+    int32_t error_code = 0;                       ///< 二进制信封头部中的错误代码（parse_error() 会放回错误对象）
+    
+    std::shared_ptr<const std::string> storage;   ///< 转码后的 MessagePack 载荷（只有没有专门扫描器的编码使用）
+    
+    /**
+     * @brief 是否指定了方法（方法名，或二进制信封中的方法ID）
+     */
+    bool has_method_target() const;
+    
+    /**
+     * @brief 是否为有效的 JSON-RPC 请求（与 validate_request 的规则相同，二进制信封还接受方法ID）
+     */
+    bool is_valid_request() const;
+    
+    /**
+     * @brief 是否为有效的 JSON-RPC 通知（与 validate_notification 的规则相同）
+     */
+    bool is_valid_notification() const;
+    
+    /**
+     * @brief 解析参数
+     * @return 参数；没有 "params" 字段时为空对象
+     * @throws ParseError 当解码失败时
+     */
+    json parse_params() const;
+    
+    /**
+     * @brief 解析结果
+     * @return 结果；没有 "result" 字段时为 null
+     * @throws ParseError 当解码失败时
+     */
+    json parse_result() const;
+    
+    /**
+     * @brief 解析错误对象
+     * @return 错误对象；没有 "error" 字段时为 null
+     * @throws ParseError 当解码失败时
+     */
+    json parse_error() const;
+};
+
+/**
+ * @struct ScannedMessage
+ * @brief 扫描得到的单个消息或批量消息
+ */
+struct ScannedMessage {
+    bool is_batch = false;            ///< 载荷是否为数组（批量消息）
+    std::vector<Envelope> entries;    ///< 单个消息时只有一个条目；批量消息按数组顺序排列
+};
+
+/**
+ * @brief 扫描单个消息的信封
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 信封；载荷为数组时 is_object 为 false
+ * @throws ParseError 当载荷语法错误时
+ */
+Envelope scan_envelope(const char* data, std::size_t size, EncodingType type);
+
+/**
+ * @brief 扫描单个或批量消息
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 扫描结果；载荷为数组时每个元素一个条目
+ * @throws ParseError 当载荷语法错误时
+ */
+ScannedMessage scan_message(const char* data, std::size_t size, EncodingType type);
+
+} // namespace zenoh_rpc
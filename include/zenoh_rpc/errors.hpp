@@ -1,7 +1,11 @@
 #pragma once
 
+#include <exception>
+#include <functional>
 #include <stdexcept>
 #include <string>
+#include <optional>
+#include <utility>
 #include <nlohmann/json.hpp>
 
 namespace zenoh_rpc {
@@ -24,6 +28,10 @@ using json = nlohmann::json;
  * - ServerError: -32000 (服务器错误)
  * - ConnectionError: -32001 (连接错误)
  * - TimeoutError: -32002 (超时错误)
+ * - StaleMethodIdError: -32003 (方法ID已失效)
+ * 
+ * 热路径上的错误（参数校验失败、方法不存在等）也可以不经过异常：
+ * RpcResult 以 {code, message, data} 保存错误，需要异常时再转换。
  */
 
 /**
@@ -205,4 +213,206 @@ public:
         : RpcError(message, -32002, data) {}
 };
 
+/**
+ * @class StaleMethodIdError
+ * @brief 方法ID已失效异常
+ * 
+ * 当请求使用的方法ID不属于服务器当前的方法表时抛出此异常
+ * （方法表在客户端获取方法ID之后发生了变化）。
+ * 客户端收到后丢弃缓存的方法ID，按方法名重发请求。
+ * 错误代码：-32003
+ */
+class StaleMethodIdError : public RpcError {
+public:
+    /**
+     * @brief 构造函数
+     * @param message 错误消息（默认为标准消息）
+     * @param data 附加错误数据（默认为空对象）
+     */
+    explicit StaleMethodIdError(const std::string& message = "Stale method id", const json& data = json::object()) 
+        : RpcError(message, -32003, data) {}
+};
+
+/**
+ * @brief 根据错误代码创建对应的 RPC 异常对象，不抛出
+ * @param code 错误代码
+ * @param message 错误消息
+ * @param data 附加错误数据
+ * @return 保存与错误代码对应的 RpcError 子类的异常指针
+ * 
+ * 与 throw_rpc_error() 的映射相同，用于通过 std::exception_ptr 报告错误的接口
+ * （future、完成回调），不经过栈展开。未知的错误代码统一映射为 ServerError。
+ */
+inline std::exception_ptr make_rpc_error(int code, const std::string& message, const json& data = json::object()) {
+    switch (code) {
+        case -32700:  // 解析错误
+            return std::make_exception_ptr(ParseError(message, data));
+        case -32600:  // 无效请求
+            return std::make_exception_ptr(InvalidRequestError(message, data));
+        case -32601:  // 方法不存在
+            return std::make_exception_ptr(MethodNotFoundError(message, data));
+        case -32602:  // 参数无效
+            return std::make_exception_ptr(InvalidParamsError(message, data));
+        case -32603:  // 内部错误
+            return std::make_exception_ptr(InternalError(message, data));
+        case -32000:  // 服务器错误
+            return std::make_exception_ptr(ServerError(message, data));
+        case -32001:  // 连接错误
+            return std::make_exception_ptr(ConnectionError(message, data));
+        case -32002:  // 超时错误
+            return std::make_exception_ptr(TimeoutError(message, data));
+        case -32003:  // 方法ID已失效
+            return std::make_exception_ptr(StaleMethodIdError(message, data));
+        default:      // 其他错误
+            return std::make_exception_ptr(ServerError(message, data));
+    }
+}
+
+/**
+ * @brief 根据错误代码抛出对应的 RPC 异常
+ * @param code 错误代码
+ * @param message 错误消息
+ * @param data 附加错误数据
+ * @throws RpcError 与错误代码对应的异常子类（映射见 make_rpc_error()）
+ * 
+ * 将 JSON-RPC 错误响应中的 {code, message, data} 转换为异常。
+ */
+[[noreturn]] inline void throw_rpc_error(int code, const std::string& message, const json& data = json::object()) {
+    std::rethrow_exception(make_rpc_error(code, message, data));
+}
+
+/**
+ * @struct RpcErrorInfo
+ * @brief JSON-RPC 错误信息
+ * 
+ * 对应 JSON-RPC 错误响应中的 error 对象，不涉及异常。
+ */
+struct RpcErrorInfo {
+    int code = 0;                ///< 错误代码
+    std::string message;         ///< 错误消息
+    json data = json::object();  ///< 附加错误数据
+};
+
+/**
+ * @class RpcResult
+ * @brief 单次调用的结果：成功值或错误信息
+ * 
+ * 不抛出异常的调用和分发接口（Client::try_call()、DispatcherBase::try_dispatch()）
+ * 以及批量调用的逐条结果都使用此类型：错误只是 {code, message, data}，
+ * 不构造异常对象，也没有栈展开。
+ * value() 在错误状态下才抛出与错误代码对应的 RpcError 异常，
+ * 抛出异常的接口就是在此基础上的一层包装。
+ */
+class RpcResult {
+public:
+    /**
+     * @brief 创建成功结果
+     * @param value 方法执行结果
+     */
+    static RpcResult ok(json value) {
+        RpcResult result;
+        result.value_ = std::move(value);
+        return result;
+    }
+    
+    /**
+     * @brief 创建错误结果
+     * @param code 错误代码
+     * @param message 错误消息
+     * @param data 附加错误数据
+     */
+    static RpcResult err(int code, std::string message, json data = json::object()) {
+        RpcResult result;
+        result.error_ = RpcErrorInfo{code, std::move(message), std::move(data)};
+        return result;
+    }
+    
+    /**
+     * @brief 由已捕获的异常创建错误结果
+     * @param error 异常
+     * @return 错误结果：RpcError 保留错误代码和附加数据，其他异常转换为 -32603
+     * 
+     * 保留原始异常，value() 和 exception() 重新抛出或返回同一个异常对象。
+     */
+    static RpcResult from_exception(std::exception_ptr error) {
+        RpcResult result;
+        try {
+            std::rethrow_exception(error);
+        } catch (const RpcError& e) {
+            result.error_ = RpcErrorInfo{e.get_code(), e.what(), e.get_data()};
+        } catch (const std::exception& e) {
+            result.error_ = RpcErrorInfo{-32603, "Internal error: " + std::string(e.what())};
+        } catch (...) {
+            result.error_ = RpcErrorInfo{-32603, "Internal error"};
+        }
+        result.exception_ = std::move(error);
+        return result;
+    }
+    
+    /// 是否为成功结果
+    bool is_ok() const { return value_.has_value(); }
+    
+    /// 是否为成功结果
+    explicit operator bool() const { return is_ok(); }
+    
+    /**
+     * @brief 获取成功值
+     * @return 方法执行结果
+     * @throws RpcError 当结果为错误时，抛出与错误代码对应的异常（或创建结果时的原始异常）
+     */
+    const json& value() const& {
+        if (!value_) {
+            rethrow();
+        }
+        return *value_;
+    }
+    
+    /**
+     * @brief 移出成功值
+     * @return 方法执行结果（不复制）
+     * @throws RpcError 与 value() const& 相同
+     */
+    json value() && {
+        if (!value_) {
+            rethrow();
+        }
+        return std::move(*value_);
+    }
+    
+    /**
+     * @brief 获取错误信息
+     * @return 错误信息（成功结果时为默认值）
+     */
+    const RpcErrorInfo& error() const& { return error_; }
+    
+    /**
+     * @brief 移出错误信息
+     * @return 错误信息（消息和附加数据不复制）
+     */
+    RpcErrorInfo error() && { return std::move(error_); }
+    
+    /**
+     * @brief 以异常指针表示错误
+     * @return 成功结果时为空；否则为原始异常或与错误代码对应的 RpcError
+     */
+    std::exception_ptr exception() const {
+        if (value_) {
+            return nullptr;
+        }
+        return exception_ ? exception_ : make_rpc_error(error_.code, error_.message, error_.data);
+    }
+    
+private:
+    RpcResult() = default;
+    
+    [[noreturn]] void rethrow() const { std::rethrow_exception(exception()); }
+    
+    std::optional<json> value_;     ///< 成功值
+    RpcErrorInfo error_;            ///< 错误信息
+    std::exception_ptr exception_;  ///< 由异常创建时的原始异常
+};
+
+/// 调用或分发的完成回调：以成功值或错误信息调用恰好一次
+using ResultCallback = std::function<void(RpcResult result)>;
+
 } // namespace zenoh_rpc
\ No newline at end of file
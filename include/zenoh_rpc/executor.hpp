@@ -0,0 +1,258 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace zenoh_rpc {
+
+/**
+ * @file executor.hpp
+ * @brief 服务器工作线程池
+ * 
+ * 本文件定义了服务器使用的任务执行器，包括：
+ * - 有界多生产者多消费者（MPMC）队列
+ * - 固定数量的工作线程
+ * - 队列深度和排队等待时间指标
+ * 
+ * 服务器在 Zenoh 回调线程中只负责把查询放入队列，
+ * 解码、方法分发、编码和回复都在工作线程中完成，
+ * 因此一个耗时的处理器不会阻塞同一键表达式上的其他请求。
+ */
+
+/**
+ * @class BoundedQueue
+ * @brief 有界 MPMC 队列
+ * @tparam T 元素类型
+ * 
+ * 基于环形缓冲区的阻塞队列，容量固定。
+ * 多个生产者和消费者可以并发访问；关闭后不再接受新元素，
+ * 消费者在取完剩余元素后得到空值。
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 队列容量（至少为1）
+     */
+    explicit BoundedQueue(size_t capacity)
+        : buffer_(capacity > 0 ? capacity : 1) {}
+
+    /**
+     * @brief 尝试放入元素（不阻塞）
+     * @param item 要放入的元素
+     * @return 放入成功返回 true；队列已满或已关闭返回 false
+     */
+    bool try_push(T&& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || size_ == buffer_.size()) {
+            return false;
+        }
+        push_locked(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief 放入元素，队列已满时阻塞等待
+     * @param item 要放入的元素
+     * @return 放入成功返回 true；队列已关闭返回 false
+     */
+    bool push(T&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || size_ < buffer_.size(); });
+        if (closed_) {
+            return false;
+        }
+        push_locked(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief 取出元素，队列为空时阻塞等待
+     * @return 取出的元素；队列已关闭且为空时返回空值
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || size_ > 0; });
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+        T item = std::move(buffer_[head_]);
+        head_ = (head_ + 1) % buffer_.size();
+        --size_;
+        not_full_.notify_one();
+        return item;
+    }
+
+    /**
+     * @brief 关闭队列
+     * 
+     * 唤醒所有等待的生产者和消费者。已在队列中的元素仍可被取出。
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    /// 当前队列中的元素数量
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    /// 队列容量
+    size_t capacity() const { return buffer_.size(); }
+
+private:
+    void push_locked(T&& item) {
+        buffer_[(head_ + size_) % buffer_.size()] = std::move(item);
+        ++size_;
+        not_empty_.notify_one();
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    bool closed_ = false;
+};
+
+/**
+ * @enum OverflowPolicy
+ * @brief 队列满时的处理策略
+ */
+enum class OverflowPolicy {
+    REJECT,  ///< 立即拒绝（服务器返回 "Server busy" 错误）
+    BLOCK    ///< 阻塞提交线程直到队列有空位
+};
+
+/**
+ * @struct ExecutorOptions
+ * @brief 执行器配置
+ */
+struct ExecutorOptions {
+    size_t num_threads = std::thread::hardware_concurrency();  ///< 工作线程数量（0 时使用 1）
+    size_t queue_capacity = 1024;                              ///< 队列容量
+    OverflowPolicy overflow = OverflowPolicy::REJECT;          ///< 队列满时的处理策略
+};
+
+/**
+ * @struct ExecutorMetrics
+ * @brief 执行器指标快照
+ * 
+ * 等待时间指从任务入队到工作线程开始执行的时间。
+ */
+struct ExecutorMetrics {
+    size_t queue_depth = 0;             ///< 当前队列深度
+    size_t max_queue_depth = 0;         ///< 观测到的最大队列深度
+    uint64_t submitted = 0;             ///< 成功提交的任务数
+    uint64_t completed = 0;             ///< 已执行完成的任务数
+    uint64_t rejected = 0;              ///< 被拒绝的任务数
+    std::chrono::nanoseconds total_wait{0}; ///< 累计排队等待时间
+    std::chrono::nanoseconds max_wait{0};   ///< 最大排队等待时间
+
+    /// 平均排队等待时间
+    std::chrono::nanoseconds average_wait() const {
+        return completed > 0 ? total_wait / static_cast<int64_t>(completed) : std::chrono::nanoseconds(0);
+    }
+};
+
+/**
+ * @class Executor
+ * @brief 固定大小的工作线程池
+ * 
+ * 任务通过有界队列交给工作线程执行。执行器不可复制，
+ * 析构时会执行完队列中剩余的任务后再回收线程。
+ */
+class Executor {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief 构造函数
+     * @param options 执行器配置
+     * 
+     * 创建队列并启动工作线程。
+     */
+    explicit Executor(const ExecutorOptions& options = ExecutorOptions());
+
+    /**
+     * @brief 析构函数
+     * 
+     * 等同于调用 shutdown()。
+     */
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief 提交任务
+     * @param task 要执行的任务
+     * @return 任务被接受返回 true；队列已满（REJECT 策略）或已关闭返回 false
+     */
+    bool submit(Task task);
+
+    /**
+     * @brief 尝试提交任务（不阻塞）
+     * @param task 要执行的任务
+     * @return 任务被接受返回 true；队列已满或已关闭返回 false
+     * 
+     * 无论溢出策略如何都不阻塞，被拒绝的任务不计入 rejected。
+     * 用于工作线程把可选的工作交给其他线程（例如批量请求的并行块），
+     * 调用者在提交失败时自己执行。
+     */
+    bool try_submit(Task task);
+
+    /**
+     * @brief 关闭执行器
+     * 
+     * 停止接受新任务，执行完队列中剩余的任务后等待所有工作线程退出。
+     * 可以重复调用。
+     */
+    void shutdown();
+
+    /// 工作线程数量
+    size_t num_threads() const { return workers_.size(); }
+
+    /**
+     * @brief 获取指标快照
+     * @return 当前的执行器指标
+     */
+    ExecutorMetrics metrics() const;
+
+private:
+    /// 队列中的任务及其入队时间
+    struct Item {
+        Task task;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    /// 工作线程主循环
+    void worker_loop();
+
+    OverflowPolicy overflow_;
+    BoundedQueue<Item> queue_;
+    std::vector<std::thread> workers_;
+    std::mutex shutdown_mutex_;
+
+    std::atomic<size_t> max_queue_depth_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<int64_t> total_wait_ns_{0};
+    std::atomic<int64_t> max_wait_ns_{0};
+};
+
+} // namespace zenoh_rpc
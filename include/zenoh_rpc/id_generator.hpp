@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace zenoh_rpc {
+
+/**
+ * @file id_generator.hpp
+ * @brief 请求 ID 生成
+ * 
+ * 本文件定义了 JSON-RPC 请求 ID 的生成功能：
+ * - 线程局部的快速伪随机数生成器（xoshiro256**）
+ * - 直接写入固定缓冲区的 UUID v4 格式化
+ * - 紧凑模式：每个生成器的 64 位单调计数器加随机前缀
+ * 
+ * 所有函数都是线程安全的，不同线程之间不共享随机数状态。
+ */
+
+/**
+ * @brief 获取当前线程的 64 位随机数
+ * @return 随机数
+ * 
+ * 每个线程首次调用时用 std::random_device 为自己的生成器播种。
+ */
+uint64_t thread_random_u64();
+
+/**
+ * @brief 将 UUID v4 写入固定缓冲区
+ * @param out 至少 36 字节的输出缓冲区（不写入结尾的 '\0'）
+ * 
+ * 格式：xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx，y 为 8、9、a 或 b。
+ * 只使用两次 64 位随机数，不做任何内存分配。
+ */
+void format_uuid(char* out);
+
+/// UUID 字符串长度
+constexpr size_t kUuidLength = 36;
+
+/**
+ * @enum IdMode
+ * @brief 请求 ID 的生成模式
+ */
+enum class IdMode {
+    UUID,    ///< 随机 UUID v4（36 个字符，与 Python 版本兼容）
+    COMPACT, ///< 前缀加单调计数器，例如 "3f9a1c2e.1a"（短字符串，通常无需分配内存）
+    NUMERIC  ///< 十进制单调计数器，例如 "26"（二进制信封以 8 字节整数传输）
+};
+
+/**
+ * @class IdGenerator
+ * @brief 请求 ID 生成器
+ * 
+ * 每个客户端持有一个生成器。UUID 模式下每次生成随机 UUID；
+ * 紧凑模式下生成 "<前缀>.<十六进制计数器>"，前缀在生成器创建时随机选取，
+ * 用于区分不同的客户端实例；数字模式只生成计数器的十进制形式。
+ * 生成模式可以在运行时原子地切换。
+ */
+class IdGenerator {
+public:
+    /**
+     * @brief 构造函数
+     * @param mode 初始生成模式（默认为 UUID）
+     */
+    explicit IdGenerator(IdMode mode = IdMode::UUID);
+    
+    /**
+     * @brief 生成下一个请求 ID
+     * @return 请求 ID 字符串
+     */
+    std::string next();
+    
+    /// 设置生成模式
+    void set_mode(IdMode mode) { mode_.store(mode, std::memory_order_relaxed); }
+    
+    /// 当前生成模式
+    IdMode mode() const { return mode_.load(std::memory_order_relaxed); }
+    
+    /// 紧凑模式使用的前缀
+    const std::string& prefix() const { return prefix_; }
+    
+private:
+    std::atomic<IdMode> mode_;        ///< 生成模式
+    std::atomic<uint64_t> counter_;   ///< 紧凑模式和数字模式的单调计数器
+    std::string prefix_;              ///< 紧凑模式的前缀（8 个十六进制字符）
+};
+
+} // namespace zenoh_rpc
@@ -3,9 +3,20 @@
 #include <string>
 #include <chrono>
 #include <optional>
+#include <future>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "session.hpp"
+#include "session_pool.hpp"
+#include "shm.hpp"
 #include "jsonrpc_proto.hpp"
+#include "codec.hpp"
+#include "errors.hpp"
+#include "id_generator.hpp"
+#include "typed.hpp"
 
 namespace zenoh_rpc {
 
@@ -18,11 +29,33 @@ using json = nlohmann::json;
  * 本文件定义了 JSON-RPC 客户端类，提供了调用远程方法的功能。
  * 客户端支持：
  * - 同步方法调用
+ * - 异步方法调用（future 或完成回调）
+ * - 不抛出异常的调用（try_call，错误以 RpcResult 返回）
+ * - JSON-RPC 2.0 批量调用（一次查询发送多个请求）
+ * - 单向通知（通过缓存的发布者 put，不等待回复）
  * - 超时控制
  * - 自动错误处理
  * - 会话管理（自动创建或使用现有会话）
  */
 
+/**
+ * @brief 异步调用完成回调
+ * 
+ * 调用成功时 error 为空，result 为方法执行结果；
+ * 调用失败时 error 保存对应的 RpcError 异常，result 为 null。
+ * 回调在 Zenoh 的回复线程中执行，不应长时间阻塞。
+ */
+using CallCallback = std::function<void(std::exception_ptr error, json result)>;
+
+/**
+ * @struct BatchCall
+ * @brief 批量调用中的单个条目
+ */
+struct BatchCall {
+    std::string method;          ///< 要调用的方法名
+    json params = json::object(); ///< 方法参数
+};
+
 /**
  * @class Client
  * @brief JSON-RPC 客户端类
@@ -35,38 +68,42 @@ public:
     /**
      * @brief 构造函数（自动创建会话）
      * @param key_expr Zenoh 键表达式，用于标识远程服务
-     * @param encoding 编码格式，支持 "json" 和 "msgpack"（默认为 "json"）
+     * @param encoding 编码名称，内置 "json"、"msgpack"、"binary"、"cbor"、"ubjson"、"bson"，也可以是注册的自定义编解码器（默认为 "json"）
      * @param timeout 默认超时时间（毫秒，默认为5000ms）
+     * @param sharing 会话共享方式（默认从全局会话池获取，PRIVATE 时创建独占会话）
      * 
-     * 创建一个新的客户端实例，并自动创建一个新的 Zenoh 会话。
-     * 客户端将拥有并管理这个会话的生命周期。
+     * 创建一个新的客户端实例，使用默认配置的 Zenoh 会话。
+     * 默认与其他以默认配置创建的客户端共享会话，最后一个客户端析构时会话关闭。
      */
     explicit Client(const std::string& key_expr, 
                    const std::string& encoding = "json",
-                   std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+                   std::chrono::milliseconds timeout = std::chrono::milliseconds(5000),
+                   SessionSharing sharing = SessionSharing::SHARED);
     
     /**
      * @brief 构造函数（自动创建会话，指定模式和连接）
      * @param key_expr Zenoh 键表达式，用于标识远程服务
      * @param mode 会话模式（client/peer/router）
      * @param connections 连接端点列表
-     * @param encoding 编码格式，支持 "json" 和 "msgpack"（默认为 "json"）
+     * @param encoding 编码名称，内置 "json"、"msgpack"、"binary"、"cbor"、"ubjson"、"bson"，也可以是注册的自定义编解码器（默认为 "json"）
      * @param timeout 默认超时时间（毫秒，默认为5000ms）
+     * @param sharing 会话共享方式（默认从全局会话池获取，PRIVATE 时创建独占会话）
      * 
-     * 创建一个新的客户端实例，使用指定的模式和连接端点创建 Zenoh 会话。
-     * 客户端将拥有并管理这个会话的生命周期。
+     * 创建一个新的客户端实例，使用指定模式和连接端点的 Zenoh 会话。
+     * 默认与模式和端点相同的其他客户端共享会话（见 session_pool.hpp），最后一个客户端析构时会话关闭。
      */
     explicit Client(const std::string& key_expr,
                    SessionMode mode,
                    const std::vector<std::string>& connections = {},
                    const std::string& encoding = "json",
-                   std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+                   std::chrono::milliseconds timeout = std::chrono::milliseconds(5000),
+                   SessionSharing sharing = SessionSharing::SHARED);
     
     /**
      * @brief 构造函数（使用现有会话）
      * @param key_expr Zenoh 键表达式，用于标识远程服务
      * @param session 现有的 Zenoh 会话引用
-     * @param encoding 编码格式，支持 "json" 和 "msgpack"（默认为 "json"）
+     * @param encoding 编码名称，内置 "json"、"msgpack"、"binary"、"cbor"、"ubjson"、"bson"，也可以是注册的自定义编解码器（默认为 "json"）
      * @param timeout 默认超时时间（毫秒，默认为5000ms）
      * 
      * 创建一个新的客户端实例，使用提供的现有会话。
@@ -79,34 +116,258 @@ public:
     /**
      * @brief 析构函数
      * 
+     * 所有尚未完成的异步调用以 ConnectionError 结束。
      * 如果客户端拥有会话，会自动清理会话资源。
      */
-    ~Client() = default;
+    ~Client();
 
     /**
      * @brief 调用远程方法
      * @param method 要调用的方法名
-     * @param params 方法参数（默认为空对象）
+     * @param params 方法参数（默认为空对象；传入右值时移动到请求中，不复制）
      * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
-     * @return 方法执行结果的 JSON 对象
+     * @return 方法执行结果的 JSON 对象（从解码后的响应中移出，不复制）
      * @throws TimeoutError 当请求超时时
      * @throws ConnectionError 当连接失败时
      * @throws RpcError 当远程方法执行出错时
      * 
      * 发送 JSON-RPC 请求到远程服务并等待响应。
      * 如果在指定时间内没有收到响应，会抛出超时异常。
+     * 这是 try_call() 的抛出异常包装。
      */
-    json call(const std::string& method, const json& params = json::object(), 
+    json call(const std::string& method, json params = json::object(), 
               std::optional<std::chrono::milliseconds> timeout = std::nullopt);
 
+    /**
+     * @brief 调用远程方法，不抛出异常
+     * @param method 要调用的方法名
+     * @param params 方法参数（默认为空对象；传入右值时移动到请求中，不复制）
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * @return 方法执行结果，或错误信息 {code, message, data}
+     * 
+     * 与 call() 相同，但错误响应、超时和连接错误都以错误结果返回：
+     * 不构造异常对象，也没有栈展开，适合错误频繁的调用（例如参数校验经常失败的方法）。
+     * 只有发送请求本身失败（例如会话已关闭）时才抛出异常。
+     * 
+     * 使用示例：
+     * @code
+     * RpcResult result = client.try_call("validate", {{"name", name}});
+     * if (!result) {
+     *     log(result.error().code, result.error().message);
+     * }
+     * @endcode
+     */
+    RpcResult try_call(const std::string& method, json params = json::object(),
+                       std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 以类型化参数调用远程方法
+     * @tparam R 结果类型（void 表示忽略结果）
+     * @param method 要调用的方法名
+     * @param args 位置参数
+     * @return 转换为 R 的方法结果
+     * @throws ParseError 当结果无法转换为 R 时
+     * @throws RpcError 与 call() 相同
+     * 
+     * 参数直接打包成位置参数数组，结果直接转换为 R，使用构造函数中设置的默认超时。
+     * 
+     * 使用示例：
+     * @code
+     * double sum = client.call<double>("add", 1.5, 2);
+     * @endcode
+     */
+    template<typename R, typename... Args>
+    R call(const std::string& method, Args&&... args) {
+        return detail::result_as<R>(call(method, detail::pack_params(std::forward<Args>(args)...)));
+    }
+    
+    /**
+     * @brief 按共享的方法签名调用远程方法
+     * @param method 方法签名（通常与服务器共享同一个声明）
+     * @param args 位置参数，个数和类型在编译期按签名检查
+     * @return 转换为签名结果类型的方法结果
+     * 
+     * 参数先转换为签名中的参数类型再打包，与服务器端的转换一致。
+     */
+    template<typename R, typename... Params, typename... Args>
+    R call(const Method<R(Params...)>& method, Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Params), "wrong number of arguments for the method signature");
+        static_assert(std::conjunction_v<std::is_convertible<Args&&, std::decay_t<Params>>...>,
+                      "argument types do not match the method signature");
+        return detail::result_as<R>(call(method.name(),
+            detail::pack_params(static_cast<std::decay_t<Params>>(std::forward<Args>(args))...)));
+    }
+
+    /**
+     * @brief 异步调用远程方法（返回 future）
+     * @param method 要调用的方法名
+     * @param params 方法参数（默认为空对象）
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * @return 方法执行结果的 future，错误以异常形式保存在 future 中
+     * 
+     * 发送请求后立即返回，不等待响应。同一线程可以同时保持
+     * 大量未完成的调用，请求通过 ID 在客户端的待处理表中跟踪。
+     */
+    std::future<json> call_async(const std::string& method, json params = json::object(),
+                                 std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 异步调用远程方法（完成回调）
+     * @param method 要调用的方法名
+     * @param params 方法参数
+     * @param callback 调用完成时执行的回调（成功、错误或超时均只调用一次）
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * 
+     * 与返回 future 的版本相同，但在 Zenoh 回复线程中直接调用回调，
+     * 不需要额外的线程等待结果。
+     */
+    void call_async(const std::string& method, json params, CallCallback callback,
+                    std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 异步调用远程方法，不抛出异常（完成回调）
+     * @param method 要调用的方法名
+     * @param params 方法参数
+     * @param callback 调用完成时以结果对象执行的回调（只调用一次）
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * 
+     * 错误响应、超时和客户端析构都以错误结果调用回调，不构造异常对象。
+     * 回调在 Zenoh 的回复线程中执行，不应长时间阻塞。
+     */
+    void try_call_async(const std::string& method, json params, ResultCallback callback,
+                        std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 发送通知（不等待结果）
+     * @param method 要调用的方法名
+     * @param params 方法参数（默认为空对象）
+     * 
+     * 发送不带 id 的 JSON-RPC 通知。通知通过会话中按键表达式缓存的
+     * zenoh::Publisher 以单向 put 发送，服务器执行方法但从不回复，
+     * 适用于遥测上报、"set" 命令等不需要结果的调用。
+     * 方法执行中的错误不会返回给调用者。
+     */
+    void notify(const std::string& method, json params = json::object());
+
+    /**
+     * @brief 批量调用远程方法
+     * @param calls 要调用的方法列表（传入右值时各条目的参数移动到请求中）
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * @return 与 calls 一一对应的调用结果，单条失败不影响其他条目
+     * @throws TimeoutError 当整个批量请求超时时
+     * @throws RpcError 当服务器拒绝整个批量请求时
+     * 
+     * 将所有请求打包成一个 JSON-RPC 批量数组，通过一次 Zenoh 查询发送，
+     * 服务器以一个响应数组回复。N 个小调用只需要一次往返。
+     */
+    std::vector<RpcResult> call_batch(std::vector<BatchCall> calls,
+                                      std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 异步批量调用远程方法
+     * @param calls 要调用的方法列表
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * @return 调用结果列表的 future
+     */
+    std::future<std::vector<RpcResult>> call_batch_async(std::vector<BatchCall> calls,
+                                                         std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 设置请求 ID 的生成模式
+     * @param mode IdMode::UUID（默认，与 Python 版本兼容）、IdMode::COMPACT 或 IdMode::NUMERIC
+     * 
+     * 紧凑模式使用客户端私有的随机前缀加 64 位单调计数器，
+     * 生成的 ID 更短，通常不需要内存分配。
+     * 数字模式只使用计数器，是二进制编码客户端的默认模式。
+     */
+    void set_id_mode(IdMode mode) { id_generator_.set_mode(mode); }
+
+    /**
+     * @brief 设置共享内存池
+     * @param pool 共享内存池（为空时关闭共享内存路径）
+     * 
+     * 之后编码后不小于池阈值的请求和通知放入共享内存（见 shm.hpp），
+     * 同机的服务器直接从共享内存解码。应在发起调用之前设置。
+     */
+    void set_shared_memory(std::shared_ptr<ShmPool> pool) { shm_ = std::move(pool); }
+
+    /**
+     * @brief 启用或关闭方法ID
+     * @param enabled 是否以方法ID发送调用（二进制编码的客户端默认启用）
+     * 
+     * 启用后，第一次调用时在后台通过保留方法 "rpc.methods" 获取服务器的方法ID映射，
+     * 之后 call() 和 call_async() 在二进制信封头部以 4 字节方法ID代替方法名，
+     * 服务器按位置分发，不计算哈希。服务器的方法表变化后旧的方法ID失效，
+     * 客户端收到 StaleMethodIdError 时丢弃缓存并按方法名重发，调用者不会看到这个错误。
+     * 服务器不支持 "rpc.methods" 时一直按方法名发送。
+     * 
+     * 只对二进制编码生效；通知和批量调用总是按方法名发送。重新启用会丢弃缓存的映射。
+     */
+    void set_method_ids(bool enabled);
+
+    /**
+     * @brief 立即获取服务器的方法ID映射
+     * @param timeout 超时时间（可选，使用构造函数中设置的默认值）
+     * @return 获取到的方法ID数量
+     * @throws RpcError 与 call() 相同
+     * 
+     * 阻塞直到收到映射，之后的调用直接使用方法ID，不必等待后台获取。
+     */
+    size_t refresh_method_ids(std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+
+    /**
+     * @brief 获取服务器的分片数
+     * @return 从回复得知的分片数；0 表示服务器没有分片，请求发往服务键表达式
+     * 
+     * 分片服务器（见 sharded_server.hpp）在回复中附带分片数，
+     * 之后的调用不再经过服务键表达式，而是轮流发往 "<key_expr>/@shard/<i>"。
+     */
+    size_t shard_count() const;
+
+    /**
+     * @brief 获取尚未完成的异步调用数量
+     * @return 待处理表中的请求数量
+     */
+    size_t pending_calls() const;
+
 private:
+    /// 回复解析函数：把回复样本转换为结果对象（错误响应不抛出异常，格式错误时可以抛出）
+    using ReplyParser = std::function<RpcResult(const zenoh::Sample&)>;
+
+    /**
+     * @brief 发送已编码的请求并在待处理表中登记
+     * @param id 登记使用的请求ID
+     * @param payload 已编码的请求载荷
+     * @param timeout 超时时间
+     * @param parse 回复解析函数
+     * @param callback 完成回调
+     */
+    void send_request(const std::string& id, zenoh::Bytes payload, std::chrono::milliseconds timeout,
+                      ReplyParser parse, ResultCallback callback);
+
+    /**
+     * @brief 在后台获取方法ID映射（已有映射或正在获取时不做任何事）
+     */
+    void fetch_method_ids();
+
     std::string key_expr_;                      ///< Zenoh 键表达式
     Session* session_;                          ///< Zenoh 会话指针
-    bool owns_session_;                         ///< 是否拥有会话的所有权
-    std::unique_ptr<Session> owned_session_;    ///< 拥有的会话实例
-    std::string encoding_;                      ///< 编码格式（"json" 或 "msgpack"）
+    bool owns_session_;                         ///< 是否拥有会话的所有权（独占或与会话池中的其他客户端共享）
+    std::shared_ptr<Session> owned_session_;    ///< 拥有的会话实例
+    std::string encoding_;                      ///< 编码名称
+    const Codec* codec_;                        ///< 构造时从注册表解析出的编解码器，请求时直接使用
+    EncodingType encoding_type_;                ///< 编解码器的编码类型
     std::chrono::milliseconds default_timeout_; ///< 默认超时时间
+    IdGenerator id_generator_;                  ///< 请求 ID 生成器
+    std::shared_ptr<ShmPool> shm_;              ///< 大载荷使用的共享内存池（可以为空）
     // 移除 querier_ 成员变量，改用 Session::get() 方法
+
+    struct PendingTable;                        ///< 待处理请求表（按请求 ID 索引）
+    std::shared_ptr<PendingTable> pending_;     ///< 由 Zenoh 回调共享，保证客户端析构后仍可安全访问
+    struct MethodIdCache;                       ///< 服务器的方法ID映射
+    std::shared_ptr<MethodIdCache> method_ids_; ///< 由获取映射的回调共享
+    struct ShardRoute;                          ///< 分片服务器的请求路由
+    std::shared_ptr<ShardRoute> shards_;        ///< 由回复回调共享
 };
 
 } // namespace zenoh_rpc
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
 #include <nlohmann/json.hpp>
-#include <random>
-#include <sstream>
-#include <iomanip>
 
 namespace zenoh_rpc {
 
@@ -20,10 +22,44 @@ using json = nlohmann::json;
  * - 编码和解码功能
  * - 参数处理（位置参数和关键字参数）
  * 
+ * 创建消息的函数都有接受右值的重载：传入临时对象或 std::move 的参数、结果时
+ * 直接移动进消息，不深拷贝 JSON 树。
+ * 
  * 支持的编码格式：
  * - JSON（完全支持）
- * - MessagePack（计划支持）
+ * - MessagePack（完全支持，服务器按请求编码自动应答）
+ */
+
+/// 保留方法：服务器以方法ID映射回复（见 DispatcherBase::method_ids()）
+constexpr const char* kMethodIdsMethod = "rpc.methods";
+
+/// 分片服务器回复附件的前缀，后接十进制分片数（见 sharded_server.hpp）
+constexpr const char* kShardsAttachmentPrefix = "rpc.shards=";
+
+/**
+ * @brief 获取分片的键表达式
+ * @param key_expr 服务键表达式
+ * @param shard 分片序号
+ * @return "<key_expr>/@shard/<shard>"
+ * 
+ * "@shard" 是 Zenoh 的逐字匹配段（verbatim chunk）：服务键表达式后接 ** 的订阅者和查询对象
+ * 不匹配分片键，服务键表达式上的通配符查询也不会到达分片。
  */
+std::string shard_key_expr(const std::string& key_expr, size_t shard);
+
+/**
+ * @brief 编码分片附件
+ * @param shards 分片数
+ * @return "rpc.shards=<shards>"，由 parse_shards_attachment() 解析
+ */
+std::string make_shards_attachment(size_t shards);
+
+/**
+ * @brief 解析分片附件
+ * @param attachment 回复附件内容
+ * @return 分片数；不是分片附件或格式错误时返回 0
+ */
+size_t parse_shards_attachment(std::string_view attachment);
 
 /**
  * @brief 生成 UUID
@@ -31,6 +67,7 @@ using json = nlohmann::json;
  * 
  * 生成符合 UUID v4 标准的唯一标识符，用于 JSON-RPC 请求的 ID 字段。
  * 格式：xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx
+ * 线程安全，实现见 id_generator.hpp。
  */
 std::string gen_uuid();
 
@@ -46,6 +83,41 @@ std::string gen_uuid();
  */
 json make_request(const std::string& method, const json& params = json::object(), const std::string& id = "");
 
+/**
+ * @brief 创建 JSON-RPC 请求（移入参数）
+ * @param method 要调用的方法名
+ * @param params 方法参数，移动到请求中
+ * @param id 请求ID（如果为空则自动生成）
+ * @return 格式化的 JSON-RPC 请求对象
+ */
+json make_request(const std::string& method, json&& params, const std::string& id = "");
+
+/**
+ * @brief 创建 JSON-RPC 通知
+ * @param method 要调用的方法名
+ * @param params 方法参数（可以是对象或数组，默认为空对象）
+ * @return 格式化的 JSON-RPC 通知对象
+ * 
+ * 通知是没有 "id" 字段的请求，服务器执行方法但从不回复。
+ * 通知格式：{"jsonrpc": "2.0", "method": "...", "params": {...}}
+ */
+json make_notification(const std::string& method, const json& params = json::object());
+
+/**
+ * @brief 创建 JSON-RPC 通知（移入参数）
+ * @param method 要调用的方法名
+ * @param params 方法参数，移动到通知中
+ * @return 格式化的 JSON-RPC 通知对象
+ */
+json make_notification(const std::string& method, json&& params);
+
+/**
+ * @brief 判断请求是否为通知
+ * @param request 请求对象
+ * @return 如果请求是没有 "id" 字段的对象则返回 true
+ */
+bool is_notification(const json& request);
+
 /**
  * @brief 使用位置参数创建 JSON-RPC 请求
  * @tparam Args 参数类型包
@@ -61,7 +133,7 @@ template<typename... Args>
 json make_request_args(const std::string& method, const std::string& id, Args&&... args) {
     json params = json::array();
     (params.push_back(std::forward<Args>(args)), ...);
-    return make_request(method, params, id);
+    return make_request(method, std::move(params), id);
 }
 
 /**
@@ -78,7 +150,7 @@ template<typename... Args>
 json make_request_args(const std::string& method, Args&&... args) {
     json params = json::array();
     (params.push_back(std::forward<Args>(args)), ...);
-    return make_request(method, params, "");
+    return make_request(method, std::move(params), "");
 }
 
 /**
@@ -101,11 +173,20 @@ json make_request_list(const std::string& method, const std::initializer_list<js
  * 验证请求是否符合 JSON-RPC 2.0 规范：
  * - 必须包含 "jsonrpc": "2.0"
  * - 必须包含 "method" 字段
- * - 必须包含 "id" 字段
+ * - 必须包含 "id" 字段（通知请使用 validate_notification）
  * - "params" 字段可选，但如果存在必须是对象或数组
  */
 bool validate_request(const json& request);
 
+/**
+ * @brief 验证 JSON-RPC 通知的有效性
+ * @param notification 要验证的通知对象
+ * @return 如果通知有效则返回 true
+ * 
+ * 与 validate_request 相同，但要求不包含 "id" 字段。
+ */
+bool validate_notification(const json& notification);
+
 /**
  * @brief 验证 JSON-RPC 响应的有效性
  * @param response 要验证的响应对象
@@ -130,6 +211,15 @@ bool validate_response(const json& response);
  */
 json make_request_kwargs(const std::string& method, const json& kwargs, const std::string& id = "");
 
+/**
+ * @brief 使用关键字参数创建 JSON-RPC 请求（移入参数）
+ * @param method 要调用的方法名
+ * @param kwargs 关键字参数对象，移动到请求中
+ * @param id 请求ID（如果为空则自动生成）
+ * @return 格式化的 JSON-RPC 请求对象
+ */
+json make_request_kwargs(const std::string& method, json&& kwargs, const std::string& id = "");
+
 /**
  * @brief 创建成功的 JSON-RPC 响应
  * @param result 方法执行结果
@@ -141,6 +231,16 @@ json make_request_kwargs(const std::string& method, const json& kwargs, const st
  */
 json make_response_ok(const json& result, const std::string& id);
 
+/**
+ * @brief 创建成功的 JSON-RPC 响应（移入结果）
+ * @param result 方法执行结果，移动到响应中
+ * @param id 对应请求的ID
+ * @return 格式化的成功响应对象
+ * 
+ * 服务器用它把处理函数返回的结果直接移动进响应，大结果不会被复制。
+ */
+json make_response_ok(json&& result, const std::string& id);
+
 /**
  * @brief 创建错误的 JSON-RPC 响应
  * @param code 错误代码
@@ -170,13 +270,113 @@ json make_response_err(int code, const std::string& message, const std::string&
  * @enum EncodingType
  * @brief 编码类型枚举
  * 
- * 定义支持的消息编码格式。
+ * 定义支持的消息编码格式。每种编码由 codec.hpp 中注册的编解码器实现，
+ * 自定义编解码器使用 kFirstCustomEncoding 及以上的值。
  */
-enum class EncodingType {
+enum class EncodingType : uint8_t {
     JSON,       ///< JSON 编码格式（完全支持）
-    MSGPACK     ///< MessagePack 编码格式（计划支持）
+    MSGPACK,    ///< MessagePack 编码格式（完全支持）
+    BINARY,     ///< 固定头部加 MessagePack 主体的紧凑信封（见 binary_envelope.hpp）
+    CBOR,       ///< CBOR（RFC 8949）
+    UBJSON,     ///< Universal Binary JSON
+    BSON        ///< BSON（批量数组包装为 {"batch": [...]}）
 };
 
+/**
+ * @brief 根据编码名称获取编码类型
+ * @param name 编码名称（"json"、"msgpack"、"binary"、"cbor"、"ubjson"、"bson" 或自定义编解码器的名称）
+ * @return 对应的编码类型；名称没有注册时返回空值
+ */
+std::optional<EncodingType> encoding_from_name(const std::string& name);
+
+/**
+ * @brief 获取编码类型对应的 MIME 类型字符串
+ * @param type 编码类型
+ * @return MIME 类型字符串（如 "application/json"、"application/msgpack"、"application/cbor"）
+ * @throws std::invalid_argument 当编码类型没有注册时
+ * 
+ * 客户端和服务器用它标记 Zenoh 载荷的 Encoding。
+ */
+std::string encoding_mime(EncodingType type);
+
+/**
+ * @brief 取出 Zenoh Encoding 字符串中的 MIME 类型
+ * @param mime Zenoh Encoding 的字符串形式
+ * @return 去掉 "zenoh/bytes;" 前缀和 ";schema" 后缀后的 MIME 类型
+ * 
+ * Zenoh 只预定义了部分 MIME 类型（application/json、application/cbor 等）；
+ * 其他 MIME 类型保存为 zenoh/bytes 的 schema，as_string() 返回 "zenoh/bytes;application/msgpack"。
+ */
+std::string mime_base(const std::string& mime);
+
+/**
+ * @brief 根据 MIME 类型字符串获取编码类型
+ * @param mime Zenoh Encoding 的字符串形式（可以带 ";schema" 后缀）
+ * @return 对应的编码类型；无法识别时返回空值
+ */
+std::optional<EncodingType> encoding_from_mime(const std::string& mime);
+
+/**
+ * @brief 根据载荷首字节推测编码类型
+ * @param data 载荷数据
+ * @return 推测的编码类型
+ * 
+ * 跳过空白后以 '{' 或 '[' 开头的载荷视为 JSON；
+ * 以 MessagePack map/array 标记（0x80-0x9f、0xdc-0xdf）开头的视为 MessagePack；
+ * 以 0xc1（二进制信封的 magic）开头的视为二进制信封。
+ * 无法判断时返回 JSON。用于对端没有标记 Encoding 的情况；
+ * CBOR、UBJSON 和 BSON 无法从首字节区分，必须标记 Encoding。
+ */
+EncodingType sniff_encoding(const std::string& data);
+
+/**
+ * @brief 根据载荷首字节推测编码类型（连续字节视图）
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @return 推测的编码类型
+ */
+EncodingType sniff_encoding(const char* data, std::size_t size);
+
+/**
+ * @brief 按指定编码类型编码 JSON 对象
+ * @param data 要编码的 JSON 对象
+ * @param type 编码类型
+ * @return 编码后的字符串
+ */
+std::string encode(const json& data, EncodingType type);
+
+/**
+ * @brief 按指定编码类型编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param type 编码类型
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ * 
+ * 重复使用同一个缓冲区时，容量足够的情况下不会为输出重新分配内存。
+ */
+void encode_into(const json& data, EncodingType type, std::string& out);
+
+/**
+ * @brief 按指定编码类型解码字符串
+ * @param data 要解码的字符串
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ */
+json decode(const std::string& data, EncodingType type);
+
+/**
+ * @brief 按指定编码类型解码连续字节视图
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ * 
+ * 直接在调用方的缓冲区上解析，不复制载荷。
+ * 从 zenoh::Bytes 解码请使用 payload.hpp 中的 decode_payload。
+ */
+json decode(const char* data, std::size_t size, EncodingType type);
+
 /**
  * @brief 获取当前编码类型字符串
  * @return 编码类型字符串
@@ -205,6 +405,23 @@ std::pair<std::function<std::string(const json&)>, std::function<json(const std:
  */
 std::string encode_json(const json& data);
 
+/**
+ * @brief 将 JSON 对象编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ */
+void encode_json_into(const json& data, std::string& out);
+
+/**
+ * @brief 将 JSON 对象以紧凑格式追加到 out（不清空）
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区
+ * @throws nlohmann::json::type_error 字符串含非法 UTF-8 时抛出，已写入 out 的部分保留
+ * 
+ * 本库唯一依赖 nlohmann::detail 的辅助函数，供需要拼接 JSON 文本的编码器使用。
+ */
+void append_json(const json& data, std::string& out);
+
 /**
  * @brief 将字符串解码为 JSON 对象
  * @param data 要解码的字符串
@@ -216,6 +433,17 @@ std::string encode_json(const json& data);
  */
 json decode_json(const std::string& data);
 
+/**
+ * @brief 将连续字节视图解码为 JSON 对象
+ * @param data JSON 文本起始地址
+ * @param size JSON 文本字节数
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当数据不是有效的 JSON 格式时
+ * 
+ * 原地解析，不复制输入。
+ */
+json decode_json(const char* data, std::size_t size);
+
 /**
  * @brief 将 JSON 对象编码为 MessagePack 字符串
  * @param data 要编码的 JSON 对象
@@ -226,6 +454,15 @@ json decode_json(const std::string& data);
  */
 std::string encode_msgpack(const json& data);
 
+/**
+ * @brief 将 JSON 对象以 MessagePack 格式编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ * 
+ * 直接写入 out，不经过中间的 std::vector。
+ */
+void encode_msgpack_into(const json& data, std::string& out);
+
 /**
  * @brief 将 MessagePack 字符串解码为 JSON 对象
  * @param data 要解码的 MessagePack 字符串
@@ -237,4 +474,15 @@ std::string encode_msgpack(const json& data);
  */
 json decode_msgpack(const std::string& data);
 
+/**
+ * @brief 将连续字节视图解码为 MessagePack 对应的 JSON 对象
+ * @param data MessagePack 数据起始地址
+ * @param size MessagePack 数据字节数
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当 MessagePack 解析失败时
+ * 
+ * 原地解析，不复制输入。
+ */
+json decode_msgpack(const char* data, std::size_t size);
+
 } // namespace zenoh_rpc
\ No newline at end of file
@@ -1,11 +1,24 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <atomic>
 #include <functional>
+#include <map>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "session.hpp"
+#include "shm.hpp"
 #include "jsonrpc_proto.hpp"
+#include "executor.hpp"
+#include "typed.hpp"
+#include "unique_function.hpp"
+#include "method_table.hpp"
 
 namespace zenoh_rpc {
 
@@ -17,6 +30,8 @@ using json = nlohmann::json;
  * 
  * 本文件定义了 JSON-RPC 服务器的核心组件，包括：
  * - 方法分发器基类
+ * - 异步方法及其回复句柄
+ * - 可启动、停止的服务器对象
  * - 服务器运行函数
  * - 方法注册和调用机制
  * 
@@ -25,23 +40,125 @@ using json = nlohmann::json;
  * - 错误处理和异常转换
  * - 方法动态注册
  * - 支持自定义会话或自动创建会话
+ * - 可选的工作线程池，使请求处理与 Zenoh 回调线程解耦
+ * - JSON-RPC 2.0 批量请求（可选并行分发）
+ * - 通知（不带 id 的请求）：通过查询或订阅的 put 接收，从不回复
+ * - 不抛出异常的分发路径：方法不存在、参数校验失败等错误以 RpcResult 报告
  */
 
+/// 方法完成回调：error 为空时 result 为方法结果，否则 result 无意义
+using DispatchCallback = std::function<void(std::exception_ptr error, json result)>;
+
+/**
+ * @class ReplyHandle
+ * @brief 异步方法的回复句柄
+ * 
+ * 异步方法收到此句柄后可以立即返回，稍后在任意线程中调用 resolve() 或 reject() 完成请求。
+ * 句柄可以复制（所有副本共享同一个请求），只有第一次完成生效。
+ * 所有副本销毁时仍未完成的请求以 -32603 "Method returned without replying" 结束，
+ * 不会让客户端一直等到超时。
+ * 
+ * 服务器在请求完成之前保持 zenoh::Query 有效，并把它计入 Server::in_flight()。
+ */
+class ReplyHandle {
+public:
+    /**
+     * @brief 创建回复句柄
+     * @param done 完成回调（最多调用一次）
+     */
+    explicit ReplyHandle(DispatchCallback done);
+    
+    /**
+     * @brief 创建回复句柄（以结果对象完成）
+     * @param done 完成回调（最多调用一次）
+     */
+    explicit ReplyHandle(ResultCallback done);
+    
+    /**
+     * @brief 以结果完成请求
+     * @param result 方法执行结果
+     */
+    void resolve(json result) const;
+    
+    /**
+     * @brief 以异常完成请求
+     * @param error 异常（RpcError 保留错误代码，其他异常转换为 -32603）
+     */
+    void reject(std::exception_ptr error) const;
+    
+    /**
+     * @brief 以错误代码完成请求
+     * @param code JSON-RPC 错误代码
+     * @param message 错误消息
+     * @param data 附加错误数据
+     * 
+     * 不构造异常对象。
+     */
+    void reject(int code, const std::string& message, const json& data = json::object()) const;
+    
+    /**
+     * @brief 以结果对象完成请求
+     * @param result 成功值或错误信息（例如下游 Client::try_call() 的结果）
+     */
+    void complete(RpcResult result) const;
+    
+    /**
+     * @brief 请求是否已经完成
+     * @return 已调用过 resolve() 或 reject() 时返回 true
+     */
+    bool is_completed() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+/// 同步方法处理函数：接受参数并返回结果（只移动，小型可调用对象不分配堆内存）
+using MethodHandler = UniqueFunction<json(const json& params)>;
+
+/// 异步方法处理函数：通过 reply 句柄在稍后完成请求
+using AsyncHandler = UniqueFunction<void(const json& params, ReplyHandle reply)>;
+
+/// 返回结果对象的方法处理函数：以 RpcResult::err() 报告错误，不需要抛出异常
+using ResultHandler = UniqueFunction<RpcResult(const json& params)>;
+
 /**
  * @class DispatcherBase
  * @brief 方法分发器基类
  * 
  * 负责管理和分发 JSON-RPC 方法调用。提供方法注册和调用的基础功能。
  * 用户可以继承此类来实现自定义的方法分发逻辑。
+ * 
+ * 注册表采用写时复制：Server::start() 调用 publish() 后，分发在不可变的
+ * 完美哈希表快照中按 std::string_view 查找，不加锁、不分配内存；
+ * 注册和注销方法会构建新表并原子地替换快照，可以在服务器运行时进行。
+ * 正在执行的调用继续使用它查找到的处理函数。
+ * 
+ * 发布后每次修改都要重建整个表（与方法数成正比），
+ * 大量方法应在启动前注册。
+ * 
+ * 与 1.2.1 版本不同（自 2.0.0 起），注册表不再是受保护成员，分发器也不可复制（持有互斥量和原子快照），
+ * 处理函数保存为只移动的 UniqueFunction 而不是 std::function；
+ * 派生类通过 method_names() 和公共接口访问已注册的方法。
+ * 
+ * 发布的表为每个方法分配一个方法ID（表版本的低 16 位加方法在表中的位置），
+ * 服务器通过保留方法 "rpc.methods" 公布方法名到方法ID的映射，
+ * 二进制信封的客户端可以用方法ID代替方法名，分发时直接按位置取出条目。
+ * 每次重建表都会更换版本，旧的方法ID随之失效（以 -32003 回复）。
  */
 class DispatcherBase {
 public:
+    DispatcherBase();
+    
     /**
      * @brief 虚析构函数
      * 
      * 确保派生类能够正确析构。
      */
-    virtual ~DispatcherBase() = default;
+    virtual ~DispatcherBase();
+    
+    DispatcherBase(const DispatcherBase&) = delete;
+    DispatcherBase& operator=(const DispatcherBase&) = delete;
     
     /**
      * @brief 注册方法处理器
@@ -50,8 +167,143 @@ public:
      * 
      * 将一个方法名与其处理函数关联起来。
      * 处理函数接受 JSON 参数并返回 JSON 结果。
+     * 如果方法名已存在（同步或异步），会覆盖原有的处理函数。
+     * 可以在服务器运行时调用，返回后的新请求使用新的处理函数。
      */
-    void register_method(const std::string& method_name, std::function<json(const json&)> handler);
+    void register_method(const std::string& method_name, MethodHandler handler);
+    
+    /**
+     * @brief 注册类型化方法处理器
+     * @tparam Signature 方法签名 R(Args...)
+     * @param method_name 方法名称
+     * @param handler 以 Args... 为参数、返回可转换为 R 的值的处理函数
+     * 
+     * 位置参数在调用前按签名转换，个数不符或类型不匹配时回复 -32602
+     * （个数和基本类型的检查不抛出异常，见 detail::try_invoke_typed()）；
+     * 以 const std::string& 或 const json& 接收的参数直接引用请求中的元素。
+     * 处理函数与签名不符时编译失败。
+     * 
+     * 使用示例：
+     * @code
+     * register_method<double(double, double)>("add", [](double a, double b) { return a + b; });
+     * @endcode
+     */
+    template<typename Signature, typename F>
+    void register_method(const std::string& method_name, F handler) {
+        register_method(Method<Signature>(method_name), std::move(handler));
+    }
+    
+    /**
+     * @brief 按共享的方法签名注册类型化方法处理器
+     * @param method 方法签名（通常与客户端共享同一个声明）
+     * @param handler 处理函数
+     */
+    template<typename R, typename... Args, typename F>
+    void register_method(const Method<R(Args...)>& method, F handler) {
+        static_assert(std::is_invocable_v<F&, typename detail::ParamConverter<Args>::type...>,
+                      "handler cannot be called with the parameter types of the method signature");
+        if constexpr (!std::is_void_v<R>) {
+            static_assert(std::is_convertible_v<std::invoke_result_t<F&, typename detail::ParamConverter<Args>::type...>, R>,
+                          "handler result is not convertible to the result type of the method signature");
+        }
+        register_result_method(method.name(), [handler = std::move(handler)](const json& params) mutable {
+            return detail::try_invoke_typed<R, Args...>(handler, params);
+        });
+    }
+    
+    /**
+     * @brief 注册返回结果对象的方法处理器
+     * @param method_name 方法名称
+     * @param handler 返回 RpcResult 的处理函数
+     * 
+     * 处理函数以 RpcResult::err() 拒绝请求，错误直接写入响应，不经过异常，
+     * 适合校验失败频繁的方法；抛出的异常仍按错误响应回复。
+     * 同名的同步或异步处理器会被替换。
+     * 
+     * 使用示例：
+     * @code
+     * register_result_method("withdraw", [&](const json& params) {
+     *     if (!params.contains("amount")) {
+     *         return RpcResult::err(-32602, "Missing amount");
+     *     }
+     *     return RpcResult::ok(account.withdraw(params["amount"]));
+     * });
+     * @endcode
+     */
+    void register_result_method(const std::string& method_name, ResultHandler handler);
+    
+    /**
+     * @brief 注册异步方法处理器
+     * @param method_name 方法名称
+     * @param handler 异步处理函数
+     * 
+     * 处理函数收到参数和回复句柄，可以在发起 I/O 或下游 RPC 后立即返回，
+     * 不占用线程等待；结果通过 ReplyHandle 在任意线程中回复。
+     * params 只在处理函数执行期间有效，稍后使用时需要复制。
+     * 处理函数同步抛出的异常按错误响应回复。
+     * 同名的同步处理器会被替换。
+     * 
+     * 使用示例：
+     * @code
+     * register_async_method("lookup", [&db](const json& params, ReplyHandle reply) {
+     *     db.query_async(params["key"], [reply](Row row) { reply.resolve(row.to_json()); });
+     * });
+     * @endcode
+     */
+    void register_async_method(const std::string& method_name, AsyncHandler handler);
+    
+    /**
+     * @brief 注销方法
+     * @param method_name 方法名称
+     * @return 方法存在并被注销时返回 true
+     * 
+     * 返回后的新请求得到 -32601 "Method not found"；
+     * 已经开始执行的调用不受影响，处理函数在最后一个调用结束后销毁。
+     */
+    bool unregister_method(std::string_view method_name);
+    
+    /**
+     * @brief 发布方法表
+     * 
+     * 把已注册的方法构建成不可变的完美哈希表，之后的查找只读取发布的快照，不再加锁。
+     * 发布前的查找在互斥锁保护下访问注册表，发布前的注册不重建表。
+     * 重复调用没有效果。Server::start() 会自动调用。
+     */
+    void publish();
+    
+    /**
+     * @brief 方法表是否已经发布
+     * @return 已发布时返回 true
+     */
+    bool is_published() const;
+    
+    /**
+     * @brief 是否注册了指定方法
+     * @param method_name 方法名
+     * @return 已注册（同步或异步）时返回 true
+     */
+    bool has_method(std::string_view method_name) const;
+    
+    /**
+     * @brief 是否存在指定方法ID对应的方法
+     * @param method_id 方法ID（见 method_ids()）
+     * @return 方法ID属于当前发布的表时返回 true
+     */
+    bool has_method(uint32_t method_id) const;
+    
+    /**
+     * @brief 已注册的方法数量
+     */
+    size_t method_count() const;
+    
+    /**
+     * @brief 当前发布的表的方法ID映射
+     * @return {"version": 表版本, "methods": {方法名: 方法ID, ...}}；
+     *         未发布或方法数超过 65536 个时 version 为 0、methods 为空对象
+     * 
+     * 服务器以此回复保留方法 "rpc.methods"。
+     */
+    json method_ids() const;
     
     /**
      * @brief 分发方法调用
@@ -59,15 +311,265 @@ public:
      * @param params 方法参数
      * @return 方法执行结果
      * @throws MethodNotFoundError 当方法不存在时
+     * @throws RpcError 当方法报告错误时（处理函数抛出的异常原样重新抛出）
      * 
-     * 根据方法名查找对应的处理函数并执行。
-     * 如果方法不存在，会抛出 MethodNotFoundError 异常。
+     * try_dispatch() 的抛出异常包装。
+     * 异步方法会阻塞当前线程直到其回复句柄完成。
      */
-    json dispatch(const std::string& method_name, const json& params);
+    json dispatch(std::string_view method_name, const json& params);
+    
+    /**
+     * @brief 分发方法调用，不抛出异常
+     * @param method_name 要调用的方法名
+     * @param params 方法参数
+     * @return 方法执行结果，或错误信息（方法不存在时为 -32601）
+     * 
+     * 方法不存在和返回 RpcResult::err() 的错误不构造异常对象；
+     * 处理函数抛出的异常被捕获并转换为错误结果。
+     * 异步方法会阻塞当前线程直到其回复句柄完成。
+     */
+    RpcResult try_dispatch(std::string_view method_name, const json& params);
+    
+    /**
+     * @brief 以回调方式分发方法调用
+     * @param method_name 要调用的方法名
+     * @param params 方法参数
+     * @param done 完成回调，恰好调用一次
+     * 
+     * 同步方法在当前线程执行后立即调用 done；
+     * 异步方法在其回复句柄完成时（可能在其他线程）调用 done。
+     * 方法不存在时以 MethodNotFoundError 调用 done。
+     */
+    void dispatch_async(std::string_view method_name, const json& params, DispatchCallback done);
+    
+    /**
+     * @brief 按方法ID以回调方式分发方法调用
+     * @param method_id 方法ID（见 method_ids()）
+     * @param params 方法参数
+     * @param done 完成回调，恰好调用一次
+     * 
+     * 按位置从发布的表中取出方法，不计算哈希、不比较方法名。
+     * 方法ID不属于当前发布的表时以 StaleMethodIdError 调用 done。
+     */
+    void dispatch_async(uint32_t method_id, const json& params, DispatchCallback done);
+    
+    /**
+     * @brief 以回调方式分发方法调用，不抛出异常
+     * @param method_name 要调用的方法名
+     * @param params 方法参数
+     * @param done 完成回调，以结果对象恰好调用一次
+     * 
+     * 与 dispatch_async() 相同，但错误以 RpcResult 报告：
+     * 方法不存在时以 -32601 错误结果调用 done，不构造异常对象。
+     * 服务器以此分发请求。
+     */
+    void try_dispatch_async(std::string_view method_name, const json& params, ResultCallback done);
+    
+    /**
+     * @brief 按方法ID以回调方式分发方法调用，不抛出异常
+     * @param method_id 方法ID（见 method_ids()）
+     * @param params 方法参数
+     * @param done 完成回调，以结果对象恰好调用一次
+     * 
+     * 方法ID不属于当前发布的表时以 -32003 错误结果调用 done。
+     */
+    void try_dispatch_async(uint32_t method_id, const json& params, ResultCallback done);
     
 protected:
-    /// 方法名到处理函数的映射表
-    std::unordered_map<std::string, std::function<json(const json&)>> methods_;
+    /**
+     * @brief 已注册的方法名
+     * @return 按名称排序的方法名列表
+     * 
+     * 注册表是私有的：派生类通过此函数、has_method() 和 try_dispatch()
+     * 读取方法，代替 1.2.1 版本中受保护的 methods_（方法名到 std::function 处理函数的映射表）。
+     */
+    std::vector<std::string> method_names() const;
+    
+private:
+    struct MethodEntry;
+    struct MethodTable;
+    
+    /**
+     * @brief 查找方法
+     * @param method_name 方法名
+     * @return 方法条目；不存在时返回 nullptr
+     */
+    std::shared_ptr<const MethodEntry> find_method(std::string_view method_name) const;
+    
+    /**
+     * @brief 按方法ID查找方法
+     * @param method_id 方法ID
+     * @return 方法条目；方法ID不属于当前发布的表时返回 nullptr
+     */
+    std::shared_ptr<const MethodEntry> find_method(uint32_t method_id) const;
+    
+    /**
+     * @brief 修改注册表
+     * @param method_name 方法名
+     * @param entry 新的方法条目；为空时注销该方法
+     * @return 注册表发生变化时返回 true
+     */
+    bool update_method(std::string_view method_name, std::shared_ptr<const MethodEntry> entry);
+    
+    /**
+     * @brief 由注册表构建新表并替换快照（调用者持有 registry_mutex_）
+     */
+    void publish_locked();
+    
+    /**
+     * @brief 以回调方式执行已找到的方法
+     */
+    static void invoke_async(const MethodEntry& entry, const json& params, ResultCallback done);
+    
+    /// 保护注册表，串行化写者
+    mutable std::mutex registry_mutex_;
+    
+    /// 注册的方法（按方法名排序，支持以 std::string_view 查找）
+    std::map<std::string, std::shared_ptr<const MethodEntry>, std::less<>> methods_;
+    
+    /// 发布的方法表快照（发布前为空，由 registry_mutex_ 的持有者替换）
+    std::atomic<const MethodTable*> table_{nullptr};
+    
+    /// 最近一次发布的表版本（由 registry_mutex_ 保护）
+    uint32_t table_version_ = 0;
+    
+    /// 跟踪仍在读取旧快照的查找
+    ReadEpoch readers_;
+};
+
+/**
+ * @struct ServerOptions
+ * @brief 服务器配置
+ */
+struct ServerOptions {
+    Executor* executor = nullptr;   ///< 处理请求的执行器（为空时在 Zenoh 回调线程中处理）
+    size_t batch_parallelism = 1;   ///< 批量请求分发的并行度（1 表示按顺序分发；并行块在 executor 中执行，没有执行器时按顺序分发）
+    size_t max_batch_size = 1024;   ///< 批量请求允许的最大条目数
+    size_t max_params_size = 0;     ///< 单个请求参数编码后的最大字节数（0 表示不限制）
+    size_t shard_count = 0;         ///< 非零时每个回复附带分片数，客户端据此把调用分散到各分片（见 sharded_server.hpp）
+    const ShmPool* shm = nullptr;   ///< 回复使用的共享内存池（为空时不使用；编码后不小于阈值的回复放入共享内存）
+};
+
+/**
+ * @struct ServerStats
+ * @brief 服务器计数器快照
+ */
+struct ServerStats {
+    uint64_t queries = 0;        ///< 已处理的查询数（批量请求计为一个）
+    uint64_t notifications = 0;  ///< 已执行的通知数
+    uint64_t errors = 0;         ///< 回复的错误响应数（批量请求按条目计）
+    uint64_t rejected = 0;       ///< 以 "Server busy"/"Server shutting down" 拒绝的查询和丢弃的通知数
+    
+    /// 累加另一个快照
+    ServerStats& operator+=(const ServerStats& other) {
+        queries += other.queries;
+        notifications += other.notifications;
+        errors += other.errors;
+        rejected += other.rejected;
+        return *this;
+    }
+};
+
+/**
+ * @class Server
+ * @brief 可停止的 RPC 服务器
+ * 
+ * 拥有键表达式上的可查询对象和通知订阅者。
+ * start() 声明后立即返回，调用线程可以继续运行自己的事件循环；
+ * stop() 停止接受新请求，在期限内等待在途请求完成后返回；
+ * wait() 阻塞直到服务器被停止。
+ * 
+ * 使用示例：
+ * @code
+ * Server server("example/service", dispatcher, session);
+ * server.start();
+ * // ...
+ * server.stop(std::chrono::seconds(10));
+ * @endcode
+ * 
+ * 分发器、会话和配置中的执行器必须比服务器活得更久。
+ */
+class Server {
+public:
+    /**
+     * @brief 创建服务器（不立即开始服务）
+     * @param key_expr Zenoh 键表达式，用于标识服务
+     * @param dispatcher 方法分发器引用
+     * @param session 现有的 Zenoh 会话引用
+     * @param options 服务器配置
+     */
+    Server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session,
+           const ServerOptions& options = ServerOptions());
+    
+    /**
+     * @brief 析构函数
+     * 
+     * 服务器仍在运行时按默认期限调用 stop()。
+     */
+    ~Server();
+    
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+    
+    /**
+     * @brief 声明可查询对象和通知订阅者，开始服务
+     * @throws std::logic_error 当服务器已经在运行时
+     * 
+     * 调用分发器的 publish() 发布当前的方法表；服务器运行期间注册或注销的方法
+     * 同样会发布新表，之后到达的请求立即可以使用（见 DispatcherBase）。
+     */
+    void start();
+    
+    /**
+     * @brief 停止服务器
+     * @param drain_timeout 等待在途请求完成的最长时间
+     * @return 所有在途请求在期限内完成时返回 true
+     * 
+     * 停止接受新请求并撤销声明，然后等待已接受的请求（包括执行器队列中的）完成。
+     */
+    bool stop(std::chrono::milliseconds drain_timeout = std::chrono::seconds(5));
+    
+    /**
+     * @brief 阻塞直到服务器被停止
+     */
+    void wait();
+    
+    /**
+     * @brief 服务器是否正在运行
+     * @return start() 之后、stop() 完成之前返回 true
+     */
+    bool is_running() const;
+    
+    /**
+     * @brief 获取服务器计数器
+     * @return 计数器快照（跨 stop()/start() 累计）
+     */
+    ServerStats stats() const;
+    
+    /**
+     * @brief 正在处理的查询和通知数
+     * @return 在途数量（包括执行器队列中等待的）
+     */
+    size_t in_flight() const;
+    
+    /**
+     * @brief 获取服务的键表达式
+     * @return 键表达式
+     */
+    const std::string& key_expr() const { return key_expr_; }
+    
+    /// 运行状态（实现细节，由回调和工作线程任务共享）
+    struct State;
+
+private:
+    std::string key_expr_;                              ///< 服务键表达式
+    DispatcherBase& dispatcher_;                        ///< 方法分发器
+    Session& session_;                                  ///< Zenoh 会话
+    ServerOptions options_;                             ///< 服务器配置
+    std::shared_ptr<State> state_;                      ///< 运行状态
+    std::optional<zenoh::Queryable<void>> queryable_;   ///< 请求的可查询对象
+    std::optional<zenoh::Subscriber<void>> subscriber_; ///< 通知的订阅者
+    std::mutex lifecycle_mutex_;                        ///< 串行化 start() 和 stop()
 };
 
 /**
@@ -88,6 +590,34 @@ protected:
  */
 void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session);
 
+/**
+ * @brief 运行 RPC 服务器（使用现有会话和工作线程池）
+ * @param key_expr Zenoh 键表达式，用于标识服务
+ * @param dispatcher 方法分发器引用
+ * @param session 现有的 Zenoh 会话引用
+ * @param executor 处理请求的执行器（由调用者拥有，可用于读取指标）
+ * 
+ * Zenoh 查询回调只负责把查询交给执行器，解码、方法分发、编码和回复
+ * 都在工作线程中完成，耗时的处理器不会阻塞其他请求。
+ * 当执行器拒绝任务（队列已满）时，服务器回复 -32000 "Server busy"。
+ */
+void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session, Executor& executor);
+
+/**
+ * @brief 运行 RPC 服务器（使用现有会话和服务器配置）
+ * @param key_expr Zenoh 键表达式，用于标识服务
+ * @param dispatcher 方法分发器引用
+ * @param session 现有的 Zenoh 会话引用
+ * @param options 服务器配置（执行器、批量请求并行度和大小限制）
+ * 
+ * 载荷为 JSON-RPC 批量数组时，服务器分发每个条目并以一个响应数组回复。
+ * batch_parallelism 大于1且设置了执行器时，批量条目被分块，在执行器的工作线程中并行分发。
+ * 服务器同时在同一键表达式上声明订阅者，执行 Client::notify 发布的通知。
+ * 
+ * 阻塞当前线程且不会返回；需要停止或与其他工作共用线程时请使用 Server。
+ */
+void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session, const ServerOptions& options);
+
 /**
  * @brief 运行 RPC 服务器（自动创建会话）
  * @param key_expr Zenoh 键表达式，用于标识服务
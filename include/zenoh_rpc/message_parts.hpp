@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "jsonrpc_proto.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file message_parts.hpp
+ * @brief 不构造 JSON 树的消息编码
+ * 
+ * make_request() 和 make_response_ok() 每次都新建一棵 JSON 树：对象本身、
+ * "jsonrpc"、"method"、"id" 等节点和字符串各分配一次，编码后立即丢弃。
+ * 客户端和服务器的热路径改为描述消息的各个部分（方法名、请求ID 和参数、结果的引用），
+ * 直接写入输出缓冲区，只有参数和结果本身经过 JSON 树：
+ * 
+ * @code
+ * json params = {1, 2};
+ * std::string out;
+ * encode_message_into(MessageParts::request("add", params, "7"), EncodingType::MSGPACK, out);
+ * // 与 encode_into(make_request("add", params, "7"), EncodingType::MSGPACK, out) 的字节相同
+ * @endcode
+ * 
+ * JSON、MessagePack 和二进制信封直接写入，输出与编码对应消息对象的结果逐字节相同；
+ * 其他编解码器默认先以 to_json() 构造消息对象（复制参数或结果）再编码，
+ * 可以覆盖 Codec::encode_message_into() 直接写入。
+ */
+
+/**
+ * @struct MessageParts
+ * @brief 单个 JSON-RPC 消息的组成部分
+ * 
+ * 字符串以视图、参数和结果以指针引用调用方的数据，编码完成前必须保持有效。
+ */
+struct MessageParts {
+    /**
+     * @enum Kind
+     * @brief 消息类型
+     */
+    enum class Kind : uint8_t {
+        REQUEST,        ///< 请求
+        NOTIFICATION,   ///< 通知
+        RESPONSE_OK,    ///< 成功响应
+        RESPONSE_ERR    ///< 错误响应
+    };
+    
+    Kind kind = Kind::REQUEST;              ///< 消息类型
+    std::string_view method;                ///< 方法名（请求和通知）
+    std::optional<uint32_t> method_id;      ///< 方法ID，设置时代替方法名
+    const json* params = nullptr;           ///< 参数；为空时没有 params 字段
+    std::string_view id;                    ///< 请求ID（通知没有）
+    const json* result = nullptr;           ///< 成功响应的结果
+    int code = 0;                           ///< 错误代码
+    std::string_view message;               ///< 错误消息
+    const json* data = nullptr;             ///< 错误附加数据；为空时没有 data 字段
+    
+    /**
+     * @brief 请求
+     * @param method 方法名
+     * @param params 方法参数
+     * @param id 请求ID
+     */
+    static MessageParts request(std::string_view method, const json& params, std::string_view id);
+    
+    /**
+     * @brief 通知
+     * @param method 方法名
+     * @param params 方法参数
+     */
+    static MessageParts notification(std::string_view method, const json& params);
+    
+    /**
+     * @brief 成功响应
+     * @param result 方法执行结果
+     * @param id 对应请求的ID
+     */
+    static MessageParts response_ok(const json& result, std::string_view id);
+    
+    /**
+     * @brief 错误响应
+     * @param code 错误代码
+     * @param message 错误消息
+     * @param id 对应请求的ID
+     * @param data 附加错误数据；为空指针、null 或空容器时省略（与 make_response_err() 一致）
+     */
+    static MessageParts response_err(int code, std::string_view message, std::string_view id,
+                                     const json* data = nullptr);
+    
+    /**
+     * @brief 构造等价的消息对象
+     * @return 与 make_request() 等函数结果相同的 JSON-RPC 消息（复制参数、结果和附加数据）
+     */
+    json to_json() const;
+};
+
+/**
+ * @brief 把消息的组成部分编码到调用方提供的缓冲区
+ * @param parts 消息的组成部分
+ * @param type 编码类型
+ * @param out 输出缓冲区（先清空，保留已有容量）
+ * @throws std::invalid_argument 当编码类型没有注册，或消息无法以这种编码表示时
+ * 
+ * JSON、MessagePack 和二进制信封直接写入，其他编码交给 Codec::encode_message_into()。
+ */
+void encode_message_into(const MessageParts& parts, EncodingType type, std::string& out);
+
+/**
+ * @brief 把消息的组成部分编码为新的字符串
+ * @param parts 消息的组成部分
+ * @param type 编码类型
+ * @return 编码后的字节
+ */
+std::string encode_message(const MessageParts& parts, EncodingType type);
+
+} // namespace zenoh_rpc
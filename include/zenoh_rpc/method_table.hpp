@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace zenoh_rpc {
+
+/**
+ * @file method_table.hpp
+ * @brief 发布的方法表使用的完美哈希索引
+ * 
+ * 分发器每次发布方法表时把全部方法名构建成一个完美哈希索引（hash-and-displace）：
+ * - 第一级按哈希值分桶，每个桶保存一个位移值
+ * - 第二级用哈希值和位移值计算槽位，不同方法名的槽位互不冲突
+ * 
+ * 查找只需计算一次方法名的哈希、读取两个数组元素并比较一次字符串，
+ * 以 std::string_view 查找，不构造 std::string，不分配内存。
+ */
+
+/**
+ * @class PerfectHashIndex
+ * @brief 不可变的字符串完美哈希索引
+ * 
+ * 构建后不能修改；find() 返回键在构造时传入的顺序中的位置。
+ * 多个线程可以同时查找。
+ */
+class PerfectHashIndex {
+public:
+    /// 查找失败时返回的位置
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    /// 创建空索引
+    PerfectHashIndex() = default;
+    
+    /**
+     * @brief 构建索引
+     * @param keys 互不相同的键
+     * @throws std::invalid_argument 当存在重复的键时
+     */
+    explicit PerfectHashIndex(std::vector<std::string> keys);
+    
+    /**
+     * @brief 查找键
+     * @param key 要查找的键
+     * @return 键的位置；不存在时返回 npos
+     */
+    size_t find(std::string_view key) const noexcept;
+    
+    /// 键的数量
+    size_t size() const noexcept { return keys_.size(); }
+    
+    /// 第 index 个键
+    const std::string& key(size_t index) const { return keys_[index]; }
+    
+    /// 槽位数量（用于观察装载率）
+    size_t slot_count() const noexcept { return slots_.size(); }
+
+private:
+    bool try_build(uint64_t seed);
+    uint64_t hash(std::string_view key) const noexcept;
+    
+    uint64_t seed_ = 0;                     ///< 哈希种子
+    uint64_t bucket_mask_ = 0;              ///< 桶数 - 1（桶数为2的幂）
+    uint64_t slot_mask_ = 0;                ///< 槽位数 - 1（槽位数为2的幂）
+    std::vector<uint32_t> displacements_;   ///< 每个桶的位移值
+    std::vector<uint32_t> slots_;           ///< 槽位到键位置的映射
+    std::vector<std::string> keys_;         ///< 键（按构造顺序）
+};
+
+/**
+ * @class ReadEpoch
+ * @brief 读多写少数据的宽限期跟踪（简化的 RCU）
+ * 
+ * 读者在 enter() 和 leave() 之间读取写者发布的指针，只修改所在分片的原子计数，不加锁、不阻塞；
+ * 线程按轮转分配到不同分片，多核同时分发时不争用同一缓存行。
+ * 写者替换指针后调用 synchronize()，返回时所有可能读到旧指针的读者都已离开，
+ * 旧数据可以释放。
+ * 
+ * 读者应只在 enter() 和 leave() 之间做短小的读取（例如查找并复制 shared_ptr），
+ * 不要在其中执行用户代码。synchronize() 需要由写者串行调用。
+ */
+class ReadEpoch {
+public:
+    /// 读者计数的分片数
+    static constexpr size_t kShards = 16;
+    
+    /**
+     * @brief 进入读临界区
+     * @return 传给 leave() 的计数器编号
+     */
+    unsigned enter() const noexcept;
+    
+    /**
+     * @brief 离开读临界区
+     * @param slot enter() 的返回值
+     */
+    void leave(unsigned slot) const noexcept;
+    
+    /**
+     * @brief 等待调用前进入的读者全部离开
+     */
+    void synchronize() noexcept;
+
+private:
+    /// 独占缓存行的读者计数
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> value{0};
+    };
+    
+    std::atomic<uint64_t> epoch_{0};           ///< 当前纪元（奇偶决定读者使用的一组计数器）
+    mutable Counter readers_[2][kShards];      ///< 两个纪元各自分片的读者计数
+};
+
+} // namespace zenoh_rpc
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <zenoh.hxx>
+#include <cstddef>
+#include <string>
+#include "jsonrpc_proto.hpp"
+#include "codec.hpp"
+#include "shm.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file payload.hpp
+ * @brief Zenoh 载荷的零拷贝访问
+ * 
+ * 本文件定义了直接在 zenoh::Bytes 上编解码 JSON-RPC 消息的工具：
+ * - 单分片载荷直接引用 Zenoh 的缓冲区，不发生复制
+ * - 多分片载荷按总长度一次性拼接（仅复制一次）
+ * - 编码写入可复用的池化缓冲区，缓冲区的所有权直接交给 zenoh::Bytes
+ * 
+ * 替代 get_payload().as_string() 加 decode() 以及 encode() 加 Bytes 的写法，
+ * 后者对每条消息至少复制或分配一次载荷。
+ * 
+ * 编码函数可以传入共享内存池（见 shm.hpp）：编码结果达到阈值时改为放入共享内存。
+ */
+
+/**
+ * @class PayloadView
+ * @brief zenoh::Bytes 的连续只读视图
+ * 
+ * 视图引用原始 zenoh::Bytes 的内存，生命周期不能超过它。
+ * 载荷由多个分片组成时，视图在内部持有一份拼接后的副本。
+ */
+class PayloadView {
+public:
+    /**
+     * @brief 构造载荷视图
+     * @param bytes Zenoh 载荷（必须比视图活得更久）
+     */
+    explicit PayloadView(const zenoh::Bytes& bytes);
+    
+    PayloadView(const PayloadView&) = delete;
+    PayloadView& operator=(const PayloadView&) = delete;
+    
+    /**
+     * @brief 获取载荷起始地址
+     * @return 连续载荷的起始地址
+     */
+    const char* data() const { return data_; }
+    
+    /**
+     * @brief 获取载荷字节数
+     * @return 载荷字节数
+     */
+    std::size_t size() const { return size_; }
+    
+    /**
+     * @brief 判断视图是否直接引用 Zenoh 缓冲区
+     * @return 如果载荷为单分片（未发生复制）则返回 true
+     */
+    bool is_zero_copy() const { return data_ != storage_.data(); }
+    
+    /**
+     * @brief 推测载荷的编码类型
+     * @return 推测的编码类型
+     */
+    EncodingType sniff() const { return sniff_encoding(data_, size_); }
+    
+    /**
+     * @brief 按指定编码类型解码载荷
+     * @param type 编码类型
+     * @return 解码后的 JSON 对象
+     * @throws ParseError 当解码失败时
+     */
+    json decode(EncodingType type) const { return zenoh_rpc::decode(data_, size_, type); }
+
+private:
+    std::string storage_;       ///< 多分片载荷的拼接副本
+    const char* data_ = "";     ///< 连续载荷起始地址
+    std::size_t size_ = 0;      ///< 载荷字节数
+};
+
+/**
+ * @brief 直接从 zenoh::Bytes 解码 JSON-RPC 消息
+ * @param bytes Zenoh 载荷
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ */
+json decode_payload(const zenoh::Bytes& bytes, EncodingType type);
+
+/**
+ * @brief 将 JSON-RPC 消息编码为 zenoh::Bytes
+ * @param message 要编码的消息
+ * @param type 编码类型
+ * @param shm 共享内存池（可以为空；编码结果达到阈值时复制到共享内存，堆缓冲区立即归还到池中）
+ * @return 持有编码结果的 zenoh::Bytes
+ * 
+ * 从全局缓冲区池取出一个 std::string 编码，再以自定义删除器交给 Zenoh，
+ * 不复制编码结果。Zenoh 释放载荷时缓冲区连同容量一起归还到池中，
+ * 稳定状态下编码不需要重新分配缓冲区。
+ * 缓冲区可能在 Zenoh 的线程中归还，因此池由互斥锁保护，线程安全。
+ */
+zenoh::Bytes encode_payload(const json& message, EncodingType type, const ShmPool* shm = nullptr);
+
+/**
+ * @brief 以指定的编解码器将 JSON-RPC 消息编码为 zenoh::Bytes
+ * @param message 要编码的消息
+ * @param codec 编解码器（通常在构造时解析一次并保存）
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ * 
+ * 与按编码类型编码相同，使用同一个缓冲区池，但不再按编码类型查找编解码器。
+ */
+zenoh::Bytes encode_payload(const json& message, const Codec& codec, const ShmPool* shm = nullptr);
+
+/**
+ * @brief 把消息的组成部分编码为 zenoh::Bytes
+ * @param parts 消息的组成部分（见 message_parts.hpp）
+ * @param type 编码类型
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ * 
+ * 使用同一个缓冲区池；JSON、MessagePack 和二进制信封不构造消息对象。
+ */
+zenoh::Bytes encode_payload(const MessageParts& parts, EncodingType type, const ShmPool* shm = nullptr);
+
+/**
+ * @brief 以指定的编解码器把消息的组成部分编码为 zenoh::Bytes
+ * @param parts 消息的组成部分
+ * @param codec 编解码器
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ */
+zenoh::Bytes encode_payload(const MessageParts& parts, const Codec& codec, const ShmPool* shm = nullptr);
+
+/**
+ * @brief 获取编码缓冲区池中空闲缓冲区的数量
+ * @return 空闲缓冲区数量
+ */
+std::size_t pooled_encode_buffers();
+
+} // namespace zenoh_rpc
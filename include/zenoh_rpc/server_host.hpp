@@ -0,0 +1,158 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "jsonrpc_server.hpp"
+#include "executor.hpp"
+#include "session.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file server_host.hpp
+ * @brief 多服务托管
+ * 
+ * 本文件定义了在一个 Zenoh 会话上托管多个 RPC 服务的 ServerHost：
+ * - 每个服务由一个键表达式（可以包含通配符）和一个分发器组成
+ * - 所有服务共享同一个会话和同一个工作线程池
+ * - 统一的启动、停止和指标汇总
+ * 
+ * 适用于把大量小服务合并到一个进程中，减少进程和 Zenoh 会话的开销。
+ */
+
+/**
+ * @struct ServerHostMetrics
+ * @brief 服务托管指标快照
+ */
+struct ServerHostMetrics {
+    ServerStats total;                              ///< 所有服务的计数器之和
+    std::map<std::string, ServerStats> services;    ///< 按键表达式划分的计数器
+    ExecutorMetrics executor;                       ///< 共享工作线程池的指标
+};
+
+/**
+ * @class ServerHost
+ * @brief 在一个会话上托管多个 RPC 服务
+ * 
+ * 每个服务内部是一个 Server，全部使用宿主的 ServerOptions 和执行器。
+ * 宿主运行时添加的服务立即开始服务。
+ * 
+ * 键表达式可以包含 Zenoh 通配符 * 和 **，一个服务即可应答一整组键。
+ * 服务的键表达式不能互相相交（例如一个服务的通配符键包含另一个服务的键），否则同一个查询会由多个服务应答，
+ * add_service() 拒绝这样的服务。
+ * 
+ * 使用示例：
+ * @code
+ * ServerHost host(session);
+ * host.add_service("services/math", math_dispatcher);
+ * host.add_service("services/echo", echo_dispatcher);
+ * host.start();
+ * host.wait();
+ * @endcode
+ * 
+ * 分发器和会话必须比宿主活得更久。
+ */
+class ServerHost {
+public:
+    /**
+     * @brief 创建服务宿主
+     * @param session 所有服务共享的 Zenoh 会话
+     * @param options 服务器配置；未指定执行器时宿主创建一个默认配置的执行器供所有服务共享
+     */
+    explicit ServerHost(Session& session, const ServerOptions& options = ServerOptions());
+    
+    /**
+     * @brief 析构函数
+     * 
+     * 按默认期限停止所有服务。
+     */
+    ~ServerHost();
+    
+    ServerHost(const ServerHost&) = delete;
+    ServerHost& operator=(const ServerHost&) = delete;
+    
+    /**
+     * @brief 添加服务
+     * @param key_expr 服务键表达式（可以包含通配符）
+     * @param dispatcher 方法分发器
+     * @throws std::invalid_argument 当键表达式已被托管，或与已托管的键表达式相交时
+     * 
+     * 宿主正在运行时立即声明并开始服务。
+     */
+    void add_service(const std::string& key_expr, DispatcherBase& dispatcher);
+    
+    /**
+     * @brief 移除服务
+     * @param key_expr 服务键表达式
+     * @param drain_timeout 等待该服务在途请求完成的最长时间
+     * @return 服务存在且其在途请求在期限内完成时返回 true
+     */
+    bool remove_service(const std::string& key_expr,
+                        std::chrono::milliseconds drain_timeout = std::chrono::seconds(5));
+    
+    /**
+     * @brief 启动所有服务
+     * @throws std::logic_error 当宿主已经在运行时
+     */
+    void start();
+    
+    /**
+     * @brief 停止所有服务
+     * @param drain_timeout 等待所有在途请求完成的总期限
+     * @return 所有服务的在途请求都在期限内完成时返回 true
+     */
+    bool stop(std::chrono::milliseconds drain_timeout = std::chrono::seconds(5));
+    
+    /**
+     * @brief 阻塞直到宿主被停止
+     */
+    void wait();
+    
+    /**
+     * @brief 宿主是否正在运行
+     * @return start() 之后、stop() 完成之前返回 true
+     */
+    bool is_running() const;
+    
+    /**
+     * @brief 获取托管的服务键表达式
+     * @return 按字典序排列的键表达式列表
+     */
+    std::vector<std::string> services() const;
+    
+    /**
+     * @brief 所有服务正在处理的查询和通知数
+     * @return 在途数量之和
+     */
+    size_t in_flight() const;
+    
+    /**
+     * @brief 获取指标快照
+     * @return 汇总计数器、每个服务的计数器和共享执行器指标
+     * 
+     * 已移除服务的计数器不再计入。
+     */
+    ServerHostMetrics metrics() const;
+    
+    /**
+     * @brief 获取共享的执行器
+     * @return 所有服务使用的执行器
+     */
+    Executor& executor() { return *options_.executor; }
+
+private:
+    Session& session_;                                      ///< 共享的 Zenoh 会话
+    ServerOptions options_;                                 ///< 所有服务使用的配置
+    std::unique_ptr<Executor> owned_executor_;              ///< 未指定执行器时宿主拥有的执行器
+    mutable std::mutex mutex_;                              ///< 保护 running_ 和 services_
+    std::condition_variable stopped_;                       ///< stop() 完成时通知 wait()
+    bool running_ = false;                                  ///< 宿主是否正在运行
+    std::map<std::string, std::unique_ptr<Server>> services_; ///< 键表达式到服务的映射
+};
+
+} // namespace zenoh_rpc
@@ -3,6 +3,9 @@
 #include <zenoh.hxx>
 #include <string>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace zenoh_rpc {
 
@@ -16,6 +19,7 @@ namespace zenoh_rpc {
  * - 连接端点配置
  * - 可查询对象（Queryable）的声明
  * - 查询器（Querier）的声明
+ * - 按键表达式缓存的发布者
  * - 底层 Zenoh 会话的访问接口
  */
 
@@ -144,6 +148,18 @@ public:
      */
     zenoh::Publisher declare_publisher(const std::string& key_expr);
     
+    /**
+     * @brief 获取缓存的发布者
+     * @param key_expr 键表达式，定义发布的主题
+     * @return 共享的发布者
+     * 
+     * 每个键表达式只声明一次发布者，之后的调用直接返回缓存的实例。
+     * 共享同一会话的多个客户端也共享这些发布者。线程安全。
+     * close() 清空缓存时，调用者持有的发布者仍然有效，最后一个持有者释放时才撤销声明；
+     * 会话关闭后的 put() 以 zenoh::ZException 失败。
+     */
+    std::shared_ptr<zenoh::Publisher> get_publisher(const std::string& key_expr);
+    
     /**
      * @brief 声明订阅者
      * @param key_expr 键表达式，定义订阅的主题
@@ -181,6 +197,10 @@ private:
     std::vector<std::string> connections_;
     /// 会话是否处于活动状态
     bool active_;
+    /// 保护发布者缓存
+    std::mutex publishers_mutex_;
+    /// 按键表达式缓存的发布者
+    std::unordered_map<std::string, std::shared_ptr<zenoh::Publisher>> publishers_;
 };
 
 } // namespace zenoh_rpc
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "session.hpp"
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace zenoh_rpc {
+
+/**
+ * @file session_pool.hpp
+ * @brief 进程级共享会话池
+ * 
+ * 本文件定义了按会话模式和连接端点共享 Zenoh 会话的注册表：
+ * - 相同模式和端点的客户端复用同一个会话，只付一次会话启动、scouting 和传输连接的代价
+ * - 会话按引用计数管理，最后一个使用者释放后自动关闭
+ * - 自动创建会话的 Client 构造函数默认从全局会话池获取会话，可以用 SessionSharing::PRIVATE 退出
+ */
+
+/**
+ * @enum SessionSharing
+ * @brief 自动创建会话时的共享方式
+ */
+enum class SessionSharing {
+    SHARED,  ///< 从全局会话池获取，与相同配置的其他客户端共享
+    PRIVATE  ///< 创建独占的新会话
+};
+
+/**
+ * @class SessionPool
+ * @brief 按模式和连接端点索引的引用计数会话池
+ * 
+ * 池中只保存会话的弱引用，会话的生命周期由 acquire() 返回的 shared_ptr 决定：
+ * 最后一个持有者释放后会话关闭，之后再次获取时重新打开。
+ * 连接端点按集合比较，顺序不同的相同端点列表共享同一个会话。
+ * 所有方法线程安全。
+ */
+class SessionPool {
+public:
+    /**
+     * @brief 获取进程级全局会话池
+     * @return 全局会话池引用
+     */
+    static SessionPool& global();
+    
+    /**
+     * @brief 获取使用默认配置的共享会话
+     * @return 共享会话
+     * 
+     * 等价于 Session() 创建的会话；与指定模式的会话互不共享。
+     */
+    std::shared_ptr<Session> acquire();
+    
+    /**
+     * @brief 获取指定模式和连接端点的共享会话
+     * @param mode 会话模式（client/peer/router）
+     * @param connections 连接端点列表
+     * @return 共享会话（池中没有可用会话时新建）
+     * @throws zenoh::ZException 新建会话失败时
+     */
+    std::shared_ptr<Session> acquire(SessionMode mode, const std::vector<std::string>& connections);
+    
+    /**
+     * @brief 获取池中仍在使用的会话数
+     * @return 至少有一个持有者的会话数
+     */
+    size_t size() const;
+
+private:
+    /**
+     * @brief 查找或创建会话
+     * @param key 会话键
+     * @param open 池中没有可用会话时创建会话的函数
+     */
+    template<typename Open>
+    std::shared_ptr<Session> acquire_keyed(const std::string& key, Open&& open);
+    
+    /**
+     * @struct Entry
+     * @brief 会话表条目
+     */
+    struct Entry {
+        std::weak_ptr<Session> session;                         ///< 已打开的会话
+        std::shared_future<std::shared_ptr<Session>> pending;    ///< 正在打开时有效，同一配置的其他获取等待它
+    };
+    
+    /// 保护会话表；打开会话时不持有
+    mutable std::mutex mutex_;
+    /// 会话键到条目的映射
+    std::unordered_map<std::string, Entry> sessions_;
+};
+
+} // namespace zenoh_rpc
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "jsonrpc_server.hpp"
+#include "executor.hpp"
+#include "session.hpp"
+
+namespace zenoh_rpc {
+
+/**
+ * @file sharded_server.hpp
+ * @brief 分片服务器
+ * 
+ * 本文件定义了把一个服务分散到多个分片上的 ShardedServer：
+ * - 每个分片在 "<key_expr>/@shard/<i>" 上声明自己的可查询对象
+ * - 每个分片有一个独占的工作线程，分片之间不共享队列
+ * - 分片可以共用一个会话，也可以各自打开会话，把 Zenoh 回调也分散到多个会话
+ * 
+ * 服务键表达式本身由分片 0 应答，所有回复都附带分片数。
+ * 普通的 Client 从第一个回复得知分片数后，把之后的调用轮流发往各分片，调用接口不变。
+ */
+
+/**
+ * @struct ShardedServerOptions
+ * @brief 分片服务器配置
+ */
+struct ShardedServerOptions {
+    size_t shards = std::thread::hardware_concurrency();  ///< 分片数（0 时使用 1）
+    size_t queue_capacity = 1024;                         ///< 每个分片工作线程的队列容量
+    OverflowPolicy overflow = OverflowPolicy::REJECT;     ///< 队列满时的处理策略
+    ServerOptions server;                                 ///< 批量请求和大小限制（执行器和分片数由分片服务器设置）
+};
+
+/// 分片会话的配置工厂：参数为分片序号，返回该分片会话的 Zenoh 配置
+using ShardConfigFactory = std::function<zenoh::Config(size_t shard)>;
+
+/**
+ * @class ShardedServer
+ * @brief 按分片处理请求的 RPC 服务器
+ * 
+ * 每个分片内部是一个使用单线程执行器的 Server。
+ * 分片 0 另外在服务键表达式上应答，负责尚不知道分片数的客户端和所有通知。
+ * 
+ * 使用示例：
+ * @code
+ * ShardedServerOptions options;
+ * options.shards = 8;
+ * ShardedServer server("example/service", dispatcher, [](size_t shard) {
+ *     zenoh::Config config = zenoh::Config::create_default();
+ *     config.insert_json5("listen/endpoints", "[\"tcp/0.0.0.0:" + std::to_string(7500 + shard) + "\"]");
+ *     return config;
+ * }, options);
+ * server.start();
+ * server.wait();
+ * @endcode
+ * 
+ * 分发器和传入的会话必须比分片服务器活得更久；分发器的处理器会被多个分片并发调用。
+ */
+class ShardedServer {
+public:
+    /**
+     * @brief 在一个会话上创建分片服务器
+     * @param key_expr 服务键表达式（不能包含通配符）
+     * @param dispatcher 方法分发器
+     * @param session 所有分片共用的 Zenoh 会话
+     * @param options 分片服务器配置
+     * @throws std::invalid_argument 当键表达式包含通配符时
+     * 
+     * 每个分片在同一个会话上声明可查询对象，只有处理请求的工作线程是独立的。
+     */
+    ShardedServer(const std::string& key_expr, DispatcherBase& dispatcher, Session& session,
+                  const ShardedServerOptions& options = ShardedServerOptions());
+    
+    /**
+     * @brief 为每个分片打开独立的会话
+     * @param key_expr 服务键表达式（不能包含通配符）
+     * @param dispatcher 方法分发器
+     * @param make_config 按分片序号创建会话配置
+     * @param options 分片服务器配置
+     * @throws std::invalid_argument 当键表达式包含通配符时
+     * @throws zenoh::ZException 打开会话失败时
+     * 
+     * 分片服务器拥有这些会话，析构时在停止所有分片后关闭。
+     */
+    ShardedServer(const std::string& key_expr, DispatcherBase& dispatcher, const ShardConfigFactory& make_config,
+                  const ShardedServerOptions& options = ShardedServerOptions());
+    
+    /**
+     * @brief 析构函数
+     * 
+     * 按默认期限停止所有分片。
+     */
+    ~ShardedServer();
+    
+    ShardedServer(const ShardedServer&) = delete;
+    ShardedServer& operator=(const ShardedServer&) = delete;
+    
+    /**
+     * @brief 启动所有分片
+     * @throws std::logic_error 当服务器已经在运行时
+     * 
+     * 某个分片声明失败时，已经启动的分片会被停止，服务器保持未运行状态。
+     */
+    void start();
+    
+    /**
+     * @brief 停止所有分片
+     * @param drain_timeout 等待所有在途请求完成的总期限
+     * @return 所有分片的在途请求都在期限内完成时返回 true
+     * 
+     * 先停止服务键表达式上的服务器，再依次停止各分片。
+     */
+    bool stop(std::chrono::milliseconds drain_timeout = std::chrono::seconds(5));
+    
+    /**
+     * @brief 阻塞直到服务器被停止
+     */
+    void wait();
+    
+    /**
+     * @brief 服务器是否正在运行
+     * @return start() 之后、stop() 完成之前返回 true
+     */
+    bool is_running() const;
+    
+    /**
+     * @brief 获取分片数
+     * @return 分片数
+     */
+    size_t shard_count() const { return shards_.size(); }
+    
+    /**
+     * @brief 获取服务的键表达式
+     * @return 键表达式
+     */
+    const std::string& key_expr() const { return key_expr_; }
+    
+    /**
+     * @brief 获取所有分片的计数器之和
+     * @return 计数器快照
+     */
+    ServerStats stats() const;
+    
+    /**
+     * @brief 获取每个分片的计数器
+     * @return 按分片序号排列的计数器快照（服务键表达式上的请求计入分片 0）
+     */
+    std::vector<ServerStats> shard_stats() const;
+    
+    /**
+     * @brief 所有分片正在处理的查询和通知数
+     * @return 在途数量之和
+     */
+    size_t in_flight() const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief 一个分片
+     */
+    struct Shard {
+        std::unique_ptr<Executor> executor;     ///< 分片独占的单线程执行器
+        std::unique_ptr<Server> server;         ///< 分片键表达式上的服务器
+    };
+    
+    /**
+     * @brief 创建各分片的执行器和服务器
+     * @param dispatcher 方法分发器
+     * @param options 分片服务器配置
+     */
+    void build(DispatcherBase& dispatcher, const ShardedServerOptions& options);
+    
+    std::string key_expr_;                              ///< 服务键表达式
+    std::vector<Session*> sessions_;                    ///< 各分片使用的会话（可以是同一个）
+    std::vector<std::unique_ptr<Session>> owned_sessions_; ///< 分片服务器打开的会话
+    std::vector<Shard> shards_;                         ///< 分片
+    std::unique_ptr<Server> front_;                     ///< 服务键表达式上的服务器（使用分片 0 的会话和执行器）
+    mutable std::mutex mutex_;                          ///< 保护 running_
+    std::condition_variable stopped_;                   ///< stop() 完成时通知 wait()
+    bool running_ = false;                              ///< 服务器是否正在运行
+};
+
+} // namespace zenoh_rpc
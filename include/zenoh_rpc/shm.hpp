@@ -0,0 +1,118 @@
+#pragma once
+
+#include <zenoh.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+/**
+ * @brief 是否支持共享内存载荷
+ * 
+ * 需要 zenoh-c 以 shared-memory 特性构建（定义 Z_FEATURE_SHARED_MEMORY），
+ * 并且以 Z_FEATURE_UNSTABLE_API 编译（CMake 选项 ZENOH_RPC_ENABLE_SHM）。
+ */
+#if defined(Z_FEATURE_SHARED_MEMORY) && defined(Z_FEATURE_UNSTABLE_API)
+#define ZENOH_RPC_HAS_SHM 1
+#else
+#define ZENOH_RPC_HAS_SHM 0
+#endif
+
+namespace zenoh_rpc {
+
+/**
+ * @file shm.hpp
+ * @brief 同机大载荷的共享内存路径
+ * 
+ * 本文件定义了客户端和服务器共用的共享内存池：
+ * - 基于 Zenoh 的 POSIX 共享内存提供者
+ * - 编码后不小于阈值的请求和回复放入共享内存，Zenoh 在同机会话之间只传递缓冲区句柄
+ * - 接收方的 PayloadView 直接指向共享内存，解码时不复制载荷
+ * - 共享内存池耗尽时回退到普通的堆缓冲区，调用不会因此失败或阻塞
+ * 
+ * 编码器先写入池化的堆缓冲区，再复制一次到共享内存；
+ * 省去的是 Zenoh 传输层和网络栈中的复制，接收方也不再需要重新组装载荷。
+ * 双方会话都需要开启 transport/shared_memory/enabled（Session(mode, connections) 在支持时自动开启）。
+ */
+
+/**
+ * @struct ShmOptions
+ * @brief 共享内存池配置
+ */
+struct ShmOptions {
+    size_t pool_size = 256u << 20;  ///< 共享内存池的总字节数
+    size_t threshold = 64u << 10;   ///< 编码后不小于此字节数的载荷放入共享内存
+};
+
+/**
+ * @struct ShmStats
+ * @brief 共享内存池计数器快照
+ */
+struct ShmStats {
+    uint64_t shm_payloads = 0;      ///< 放入共享内存的载荷数
+    uint64_t shm_bytes = 0;         ///< 放入共享内存的字节数
+    uint64_t heap_fallbacks = 0;    ///< 达到阈值但共享内存池已满、回退到堆缓冲区的载荷数
+};
+
+/**
+ * @class ShmPool
+ * @brief 共享内存载荷池
+ * 
+ * 通过 Client::set_shared_memory() 和 ServerOptions::shm 使用。
+ * 分配不会阻塞：池中没有足够的连续空间时先回收已释放的缓冲区并整理碎片，仍然失败就回退到堆缓冲区。
+ * 所有方法线程安全；池必须比使用它的客户端和服务器活得更久。
+ */
+class ShmPool {
+public:
+    /**
+     * @brief 是否以共享内存支持构建
+     * @return ZENOH_RPC_HAS_SHM 为 1 时返回 true
+     */
+    static bool supported();
+    
+    /**
+     * @brief 创建共享内存池
+     * @param options 共享内存池配置
+     * @throws std::runtime_error 当构建时没有共享内存支持时
+     * @throws zenoh::ZException 创建共享内存提供者失败时
+     */
+    explicit ShmPool(const ShmOptions& options = ShmOptions());
+    
+    /**
+     * @brief 析构函数
+     * 
+     * 已经交给 Zenoh 的缓冲区由 Zenoh 持有引用，在接收方释放后才回收。
+     */
+    ~ShmPool();
+    
+    ShmPool(const ShmPool&) = delete;
+    ShmPool& operator=(const ShmPool&) = delete;
+    
+    /**
+     * @brief 把编码后的载荷复制到共享内存
+     * @param data 载荷起始地址
+     * @param size 载荷字节数
+     * @return 持有共享内存缓冲区的载荷；小于阈值或共享内存池已满时返回空值
+     */
+    std::optional<zenoh::Bytes> try_copy(const char* data, size_t size) const;
+    
+    /**
+     * @brief 获取阈值
+     * @return 放入共享内存的最小字节数
+     */
+    size_t threshold() const { return options_.threshold; }
+    
+    /**
+     * @brief 获取计数器
+     * @return 计数器快照
+     */
+    ShmStats stats() const;
+
+private:
+    struct Impl;                    ///< 持有 Zenoh 共享内存提供者（只在支持时定义）
+    
+    ShmOptions options_;            ///< 共享内存池配置
+    std::unique_ptr<Impl> impl_;    ///< 共享内存提供者和计数器
+};
+
+} // namespace zenoh_rpc
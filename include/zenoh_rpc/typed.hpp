@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <nlohmann/json.hpp>
+#include "errors.hpp"
+
+namespace zenoh_rpc {
+
+using json = nlohmann::json;
+
+/**
+ * @file typed.hpp
+ * @brief 类型化的方法签名和参数转换
+ * 
+ * 本文件定义了类型化调用和注册使用的公共部分，包括：
+ * - 方法签名描述 Method<R(Args...)>（客户端和服务器共享）
+ * - 位置参数数组与 C++ 参数之间的转换
+ * - 方法结果与 C++ 类型之间的转换
+ * 
+ * 参数和结果通过 nlohmann::json 的 to_json/from_json 转换，
+ * 自定义类型只需提供这两个函数即可作为参数或结果使用。
+ * 
+ * 使用示例：
+ * @code
+ * // 在客户端和服务器共享的头文件中声明一次签名
+ * inline const zenoh_rpc::Method<double(double, double)> kAdd{"add"};
+ * 
+ * dispatcher.register_method(kAdd, [](double a, double b) { return a + b; });
+ * double sum = client.call(kAdd, 1, 2);   // 参数个数或类型不符时编译失败
+ * @endcode
+ */
+
+/**
+ * @class Method
+ * @brief 远程方法的类型化签名
+ * @tparam Signature 函数签名 R(Args...)
+ * 
+ * 只保存方法名，签名在编译期用于检查调用参数和处理函数。
+ */
+template<typename Signature>
+class Method;
+
+template<typename R, typename... Args>
+class Method<R(Args...)> {
+public:
+    using result_type = R;
+    static constexpr size_t arity = sizeof...(Args);
+    
+    /**
+     * @brief 构造函数
+     * @param name 方法名
+     */
+    explicit Method(std::string name) : name_(std::move(name)) {}
+    
+    /// 方法名
+    const std::string& name() const { return name_; }
+
+private:
+    std::string name_;
+};
+
+namespace detail {
+
+/**
+ * @struct ParamConverter
+ * @brief 把参数数组中的一个元素转换为处理函数的参数类型
+ * 
+ * 按值接收的参数通过 get<T>() 转换；以 const 引用接收字符串或 json 时
+ * 直接引用请求中的元素，不复制。
+ */
+template<typename T>
+struct ParamConverter {
+    using type = std::decay_t<T>;
+    static type convert(const json& value) { return value.get<type>(); }
+};
+
+template<>
+struct ParamConverter<const std::string&> {
+    using type = const std::string&;
+    static type convert(const json& value) { return value.get_ref<const std::string&>(); }
+};
+
+template<>
+struct ParamConverter<std::string_view> {
+    using type = std::string_view;
+    static type convert(const json& value) { return value.get_ref<const std::string&>(); }
+};
+
+template<>
+struct ParamConverter<const json&> {
+    using type = const json&;
+    static type convert(const json& value) { return value; }
+};
+
+/**
+ * @brief 转换第 index 个位置参数
+ * @throws InvalidParamsError 当参数类型不匹配时
+ */
+template<typename T>
+typename ParamConverter<T>::type convert_param(const json& params, size_t index) {
+    try {
+        return ParamConverter<T>::convert(params[index]);
+    } catch (const json::exception& e) {
+        throw InvalidParamsError("Invalid parameter " + std::to_string(index) + ": " + e.what());
+    }
+}
+
+template<typename R, typename... Args, typename F, size_t... I>
+json invoke_with_params(F& handler, const json& params, std::index_sequence<I...>) {
+    // 花括号初始化保证参数按从左到右的顺序转换
+    std::tuple<typename ParamConverter<Args>::type...> values{convert_param<Args>(params, I)...};
+    if constexpr (std::is_void_v<R>) {
+        std::apply(handler, std::move(values));
+        return nullptr;
+    } else {
+        return json(static_cast<R>(std::apply(handler, std::move(values))));
+    }
+}
+
+/**
+ * @brief 检查参数值是否一定无法转换为 T
+ * @param value 参数数组中的元素
+ * @param index 参数位置
+ * @return 一定无法转换时返回错误消息，否则为空
+ * 
+ * 只检查布尔值、数值和字符串的 JSON 类型，不抛出异常；
+ * 其他类型（以及数值类型收到布尔值时）由转换本身判断。
+ */
+template<typename T>
+std::string param_mismatch(const json& value, size_t index) {
+    using type = std::remove_cv_t<std::remove_reference_t<T>>;
+    const char* expected = nullptr;
+    if constexpr (std::is_same_v<type, bool>) {
+        expected = value.is_boolean() ? nullptr : "boolean";
+    } else if constexpr (std::is_arithmetic_v<type>) {
+        expected = value.is_number() || value.is_boolean() ? nullptr : "number";
+    } else if constexpr (std::is_same_v<type, std::string> || std::is_same_v<type, std::string_view>) {
+        expected = value.is_string() ? nullptr : "string";
+    }
+    if (!expected) {
+        return {};
+    }
+    return "Invalid parameter " + std::to_string(index) + ": expected " + expected + ", got " + value.type_name();
+}
+
+/**
+ * @brief 检查位置参数的个数和类型
+ * @tparam Args 参数类型
+ * @param params 请求参数
+ * @return 参数不符合签名时返回错误消息，否则为空
+ */
+template<typename... Args, size_t... I>
+std::string check_params(const json& params, std::index_sequence<I...>) {
+    constexpr size_t arity = sizeof...(Args);
+    if constexpr (arity == 0) {
+        return params.empty() ? std::string() : std::string("Expected no parameters");
+    } else {
+        if (!params.is_array() || params.size() != arity) {
+            return "Expected " + std::to_string(arity) + " positional parameters, got " +
+                   (params.is_array() ? std::to_string(params.size()) : std::string(params.type_name()));
+        }
+        // 在第一个不符的参数处停止
+        std::string message;
+        (void)((message = param_mismatch<Args>(params[I], I)).empty() && ...);
+        return message;
+    }
+}
+
+/**
+ * @brief 以位置参数调用类型化处理函数
+ * @tparam R 结果类型
+ * @tparam Args 参数类型
+ * @param handler 处理函数
+ * @param params 请求参数
+ * @return 转换为 JSON 的结果（void 方法为 null）
+ * @throws InvalidParamsError 当参数不是数组、个数不符或类型不匹配时
+ * 
+ * 无参数方法也接受空对象或缺省参数。
+ */
+template<typename R, typename... Args, typename F>
+json invoke_typed(F& handler, const json& params) {
+    std::string mismatch = check_params<Args...>(params, std::index_sequence_for<Args...>{});
+    if (!mismatch.empty()) {
+        throw InvalidParamsError(mismatch);
+    }
+    return invoke_with_params<R, Args...>(handler, params, std::index_sequence_for<Args...>{});
+}
+
+/**
+ * @brief 以位置参数调用类型化处理函数，参数不符时返回错误结果
+ * @return 转换为 JSON 的结果；参数个数或基本类型不符时为 -32602 错误结果，不抛出异常
+ * @throws InvalidParamsError 当自定义类型的参数转换失败时
+ * 
+ * 与 invoke_typed() 相同，但常见的参数错误（个数不符、数值或字符串类型不匹配）
+ * 不经过异常，适合参数校验失败频繁的方法。处理函数抛出的异常照常传播。
+ */
+template<typename R, typename... Args, typename F>
+RpcResult try_invoke_typed(F& handler, const json& params) {
+    std::string mismatch = check_params<Args...>(params, std::index_sequence_for<Args...>{});
+    if (!mismatch.empty()) {
+        return RpcResult::err(-32602, std::move(mismatch));
+    }
+    return RpcResult::ok(invoke_with_params<R, Args...>(handler, params, std::index_sequence_for<Args...>{}));
+}
+
+/**
+ * @brief 把调用参数打包成位置参数数组
+ * @param args 调用参数
+ * @return JSON 数组（无参数时为空数组）
+ */
+template<typename... Args>
+json pack_params(Args&&... args) {
+    json params = json::array();
+    params.get_ref<json::array_t&>().reserve(sizeof...(Args));
+    (params.push_back(json(std::forward<Args>(args))), ...);
+    return params;
+}
+
+/**
+ * @brief 把方法结果转换为调用者期望的类型
+ * @tparam R 结果类型
+ * @param result 方法结果
+ * @throws ParseError 当结果无法转换为 R 时
+ */
+template<typename R>
+R result_as(json&& result) {
+    if constexpr (std::is_void_v<R>) {
+        (void)result;
+    } else if constexpr (std::is_same_v<R, json>) {
+        return std::move(result);
+    } else if constexpr (std::is_same_v<R, std::string>) {
+        if (!result.is_string()) {
+            throw ParseError(std::string("Invalid result: expected string, got ") + result.type_name());
+        }
+        return std::move(result.get_ref<std::string&>());
+    } else {
+        try {
+            return result.get<R>();
+        } catch (const json::exception& e) {
+            throw ParseError(std::string("Invalid result: ") + e.what());
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace zenoh_rpc
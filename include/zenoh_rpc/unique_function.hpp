@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zenoh_rpc {
+
+/**
+ * @file unique_function.hpp
+ * @brief 带内联缓冲区的只移动可调用对象
+ * 
+ * 方法表中的处理函数使用 UniqueFunction 保存：
+ * - 捕获不超过 kInlineSize 字节的可调用对象直接存放在对象内部，不分配堆内存
+ * - 更大的可调用对象在构造时分配一次，调用时不再分配
+ * - 只能移动，可以保存只移动的捕获（例如 std::unique_ptr）
+ */
+
+template<typename Signature>
+class UniqueFunction;
+
+namespace detail {
+
+template<typename T>
+struct is_std_function : std::false_type {};
+
+template<typename Signature>
+struct is_std_function<std::function<Signature>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @class UniqueFunction
+ * @brief 只移动的类型擦除可调用对象
+ * @tparam R 返回类型
+ * @tparam Args 参数类型
+ * 
+ * 与 std::function 一样，operator() 为 const 但可以调用带有可变状态的可调用对象。
+ */
+template<typename R, typename... Args>
+class UniqueFunction<R(Args...)> {
+public:
+    /// 内联缓冲区大小（字节）
+    static constexpr size_t kInlineSize = 6 * sizeof(void*);
+    
+    UniqueFunction() noexcept = default;
+    
+    UniqueFunction(std::nullptr_t) noexcept {}
+    
+    /**
+     * @brief 从可调用对象构造
+     * @param f 可调用对象（函数指针、lambda、std::function 等）
+     * 
+     * 空的函数指针或 std::function 得到空的 UniqueFunction。
+     */
+    template<typename F, typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<D, UniqueFunction> &&
+                                         std::is_invocable_r_v<R, D&, Args...>>>
+    UniqueFunction(F&& f) {
+        if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D> || detail::is_std_function<D>::value) {
+            if (!f) {
+                return;
+            }
+        }
+        if constexpr (fits_inline<D>()) {
+            ::new (static_cast<void*>(&storage_)) D(std::forward<F>(f));
+            ops_ = &kInlineOps<D>;
+        } else {
+            *reinterpret_cast<D**>(&storage_) = new D(std::forward<F>(f));
+            ops_ = &kHeapOps<D>;
+        }
+    }
+    
+    UniqueFunction(UniqueFunction&& other) noexcept {
+        take(other);
+    }
+    
+    UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+    
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+    
+    ~UniqueFunction() {
+        reset();
+    }
+    
+    /// 是否保存了可调用对象
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+    
+    /**
+     * @brief 调用保存的可调用对象
+     * @throws std::bad_function_call 当对象为空时
+     */
+    R operator()(Args... args) const {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+        return ops_->invoke(const_cast<Storage*>(&storage_), std::forward<Args>(args)...);
+    }
+    
+    /// 可调用对象是否存放在内联缓冲区中（不占用堆内存）
+    bool is_inline() const noexcept { return ops_ != nullptr && ops_->is_inline; }
+
+private:
+    struct Storage {
+        alignas(std::max_align_t) unsigned char bytes[kInlineSize];
+    };
+    
+    struct Ops {
+        R (*invoke)(Storage*, Args&&...);
+        void (*move)(Storage* dst, Storage* src) noexcept;
+        void (*destroy)(Storage*) noexcept;
+        bool is_inline;
+    };
+    
+    template<typename D>
+    static constexpr bool fits_inline() {
+        return sizeof(D) <= kInlineSize && alignof(std::max_align_t) % alignof(D) == 0 &&
+               std::is_nothrow_move_constructible_v<D>;
+    }
+    
+    template<typename D>
+    static D* inline_target(Storage* storage) noexcept {
+        return std::launder(reinterpret_cast<D*>(storage));
+    }
+    
+    template<typename D>
+    static D*& heap_target(Storage* storage) noexcept {
+        return *reinterpret_cast<D**>(storage);
+    }
+    
+    template<typename D>
+    static inline const Ops kInlineOps = {
+        [](Storage* s, Args&&... args) -> R {
+            return std::invoke(*inline_target<D>(s), std::forward<Args>(args)...);
+        },
+        [](Storage* dst, Storage* src) noexcept {
+            ::new (static_cast<void*>(dst)) D(std::move(*inline_target<D>(src)));
+            inline_target<D>(src)->~D();
+        },
+        [](Storage* s) noexcept {
+            inline_target<D>(s)->~D();
+        },
+        true,
+    };
+    
+    template<typename D>
+    static inline const Ops kHeapOps = {
+        [](Storage* s, Args&&... args) -> R {
+            return std::invoke(*heap_target<D>(s), std::forward<Args>(args)...);
+        },
+        [](Storage* dst, Storage* src) noexcept {
+            heap_target<D>(dst) = heap_target<D>(src);
+        },
+        [](Storage* s) noexcept {
+            delete heap_target<D>(s);
+        },
+        false,
+    };
+    
+    void take(UniqueFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(&storage_, &other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+    
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+    
+    Storage storage_;
+    const Ops* ops_ = nullptr;
+};
+
+} // namespace zenoh_rpc
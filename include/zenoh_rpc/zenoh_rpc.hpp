@@ -12,7 +12,15 @@
  * - JSON-RPC 协议实现 (jsonrpc_proto.hpp)
  * - RPC 客户端 (jsonrpc_client.hpp)
  * - RPC 服务器 (jsonrpc_server.hpp)
+ * - 类型化方法签名 (typed.hpp)
+ * - 发布的方法表的完美哈希索引 (method_table.hpp)
+ * - 多服务托管 (server_host.hpp)
+ * - 分片服务器 (sharded_server.hpp)
+ * - 服务器工作线程池 (executor.hpp)
+ * - Zenoh 载荷零拷贝解码 (payload.hpp)
+ * - 不构造 JSON 树的消息编码 (message_parts.hpp)
  * - Zenoh 会话管理 (session.hpp)
+ * - 进程级共享会话池 (session_pool.hpp)
  * 
  * 使用示例：
  * @code
@@ -30,4 +38,17 @@
 #include "jsonrpc_proto.hpp"
 #include "jsonrpc_client.hpp"
 #include "jsonrpc_server.hpp"
-#include "session.hpp"
\ No newline at end of file
+#include "server_host.hpp"
+#include "sharded_server.hpp"
+#include "typed.hpp"
+#include "method_table.hpp"
+#include "unique_function.hpp"
+#include "executor.hpp"
+#include "payload.hpp"
+#include "envelope.hpp"
+#include "binary_envelope.hpp"
+#include "codec.hpp"
+#include "message_parts.hpp"
+#include "session.hpp"
+#include "session_pool.hpp"
+#include "shm.hpp"
\ No newline at end of file
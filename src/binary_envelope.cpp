@@ -0,0 +1,326 @@
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace zenoh_rpc {
+
+using namespace binary_format;
+
+namespace {
+
+/// 小端写入无符号整数
+template<typename T>
+void put_le(std::string& out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>(static_cast<uint8_t>(value >> (8 * i))));
+    }
+}
+
+/// 写入 u16 长度加字节
+void put_text(std::string& out, std::string_view text, const char* field) {
+    if (text.size() > std::numeric_limits<uint16_t>::max()) {
+        throw std::invalid_argument(std::string("Binary envelope ") + field + " longer than 65535 bytes");
+    }
+    put_le(out, static_cast<uint16_t>(text.size()));
+    out.append(text.data(), text.size());
+}
+
+/**
+ * @brief 把值以 MessagePack 追加到 out
+ * 
+ * 与 encode_msgpack_into 使用相同的写入器，但不清空 out。
+ */
+void put_msgpack(std::string& out, const json& value) {
+    json::to_msgpack(value, out);
+}
+
+/**
+ * @brief 把短字符串以 MessagePack 追加到 out（不构造 json 值）
+ * @param text 不超过 255 字节的字符串
+ */
+void put_msgpack_text(std::string& out, std::string_view text) {
+    if (text.size() <= 31) {
+        out.push_back(static_cast<char>(0xa0 | text.size()));
+    } else {
+        out.push_back(static_cast<char>(0xd9));
+        out.push_back(static_cast<char>(text.size()));
+    }
+    out.append(text.data(), text.size());
+}
+
+/**
+ * @brief 解析规范的十进制 id
+ * @param id 字符串 id
+ * @param value 解析出的值
+ * @return id 由十进制数字组成、没有前导零且可以放进 u64 时返回 true
+ * 
+ * 只有这样的 id 解码后能还原为同一个字符串。
+ */
+bool parse_numeric_id(std::string_view id, uint64_t& value) {
+    if (id.empty() || id.size() > 20 || (id.size() > 1 && id[0] == '0')) {
+        return false;
+    }
+    value = 0;
+    for (char c : id) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+        if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+/**
+ * @brief 写入固定头部
+ * @param out 输出缓冲区（追加）
+ * @param kind 消息类型
+ * @param id 请求ID（通知忽略）
+ * @param method 方法名（只有请求和通知；设置 method_id 时忽略）
+ * @param method_id 方法ID
+ */
+void put_header(std::string& out, Kind kind, std::string_view id, std::string_view method,
+                std::optional<uint32_t> method_id) {
+    uint8_t flags = kind;
+    uint64_t numeric_id = 0;
+    if (kind != NOTIFICATION && !parse_numeric_id(id, numeric_id)) {
+        flags |= kTextId;
+    }
+    bool has_method = kind == REQUEST || kind == NOTIFICATION;
+    if (has_method && method_id) {
+        flags |= kMethodId;
+    }
+    
+    out.push_back(static_cast<char>(kMagic));
+    out.push_back(static_cast<char>(kVersion));
+    out.push_back(static_cast<char>(flags));
+    if (kind != NOTIFICATION) {
+        if (flags & kTextId) {
+            put_text(out, id, "id");
+        } else {
+            put_le(out, numeric_id);
+        }
+    }
+    if (flags & kMethodId) {
+        put_le(out, *method_id);
+    } else if (has_method) {
+        put_text(out, method, "method");
+    }
+}
+
+/**
+ * @brief 编码单个消息
+ * @param message JSON-RPC 消息对象
+ * @param out 输出缓冲区（追加）
+ */
+void encode_entry(const json& message, std::string& out) {
+    if (!message.is_object()) {
+        throw std::invalid_argument("Binary envelope requires JSON-RPC message objects");
+    }
+    auto method = message.find("method");
+    auto id = message.find("id");
+    auto error = message.find("error");
+    auto result = message.find("result");
+    
+    Kind kind;
+    std::string_view method_name;
+    std::optional<uint32_t> method_id;
+    if (method != message.end()) {
+        kind = id == message.end() ? NOTIFICATION : REQUEST;
+        if (method->is_number_integer()) {
+            int64_t value = method->get<int64_t>();
+            if (value < 0 || value > std::numeric_limits<uint32_t>::max()) {
+                throw std::invalid_argument("Binary envelope method id must fit in 32 bits");
+            }
+            method_id = static_cast<uint32_t>(value);
+        } else if (method->is_string()) {
+            method_name = method->get_ref<const std::string&>();
+        } else {
+            throw std::invalid_argument("Binary envelope method must be a string or a method id");
+        }
+    } else if (error != message.end()) {
+        kind = RESPONSE_ERR;
+        if (!error->is_object() || !error->contains("code") || !(*error)["code"].is_number_integer()) {
+            throw std::invalid_argument("Binary envelope error must have an integer code");
+        }
+    } else if (result != message.end()) {
+        kind = RESPONSE_OK;
+    } else {
+        throw std::invalid_argument("Binary envelope requires a method, result or error");
+    }
+    
+    if (kind != NOTIFICATION && !id->is_string()) {
+        throw std::invalid_argument("Binary envelope id must be a string");
+    }
+    put_header(out, kind, kind != NOTIFICATION ? std::string_view(id->get_ref<const std::string&>()) : std::string_view(),
+               method_name, method_id);
+    
+    // MessagePack 主体
+    switch (kind) {
+        case REQUEST:
+        case NOTIFICATION: {
+            auto params = message.find("params");
+            if (params != message.end()) {
+                put_msgpack(out, *params);
+            }
+            break;
+        }
+        case RESPONSE_OK:
+            put_msgpack(out, *result);
+            break;
+        default: {
+            put_le(out, static_cast<uint32_t>(static_cast<int32_t>((*error)["code"].get<int64_t>())));
+            // 错误代码已经在头部，主体只包含 message 和 data
+            auto text = error->find("message");
+            auto data = error->find("data");
+            uint8_t members = (text != error->end() ? 1 : 0) + (data != error->end() ? 1 : 0);
+            out.push_back(static_cast<char>(0x80 | members));
+            if (text != error->end()) {
+                put_msgpack_text(out, "message");
+                put_msgpack(out, *text);
+            }
+            if (data != error->end()) {
+                put_msgpack_text(out, "data");
+                put_msgpack(out, *data);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 把扫描得到的信封还原为 JSON-RPC 消息对象
+ */
+json to_message(const Envelope& envelope) {
+    json message = {{"jsonrpc", "2.0"}};
+    if (envelope.method_kind == ValueKind::STRING) {
+        message["method"] = envelope.method;
+    } else if (envelope.method_kind == ValueKind::NUMBER) {
+        message["method"] = envelope.method_id;
+    }
+    if (envelope.params_kind != ValueKind::ABSENT) {
+        message["params"] = envelope.parse_params();
+    }
+    if (envelope.result_kind != ValueKind::ABSENT) {
+        message["result"] = envelope.parse_result();
+    }
+    if (envelope.error_kind != ValueKind::ABSENT) {
+        message["error"] = envelope.parse_error();
+    }
+    if (envelope.id_kind == ValueKind::STRING) {
+        message["id"] = envelope.id;
+    }
+    return message;
+}
+
+} // namespace
+
+/**
+ * @brief 把 JSON-RPC 消息编码为二进制信封
+ * @param message 请求、通知、响应或批量数组
+ * @param out 输出缓冲区
+ * 
+ * 批量条目先写入长度占位，编码完成后回填。
+ */
+void encode_binary_into(const json& message, std::string& out) {
+    out.clear();
+    if (!message.is_array()) {
+        encode_entry(message, out);
+        return;
+    }
+    
+    out.push_back(static_cast<char>(kMagic));
+    out.push_back(static_cast<char>(kVersion));
+    out.push_back(static_cast<char>(kBatch));
+    put_le(out, static_cast<uint32_t>(message.size()));
+    for (const auto& entry : message) {
+        std::size_t length_at = out.size();
+        put_le(out, uint32_t{0});
+        encode_entry(entry, out);
+        uint32_t length = static_cast<uint32_t>(out.size() - length_at - 4);
+        for (std::size_t i = 0; i < 4; ++i) {
+            out[length_at + i] = static_cast<char>(static_cast<uint8_t>(length >> (8 * i)));
+        }
+    }
+}
+
+/**
+ * @brief 把消息的组成部分编码为二进制信封
+ * @param parts 消息的组成部分
+ * @param out 输出缓冲区
+ * 
+ * 与编码 parts.to_json() 的结果相同，但不构造消息对象。
+ */
+void encode_binary_into(const MessageParts& parts, std::string& out) {
+    using PartKind = MessageParts::Kind;
+    static constexpr Kind kinds[] = {REQUEST, NOTIFICATION, RESPONSE_OK, RESPONSE_ERR};
+    Kind kind = kinds[static_cast<uint8_t>(parts.kind)];
+    
+    out.clear();
+    put_header(out, kind, parts.id, parts.method, parts.method_id);
+    switch (parts.kind) {
+        case PartKind::REQUEST:
+        case PartKind::NOTIFICATION:
+            if (parts.params) {
+                put_msgpack(out, *parts.params);
+            }
+            break;
+        case PartKind::RESPONSE_OK:
+            put_msgpack(out, *parts.result);
+            break;
+        case PartKind::RESPONSE_ERR: {
+            put_le(out, static_cast<uint32_t>(static_cast<int32_t>(parts.code)));
+            out.push_back(static_cast<char>(0x80 | (parts.data ? 2 : 1)));
+            put_msgpack_text(out, "message");
+            if (parts.message.size() <= 0xff) {
+                put_msgpack_text(out, parts.message);
+            } else {
+                put_msgpack(out, std::string(parts.message));
+            }
+            if (parts.data) {
+                put_msgpack_text(out, "data");
+                put_msgpack(out, *parts.data);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 把 JSON-RPC 消息编码为二进制信封
+ * @param message 要编码的消息
+ * @return 编码后的字节
+ */
+std::string encode_binary(const json& message) {
+    std::string out;
+    encode_binary_into(message, out);
+    return out;
+}
+
+/**
+ * @brief 把二进制信封解码为 JSON-RPC 消息
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @return JSON-RPC 消息
+ * 
+ * 先扫描头部，再逐个解析参数、结果和错误对象。
+ */
+json decode_binary(const char* data, std::size_t size) {
+    ScannedMessage scanned = scan_message(data, size, EncodingType::BINARY);
+    if (!scanned.is_batch) {
+        return to_message(scanned.entries.front());
+    }
+    json batch = json::array();
+    for (const auto& entry : scanned.entries) {
+        batch.push_back(to_message(entry));
+    }
+    return batch;
+}
+
+} // namespace zenoh_rpc
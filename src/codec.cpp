@@ -0,0 +1,243 @@
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <stdexcept>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/**
+ * @brief 以 nlohmann 的二进制读取器解码，错误转换为 ParseError
+ * @param format 格式名称（用于错误消息）
+ * @param fn 接收字节区间并返回 json 的读取函数
+ */
+template<typename Fn>
+json read_binary(const char* format, const char* data, std::size_t size, Fn&& fn) {
+    try {
+        const auto* first = reinterpret_cast<const std::uint8_t*>(data);
+        return fn(first, first + size);
+    } catch (const json::exception& e) {
+        throw ParseError(std::string("Failed to parse ") + format + ": " + e.what());
+    }
+}
+
+/// JSON
+class JsonCodec : public Codec {
+public:
+    JsonCodec() : Codec(EncodingType::JSON, "json", "application/json") {}
+    
+    void encode_into(const json& message, std::string& out) const override { encode_json_into(message, out); }
+    void encode_message_into(const MessageParts& parts, std::string& out) const override {
+        zenoh_rpc::encode_message_into(parts, type(), out);
+    }
+    json decode(const char* data, std::size_t size) const override { return decode_json(data, size); }
+};
+
+/// MessagePack
+class MsgpackCodec : public Codec {
+public:
+    MsgpackCodec() : Codec(EncodingType::MSGPACK, "msgpack", "application/msgpack") {}
+    
+    void encode_into(const json& message, std::string& out) const override { encode_msgpack_into(message, out); }
+    void encode_message_into(const MessageParts& parts, std::string& out) const override {
+        zenoh_rpc::encode_message_into(parts, type(), out);
+    }
+    json decode(const char* data, std::size_t size) const override { return decode_msgpack(data, size); }
+};
+
+/// 二进制信封
+class BinaryCodec : public Codec {
+public:
+    BinaryCodec() : Codec(EncodingType::BINARY, "binary", "application/x-zenoh-rpc-binary") {}
+    
+    void encode_into(const json& message, std::string& out) const override { encode_binary_into(message, out); }
+    void encode_message_into(const MessageParts& parts, std::string& out) const override {
+        zenoh_rpc::encode_message_into(parts, type(), out);
+    }
+    json decode(const char* data, std::size_t size) const override { return decode_binary(data, size); }
+};
+
+/// CBOR
+class CborCodec : public Codec {
+public:
+    CborCodec() : Codec(EncodingType::CBOR, "cbor", "application/cbor") {}
+    
+    void encode_into(const json& message, std::string& out) const override {
+        out.clear();
+        json::to_cbor(message, out);
+    }
+    
+    json decode(const char* data, std::size_t size) const override {
+        return read_binary("CBOR", data, size, [](auto first, auto last) { return json::from_cbor(first, last); });
+    }
+};
+
+/// UBJSON（带长度前缀的容器，不使用强类型数组）
+class UbjsonCodec : public Codec {
+public:
+    UbjsonCodec() : Codec(EncodingType::UBJSON, "ubjson", "application/ubjson") {}
+    
+    void encode_into(const json& message, std::string& out) const override {
+        out.clear();
+        json::to_ubjson(message, out, true, false);
+    }
+    
+    json decode(const char* data, std::size_t size) const override {
+        return read_binary("UBJSON", data, size, [](auto first, auto last) { return json::from_ubjson(first, last); });
+    }
+};
+
+/**
+ * BSON
+ * 
+ * BSON 的顶层只能是文档，批量数组包装为 {"batch": [...]}，解码时还原。
+ * JSON-RPC 消息对象不会只有一个 "batch" 键，两者不会混淆。
+ */
+class BsonCodec : public Codec {
+public:
+    BsonCodec() : Codec(EncodingType::BSON, "bson", "application/bson") {}
+    
+    void encode_into(const json& message, std::string& out) const override {
+        if (message.is_object()) {
+            out.clear();
+            json::to_bson(message, out);
+        } else if (message.is_array()) {
+            out.clear();
+            json::to_bson(json{{kBatchKey, message}}, out);
+        } else {
+            throw std::invalid_argument("BSON requires a JSON-RPC message object or batch array");
+        }
+    }
+    
+    json decode(const char* data, std::size_t size) const override {
+        json message = read_binary("BSON", data, size, [](auto first, auto last) { return json::from_bson(first, last); });
+        if (message.size() == 1) {
+            auto batch = message.find(kBatchKey);
+            if (batch != message.end() && batch->is_array()) {
+                return std::move(*batch);
+            }
+        }
+        return message;
+    }
+
+private:
+    static constexpr const char* kBatchKey = "batch";
+};
+
+} // namespace
+
+/**
+ * @brief 全局注册表
+ */
+CodecRegistry& CodecRegistry::instance() {
+    static CodecRegistry registry;
+    return registry;
+}
+
+/**
+ * @brief 构造函数：注册内置编解码器
+ */
+CodecRegistry::CodecRegistry() {
+    add(std::make_shared<JsonCodec>());
+    add(std::make_shared<MsgpackCodec>());
+    add(std::make_shared<BinaryCodec>());
+    add(std::make_shared<CborCodec>());
+    add(std::make_shared<UbjsonCodec>());
+    add(std::make_shared<BsonCodec>());
+}
+
+/**
+ * @brief 当前使用的编解码器
+ * 
+ * 被替换的编解码器仍在 codecs_ 中，但不再参与按名称和 MIME 类型查找。
+ */
+std::vector<const Codec*> CodecRegistry::active_locked() const {
+    std::vector<const Codec*> active;
+    for (const auto& codec : codecs_) {
+        if (find(codec->type()) == codec.get()) {
+            active.push_back(codec.get());
+        }
+    }
+    return active;
+}
+
+/**
+ * @brief 注册编解码器
+ * @param codec 编解码器
+ */
+void CodecRegistry::add(std::shared_ptr<const Codec> codec) {
+    if (!codec) {
+        throw std::invalid_argument("Codec must not be null");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Codec* other : active_locked()) {
+        if (other->type() == codec->type()) {
+            continue;
+        }
+        if (other->name() == codec->name() || mime_base(other->mime()) == mime_base(codec->mime())) {
+            throw std::invalid_argument("Codec '" + codec->name() + "' conflicts with registered codec '" + other->name() + "'");
+        }
+    }
+    codecs_.push_back(codec);
+    by_type_[static_cast<uint8_t>(codec->type())].store(codec.get(), std::memory_order_release);
+}
+
+/**
+ * @brief 按名称查找
+ * @param name 编码名称
+ * @return 编解码器；没有注册时为 nullptr
+ */
+const Codec* CodecRegistry::find(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Codec* codec : active_locked()) {
+        if (codec->name() == name) {
+            return codec;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 按 MIME 类型查找
+ * @param mime MIME 类型
+ * @return 编解码器；没有注册时为 nullptr
+ */
+const Codec* CodecRegistry::find_mime(const std::string& mime) const {
+    std::string base = mime_base(mime);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Codec* codec : active_locked()) {
+        if (mime_base(codec->mime()) == base) {
+            return codec;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 已注册的编码名称
+ */
+std::vector<std::string> CodecRegistry::names() const {
+    std::vector<std::string> names;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Codec* codec : active_locked()) {
+        names.push_back(codec->name());
+    }
+    return names;
+}
+
+/**
+ * @brief 按编码类型获取编解码器
+ * @param type 编码类型
+ * @return 编解码器
+ * @throws std::invalid_argument 当编码类型没有注册时
+ */
+const Codec& codec_for(EncodingType type) {
+    const Codec* codec = CodecRegistry::instance().find(type);
+    if (!codec) {
+        throw std::invalid_argument("Unsupported encoding type");
+    }
+    return *codec;
+}
+
+} // namespace zenoh_rpc
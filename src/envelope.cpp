@@ -0,0 +1,849 @@
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <cctype>
+#include <string>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/// 嵌套的最大深度（防止恶意载荷耗尽栈空间）
+constexpr int kMaxDepth = 512;
+
+/**
+ * @struct RawValue
+ * @brief 扫描到的一个值：类型和原始字节
+ */
+struct RawValue {
+    ValueKind kind;
+    std::string_view raw;
+};
+
+/**
+ * @brief 把一个对象成员记录到信封中
+ * @param envelope 信封
+ * @param key 成员的键
+ * @param value 成员的值
+ * @param decode_string 把字符串值的原始字节解码为 std::string 的函数
+ */
+template<typename DecodeString>
+void assign_member(Envelope& envelope, std::string_view key, const RawValue& value, DecodeString decode_string) {
+    if (key == "jsonrpc") {
+        envelope.version_ok = value.kind == ValueKind::STRING && decode_string(value.raw) == "2.0";
+    } else if (key == "method") {
+        envelope.method_kind = value.kind;
+        envelope.method = value.kind == ValueKind::STRING ? decode_string(value.raw) : std::string();
+    } else if (key == "id") {
+        envelope.id_kind = value.kind;
+        envelope.id = value.kind == ValueKind::STRING ? decode_string(value.raw) : std::string();
+    } else if (key == "params") {
+        envelope.params_kind = value.kind;
+        envelope.params = value.raw;
+    } else if (key == "result") {
+        envelope.result_kind = value.kind;
+        envelope.result = value.raw;
+    } else if (key == "error") {
+        envelope.error_kind = value.kind;
+        envelope.error = value.raw;
+    }
+}
+
+/**
+ * @class JsonScanner
+ * @brief JSON 载荷的单遍扫描器
+ * 
+ * 按 RFC 8259 的语法检查结构、字面量、数字和字符串转义；
+ * 字符串内容的 UTF-8 有效性在真正解析该值时由 nlohmann::json 检查。
+ */
+class JsonScanner {
+public:
+    JsonScanner(const char* data, std::size_t size) : begin_(data), p_(data), end_(data + size) {}
+    
+    /**
+     * @brief 扫描整个载荷
+     */
+    ScannedMessage scan() {
+        ScannedMessage message;
+        skip_ws();
+        if (peek() == '[') {
+            message.is_batch = true;
+            ++p_;
+            skip_ws();
+            if (peek() == ']') {
+                ++p_;
+            } else {
+                for (;;) {
+                    skip_ws();
+                    message.entries.push_back(scan_entry(2));
+                    skip_ws();
+                    if (peek() == ',') {
+                        ++p_;
+                    } else if (peek() == ']') {
+                        ++p_;
+                        break;
+                    } else {
+                        fail("expected ',' or ']'");
+                    }
+                }
+            }
+        } else {
+            message.entries.push_back(scan_entry(1));
+        }
+        skip_ws();
+        if (p_ != end_) {
+            fail("unexpected trailing characters");
+        }
+        return message;
+    }
+    
+    /**
+     * @brief 解码字符串值（原始字节包含引号）
+     * 
+     * 没有转义字符时直接截取，有转义时交给 nlohmann::json 解码。
+     */
+    static std::string decode_string(std::string_view raw) {
+        std::string_view content = raw.substr(1, raw.size() - 2);
+        if (content.find('\\') == std::string_view::npos) {
+            return std::string(content);
+        }
+        try {
+            return json::parse(raw.begin(), raw.end()).get<std::string>();
+        } catch (const json::exception& e) {
+            throw ParseError("Failed to parse JSON: " + std::string(e.what()));
+        }
+    }
+
+private:
+    /**
+     * @brief 扫描一个顶层值或批量条目：对象记录信封字段，其他值只检查语法
+     */
+    Envelope scan_entry(int depth) {
+        Envelope envelope;
+        envelope.encoding = EncodingType::JSON;
+        if (peek() != '{') {
+            skip_value(depth);
+            return envelope;
+        }
+        envelope.is_object = true;
+        ++p_;
+        skip_ws();
+        if (peek() == '}') {
+            ++p_;
+            return envelope;
+        }
+        for (;;) {
+            skip_ws();
+            std::string_view key_raw = string_token();
+            skip_ws();
+            expect(':');
+            skip_ws();
+            RawValue value = scan_value(depth + 1);
+            std::string_view key = key_raw.substr(1, key_raw.size() - 2);
+            if (key.find('\\') == std::string_view::npos) {
+                assign_member(envelope, key, value, decode_string);
+            } else {
+                assign_member(envelope, decode_string(key_raw), value, decode_string);
+            }
+            skip_ws();
+            if (peek() == ',') {
+                ++p_;
+            } else if (peek() == '}') {
+                ++p_;
+                return envelope;
+            } else {
+                fail("expected ',' or '}'");
+            }
+        }
+    }
+    
+    /**
+     * @brief 扫描一个值并返回它的类型和原始字节
+     */
+    RawValue scan_value(int depth) {
+        const char* start = p_;
+        ValueKind kind = kind_of(peek());
+        skip_value(depth);
+        return RawValue{kind, std::string_view(start, static_cast<std::size_t>(p_ - start))};
+    }
+    
+    static ValueKind kind_of(int c) {
+        switch (c) {
+            case '{': return ValueKind::OBJECT;
+            case '[': return ValueKind::ARRAY;
+            case '"': return ValueKind::STRING;
+            case 't':
+            case 'f': return ValueKind::BOOLEAN;
+            case 'n': return ValueKind::NULL_VALUE;
+            default: return ValueKind::NUMBER;
+        }
+    }
+    
+    /**
+     * @brief 跳过一个值（检查语法）
+     */
+    void skip_value(int depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        switch (peek()) {
+            case '{':
+                skip_container('}', true, depth);
+                break;
+            case '[':
+                skip_container(']', false, depth);
+                break;
+            case '"':
+                string_token();
+                break;
+            case 't':
+                literal("true");
+                break;
+            case 'f':
+                literal("false");
+                break;
+            case 'n':
+                literal("null");
+                break;
+            default:
+                number();
+                break;
+        }
+    }
+    
+    void skip_container(char close, bool is_object, int depth) {
+        ++p_;
+        skip_ws();
+        if (peek() == close) {
+            ++p_;
+            return;
+        }
+        for (;;) {
+            skip_ws();
+            if (is_object) {
+                string_token();
+                skip_ws();
+                expect(':');
+                skip_ws();
+            }
+            skip_value(depth + 1);
+            skip_ws();
+            if (peek() == ',') {
+                ++p_;
+            } else if (peek() == close) {
+                ++p_;
+                return;
+            } else {
+                fail(is_object ? "expected ',' or '}'" : "expected ',' or ']'");
+            }
+        }
+    }
+    
+    /**
+     * @brief 扫描字符串，返回包含引号的原始字节
+     */
+    std::string_view string_token() {
+        const char* start = p_;
+        expect('"');
+        for (;;) {
+            if (p_ == end_) {
+                fail("unterminated string");
+            }
+            unsigned char c = static_cast<unsigned char>(*p_++);
+            if (c == '"') {
+                break;
+            }
+            if (c < 0x20) {
+                fail("control character in string");
+            }
+            if (c == '\\') {
+                if (p_ == end_) {
+                    fail("unterminated string");
+                }
+                char escape = *p_++;
+                if (escape == 'u') {
+                    for (int i = 0; i < 4; ++i) {
+                        if (p_ == end_ || !std::isxdigit(static_cast<unsigned char>(*p_))) {
+                            fail("invalid \\u escape");
+                        }
+                        ++p_;
+                    }
+                } else if (std::string_view("\"\\/bfnrt").find(escape) == std::string_view::npos) {
+                    fail("invalid escape");
+                }
+            }
+        }
+        return std::string_view(start, static_cast<std::size_t>(p_ - start));
+    }
+    
+    void number() {
+        if (peek() == '-') {
+            ++p_;
+        }
+        if (peek() == '0') {
+            ++p_;
+        } else if (is_digit(peek())) {
+            skip_digits();
+        } else {
+            fail("invalid value");
+        }
+        if (peek() == '.') {
+            ++p_;
+            if (!is_digit(peek())) {
+                fail("invalid number");
+            }
+            skip_digits();
+        }
+        if (peek() == 'e' || peek() == 'E') {
+            ++p_;
+            if (peek() == '+' || peek() == '-') {
+                ++p_;
+            }
+            if (!is_digit(peek())) {
+                fail("invalid number");
+            }
+            skip_digits();
+        }
+    }
+    
+    void literal(std::string_view word) {
+        if (static_cast<std::size_t>(end_ - p_) < word.size() || std::string_view(p_, word.size()) != word) {
+            fail("invalid literal");
+        }
+        p_ += word.size();
+    }
+    
+    static bool is_digit(int c) { return c >= '0' && c <= '9'; }
+    
+    void skip_digits() {
+        while (is_digit(peek())) {
+            ++p_;
+        }
+    }
+    
+    void skip_ws() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+    
+    /// 当前字符；到达末尾时为 -1
+    int peek() const { return p_ != end_ ? static_cast<unsigned char>(*p_) : -1; }
+    
+    void expect(char c) {
+        if (peek() != static_cast<unsigned char>(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++p_;
+    }
+    
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw ParseError("Failed to parse JSON: " + reason + " at byte " + std::to_string(p_ - begin_));
+    }
+    
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+};
+
+/**
+ * @class MsgpackScanner
+ * @brief MessagePack 载荷的单遍扫描器
+ * 
+ * 按类型标记和长度跳过值，检查所有长度都不越界。
+ */
+class MsgpackScanner {
+public:
+    MsgpackScanner(const char* data, std::size_t size)
+        : begin_(reinterpret_cast<const uint8_t*>(data)), p_(begin_), end_(begin_ + size) {}
+    
+    /**
+     * @brief 扫描整个载荷
+     */
+    ScannedMessage scan() {
+        ScannedMessage message;
+        Header header = read_header();
+        if (header.kind == ValueKind::ARRAY) {
+            message.is_batch = true;
+            for (uint64_t i = 0; i < header.length; ++i) {
+                message.entries.push_back(scan_entry(2));
+            }
+        } else {
+            message.entries.push_back(scan_entry_after(header, 1));
+        }
+        if (p_ != end_) {
+            fail("unexpected trailing bytes");
+        }
+        return message;
+    }
+    
+    /**
+     * @brief 扫描恰好包含一个值的字节范围
+     * @return 值的类型和原始字节
+     */
+    static RawValue scan_single(std::string_view raw) {
+        MsgpackScanner scanner(raw.data(), raw.size());
+        RawValue value = scanner.scan_value(1);
+        if (scanner.p_ != scanner.end_) {
+            scanner.fail("unexpected trailing bytes");
+        }
+        return value;
+    }
+    
+    /**
+     * @brief 解码字符串值（原始字节包含类型标记）
+     */
+    static std::string decode_string(std::string_view raw) {
+        MsgpackScanner scanner(raw.data(), raw.size());
+        Header header = scanner.read_header();
+        return std::string(reinterpret_cast<const char*>(scanner.p_), static_cast<std::size_t>(header.length));
+    }
+
+private:
+    /**
+     * @struct Header
+     * @brief 值的类型标记
+     * 
+     * 字符串、bin、ext 的 length 为字节数（ext 包含类型字节），
+     * 数组为元素数，map 为键值对数，其他类型为数据字节数。
+     */
+    struct Header {
+        ValueKind kind;
+        uint64_t length;
+    };
+    
+    Envelope scan_entry(int depth) {
+        return scan_entry_after(read_header(), depth);
+    }
+    
+    /**
+     * @brief 扫描已读出类型标记的顶层值或批量条目
+     */
+    Envelope scan_entry_after(const Header& header, int depth) {
+        Envelope envelope;
+        envelope.encoding = EncodingType::MSGPACK;
+        if (header.kind != ValueKind::OBJECT) {
+            skip_body(header, depth);
+            return envelope;
+        }
+        envelope.is_object = true;
+        for (uint64_t i = 0; i < header.length; ++i) {
+            Header key = read_header();
+            std::string_view key_view;
+            if (key.kind == ValueKind::STRING) {
+                need(key.length);
+                key_view = std::string_view(reinterpret_cast<const char*>(p_), static_cast<std::size_t>(key.length));
+                p_ += key.length;
+            } else {
+                skip_body(key, depth + 1);
+            }
+            RawValue value = scan_value(depth + 1);
+            if (key.kind == ValueKind::STRING) {
+                assign_member(envelope, key_view, value, decode_string);
+            }
+        }
+        return envelope;
+    }
+    
+    RawValue scan_value(int depth) {
+        const uint8_t* start = p_;
+        Header header = read_header();
+        skip_body(header, depth);
+        return RawValue{header.kind, std::string_view(reinterpret_cast<const char*>(start), static_cast<std::size_t>(p_ - start))};
+    }
+    
+    /**
+     * @brief 跳过类型标记之后的数据
+     */
+    void skip_body(const Header& header, int depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        switch (header.kind) {
+            case ValueKind::ARRAY:
+                for (uint64_t i = 0; i < header.length; ++i) {
+                    scan_value(depth + 1);
+                }
+                break;
+            case ValueKind::OBJECT:
+                for (uint64_t i = 0; i < header.length; ++i) {
+                    scan_value(depth + 1);
+                    scan_value(depth + 1);
+                }
+                break;
+            default:
+                need(header.length);
+                p_ += header.length;
+                break;
+        }
+    }
+    
+    /**
+     * @brief 读取类型标记和长度
+     */
+    Header read_header() {
+        need(1);
+        uint8_t tag = *p_++;
+        if (tag <= 0x7f || tag >= 0xe0) {
+            return {ValueKind::NUMBER, 0};
+        }
+        if (tag <= 0x8f) {
+            return {ValueKind::OBJECT, tag & 0x0fu};
+        }
+        if (tag <= 0x9f) {
+            return {ValueKind::ARRAY, tag & 0x0fu};
+        }
+        if (tag <= 0xbf) {
+            return {ValueKind::STRING, tag & 0x1fu};
+        }
+        switch (tag) {
+            case 0xc0: return {ValueKind::NULL_VALUE, 0};
+            case 0xc2:
+            case 0xc3: return {ValueKind::BOOLEAN, 0};
+            case 0xc4: return {ValueKind::BINARY, read_uint(1)};
+            case 0xc5: return {ValueKind::BINARY, read_uint(2)};
+            case 0xc6: return {ValueKind::BINARY, read_uint(4)};
+            case 0xc7: return {ValueKind::BINARY, read_uint(1) + 1};
+            case 0xc8: return {ValueKind::BINARY, read_uint(2) + 1};
+            case 0xc9: return {ValueKind::BINARY, read_uint(4) + 1};
+            case 0xca: return {ValueKind::NUMBER, 4};
+            case 0xcb: return {ValueKind::NUMBER, 8};
+            case 0xcc: return {ValueKind::NUMBER, 1};
+            case 0xcd: return {ValueKind::NUMBER, 2};
+            case 0xce: return {ValueKind::NUMBER, 4};
+            case 0xcf: return {ValueKind::NUMBER, 8};
+            case 0xd0: return {ValueKind::NUMBER, 1};
+            case 0xd1: return {ValueKind::NUMBER, 2};
+            case 0xd2: return {ValueKind::NUMBER, 4};
+            case 0xd3: return {ValueKind::NUMBER, 8};
+            case 0xd4: return {ValueKind::BINARY, 2};
+            case 0xd5: return {ValueKind::BINARY, 3};
+            case 0xd6: return {ValueKind::BINARY, 5};
+            case 0xd7: return {ValueKind::BINARY, 9};
+            case 0xd8: return {ValueKind::BINARY, 17};
+            case 0xd9: return {ValueKind::STRING, read_uint(1)};
+            case 0xda: return {ValueKind::STRING, read_uint(2)};
+            case 0xdb: return {ValueKind::STRING, read_uint(4)};
+            case 0xdc: return {ValueKind::ARRAY, read_uint(2)};
+            case 0xdd: return {ValueKind::ARRAY, read_uint(4)};
+            case 0xde: return {ValueKind::OBJECT, read_uint(2)};
+            case 0xdf: return {ValueKind::OBJECT, read_uint(4)};
+            default: break;
+        }
+        --p_;
+        fail("invalid type byte");
+    }
+    
+    /// 读取大端无符号整数
+    uint64_t read_uint(int bytes) {
+        need(static_cast<uint64_t>(bytes));
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value = (value << 8) | *p_++;
+        }
+        return value;
+    }
+    
+    void need(uint64_t bytes) const {
+        if (static_cast<uint64_t>(end_ - p_) < bytes) {
+            fail("unexpected end of input");
+        }
+    }
+    
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw ParseError("Failed to parse MessagePack: " + reason + " at byte " + std::to_string(p_ - begin_));
+    }
+    
+    const uint8_t* begin_;
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+/**
+ * @class BinaryScanner
+ * @brief 二进制信封的扫描器
+ * 
+ * 读取固定头部，用 MessagePack 扫描器检查主体，
+ * 所有长度都不越界。格式见 binary_envelope.hpp。
+ */
+class BinaryScanner {
+public:
+    BinaryScanner(const char* data, std::size_t size)
+        : begin_(reinterpret_cast<const uint8_t*>(data)), p_(begin_), end_(begin_ + size) {}
+    
+    /**
+     * @brief 扫描整个载荷
+     */
+    ScannedMessage scan() {
+        ScannedMessage message;
+        uint8_t flags = read_prefix();
+        if (!(flags & binary_format::kBatch)) {
+            p_ = begin_;
+            message.entries.push_back(scan_entry(end_));
+            return message;
+        }
+        if (flags != binary_format::kBatch) {
+            fail("invalid batch flags");
+        }
+        message.is_batch = true;
+        uint32_t count = read_le<uint32_t>();
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t length = read_le<uint32_t>();
+            need(length);
+            message.entries.push_back(scan_entry(p_ + length));
+        }
+        if (p_ != end_) {
+            fail("unexpected trailing bytes");
+        }
+        return message;
+    }
+
+private:
+    /**
+     * @brief 扫描 [p_, end) 中的单个消息
+     */
+    Envelope scan_entry(const uint8_t* end) {
+        const uint8_t* outer_end = end_;
+        end_ = end;
+        
+        uint8_t flags = read_prefix();
+        if (flags & ~(binary_format::kKindMask | binary_format::kMethodId | binary_format::kTextId)) {
+            fail("invalid flags");
+        }
+        uint8_t kind = flags & binary_format::kKindMask;
+        bool has_method = kind == binary_format::REQUEST || kind == binary_format::NOTIFICATION;
+        if ((flags & binary_format::kMethodId) && !has_method) {
+            fail("method id in a response");
+        }
+        if ((flags & binary_format::kTextId) && kind == binary_format::NOTIFICATION) {
+            fail("id in a notification");
+        }
+        
+        Envelope envelope;
+        envelope.encoding = EncodingType::BINARY;
+        envelope.is_object = true;
+        envelope.version_ok = true;
+        if (kind != binary_format::NOTIFICATION) {
+            envelope.id_kind = ValueKind::STRING;
+            envelope.id = (flags & binary_format::kTextId) ? read_text() : std::to_string(read_le<uint64_t>());
+        }
+        if (flags & binary_format::kMethodId) {
+            envelope.method_kind = ValueKind::NUMBER;
+            envelope.method_id = read_le<uint32_t>();
+        } else if (has_method) {
+            envelope.method_kind = ValueKind::STRING;
+            envelope.method = read_text();
+        }
+        if (kind == binary_format::RESPONSE_ERR) {
+            envelope.error_code = static_cast<int32_t>(read_le<uint32_t>());
+        }
+        
+        // 主体：没有字节表示没有参数
+        std::string_view body(reinterpret_cast<const char*>(p_), static_cast<std::size_t>(end_ - p_));
+        RawValue value{ValueKind::ABSENT, std::string_view()};
+        if (!body.empty()) {
+            value = MsgpackScanner::scan_single(body);
+        }
+        p_ = end_;
+        end_ = outer_end;
+        
+        switch (kind) {
+            case binary_format::REQUEST:
+            case binary_format::NOTIFICATION:
+                envelope.params_kind = value.kind;
+                envelope.params = value.raw;
+                break;
+            case binary_format::RESPONSE_OK:
+                if (value.kind == ValueKind::ABSENT) {
+                    fail("missing result");
+                }
+                envelope.result_kind = value.kind;
+                envelope.result = value.raw;
+                break;
+            default:
+                if (value.kind != ValueKind::OBJECT) {
+                    fail("error body must be a map");
+                }
+                envelope.error_kind = ValueKind::OBJECT;
+                envelope.error = value.raw;
+                break;
+        }
+        return envelope;
+    }
+    
+    /**
+     * @brief 读取 magic 和版本，返回 flags
+     */
+    uint8_t read_prefix() {
+        need(3);
+        if (p_[0] != binary_format::kMagic) {
+            fail("invalid magic byte");
+        }
+        if (p_[1] != binary_format::kVersion) {
+            fail("unsupported version " + std::to_string(p_[1]));
+        }
+        p_ += 3;
+        return p_[-1];
+    }
+    
+    /// 读取 u16 长度加字节
+    std::string read_text() {
+        uint16_t length = read_le<uint16_t>();
+        need(length);
+        std::string text(reinterpret_cast<const char*>(p_), length);
+        p_ += length;
+        return text;
+    }
+    
+    /// 读取小端无符号整数
+    template<typename T>
+    T read_le() {
+        need(sizeof(T));
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<T>(*p_++) << (8 * i));
+        }
+        return value;
+    }
+    
+    void need(uint64_t bytes) const {
+        if (static_cast<uint64_t>(end_ - p_) < bytes) {
+            fail("unexpected end of input");
+        }
+    }
+    
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw ParseError("Failed to parse binary envelope: " + reason + " at byte " + std::to_string(p_ - begin_));
+    }
+    
+    const uint8_t* begin_;
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+/**
+ * @brief 解析原始字节中的一个值
+ * 
+ * 只有 JSON 载荷的原始字节是 JSON；二进制信封和转码扫描的原始字节都是 MessagePack。
+ */
+json parse_raw(std::string_view raw, EncodingType encoding) {
+    return decode(raw.data(), raw.size(), encoding == EncodingType::JSON ? EncodingType::JSON : EncodingType::MSGPACK);
+}
+
+/**
+ * @brief 扫描已由编解码器解码的消息
+ * @param message 解码后的消息
+ * @param type 载荷的编码类型
+ * @return 扫描结果；原始字节引用各条目共享的 MessagePack 缓冲区
+ */
+ScannedMessage scan_transcoded(const json& message, EncodingType type) {
+    auto storage = std::make_shared<std::string>(encode(message, EncodingType::MSGPACK));
+    ScannedMessage scanned = MsgpackScanner(storage->data(), storage->size()).scan();
+    for (auto& entry : scanned.entries) {
+        entry.encoding = type;
+        entry.storage = storage;
+    }
+    return scanned;
+}
+
+} // namespace
+
+/**
+ * @brief 是否为有效的 JSON-RPC 请求
+ * 
+ * 必须是对象，"jsonrpc" 为 "2.0"，"method" 为字符串（二进制信封也可以是方法ID），
+ * 存在 "id"，"params" 可选但必须是对象或数组。
+ */
+bool Envelope::is_valid_request() const {
+    return is_object && version_ok && has_method_target() && id_kind != ValueKind::ABSENT &&
+           (params_kind == ValueKind::ABSENT || params_kind == ValueKind::ARRAY || params_kind == ValueKind::OBJECT);
+}
+
+/**
+ * @brief 是否为有效的 JSON-RPC 通知
+ * 
+ * 与请求相同，但不能有 "id" 字段。
+ */
+bool Envelope::is_valid_notification() const {
+    return is_object && version_ok && has_method_target() && id_kind == ValueKind::ABSENT &&
+           (params_kind == ValueKind::ABSENT || params_kind == ValueKind::ARRAY || params_kind == ValueKind::OBJECT);
+}
+
+/**
+ * @brief 是否指定了方法
+ * 
+ * 方法ID只能来自二进制信封的头部；JSON 和 MessagePack 中数字的 "method" 无效。
+ */
+bool Envelope::has_method_target() const {
+    return method_kind == ValueKind::STRING || (method_kind == ValueKind::NUMBER && encoding == EncodingType::BINARY);
+}
+
+/**
+ * @brief 解析参数
+ */
+json Envelope::parse_params() const {
+    return params_kind == ValueKind::ABSENT ? json::object() : parse_raw(params, encoding);
+}
+
+/**
+ * @brief 解析结果
+ */
+json Envelope::parse_result() const {
+    return result_kind == ValueKind::ABSENT ? json(nullptr) : parse_raw(result, encoding);
+}
+
+/**
+ * @brief 解析错误对象
+ * 
+ * 二进制信封的错误代码在头部中，解析后放回 "code"。
+ */
+json Envelope::parse_error() const {
+    if (error_kind == ValueKind::ABSENT) {
+        return nullptr;
+    }
+    json parsed = parse_raw(error, encoding);
+    if (encoding == EncodingType::BINARY) {
+        parsed["code"] = error_code;
+    }
+    return parsed;
+}
+
+/**
+ * @brief 扫描单个消息的信封
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 信封；载荷为数组时 is_object 为 false
+ */
+Envelope scan_envelope(const char* data, std::size_t size, EncodingType type) {
+    ScannedMessage message = scan_message(data, size, type);
+    if (message.is_batch) {
+        Envelope envelope;
+        envelope.encoding = type;
+        return envelope;
+    }
+    return std::move(message.entries.front());
+}
+
+/**
+ * @brief 扫描单个或批量消息
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 扫描结果
+ */
+ScannedMessage scan_message(const char* data, std::size_t size, EncodingType type) {
+    switch (type) {
+        case EncodingType::MSGPACK:
+            return MsgpackScanner(data, size).scan();
+        case EncodingType::BINARY:
+            return BinaryScanner(data, size).scan();
+        case EncodingType::JSON:
+            return JsonScanner(data, size).scan();
+        default:
+            return scan_transcoded(codec_for(type).decode(data, size), type);
+    }
+}
+
+} // namespace zenoh_rpc
@@ -0,0 +1,129 @@
+#include "zenoh_rpc/executor.hpp"
+#include <iostream>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/**
+ * @brief 原子地更新最大值
+ * @param target 保存最大值的原子变量
+ * @param value 新观测值
+ */
+template<typename T>
+void update_max(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数
+ * @param options 执行器配置
+ * 
+ * 创建有界队列并启动指定数量的工作线程。
+ */
+Executor::Executor(const ExecutorOptions& options)
+    : overflow_(options.overflow),
+      queue_(options.queue_capacity) {
+    size_t num_threads = options.num_threads > 0 ? options.num_threads : 1;
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+Executor::~Executor() {
+    shutdown();
+}
+
+/**
+ * @brief 提交任务
+ * @param task 要执行的任务
+ * @return 任务被接受返回 true
+ * 
+ * 根据溢出策略选择阻塞等待或立即拒绝。
+ */
+bool Executor::submit(Task task) {
+    Item item{std::move(task), std::chrono::steady_clock::now()};
+    bool accepted = overflow_ == OverflowPolicy::BLOCK
+        ? queue_.push(std::move(item))
+        : queue_.try_push(std::move(item));
+    
+    if (!accepted) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    update_max(max_queue_depth_, queue_.size());
+    return true;
+}
+
+bool Executor::try_submit(Task task) {
+    if (!queue_.try_push(Item{std::move(task), std::chrono::steady_clock::now()})) {
+        return false;
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    update_max(max_queue_depth_, queue_.size());
+    return true;
+}
+
+/**
+ * @brief 关闭执行器
+ * 
+ * 关闭队列后等待工作线程处理完剩余任务并退出。
+ */
+void Executor::shutdown() {
+    std::lock_guard<std::mutex> lock(shutdown_mutex_);
+    queue_.close();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+/**
+ * @brief 获取指标快照
+ * @return 当前的执行器指标
+ */
+ExecutorMetrics Executor::metrics() const {
+    ExecutorMetrics metrics;
+    metrics.queue_depth = queue_.size();
+    metrics.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    metrics.submitted = submitted_.load(std::memory_order_relaxed);
+    metrics.completed = completed_.load(std::memory_order_relaxed);
+    metrics.rejected = rejected_.load(std::memory_order_relaxed);
+    metrics.total_wait = std::chrono::nanoseconds(total_wait_ns_.load(std::memory_order_relaxed));
+    metrics.max_wait = std::chrono::nanoseconds(max_wait_ns_.load(std::memory_order_relaxed));
+    return metrics;
+}
+
+/**
+ * @brief 工作线程主循环
+ * 
+ * 从队列中取出任务并执行，记录排队等待时间。
+ * 任务抛出的异常会被记录，不会终止工作线程。
+ */
+void Executor::worker_loop() {
+    while (auto item = queue_.pop()) {
+        auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - item->enqueued).count();
+        total_wait_ns_.fetch_add(wait, std::memory_order_relaxed);
+        update_max(max_wait_ns_, static_cast<int64_t>(wait));
+        
+        try {
+            item->task();
+        } catch (const std::exception& e) {
+            std::cerr << "Executor task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Executor task failed with unknown exception" << std::endl;
+        }
+        completed_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace zenoh_rpc
@@ -0,0 +1,178 @@
+#include "zenoh_rpc/id_generator.hpp"
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+#include <random>
+#include <thread>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/// 十六进制数字表
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+/**
+ * @brief SplitMix64 混合函数
+ * @param state 状态（会被推进）
+ * @return 混合后的 64 位值
+ * 
+ * 用于把种子扩展为 xoshiro256** 的 256 位初始状态。
+ */
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @class Xoshiro256
+ * @brief xoshiro256** 伪随机数生成器
+ * 
+ * 周期 2^256-1，每次生成只需要几次移位和乘法，
+ * 远快于 std::mt19937 加 uniform_int_distribution 的组合。
+ */
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        for (auto& word : state_) {
+            word = splitmix64(seed);
+        }
+    }
+    
+    uint64_t next() {
+        const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+    
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    uint64_t state_[4];
+};
+
+/**
+ * @brief 为当前线程生成种子
+ * @return 64 位种子
+ * 
+ * 组合硬件随机数和线程ID，避免线程之间得到相同的序列。
+ */
+uint64_t thread_seed() {
+    std::random_device rd;
+    uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    return seed ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+/**
+ * @brief 将 64 位值的低 digits 个十六进制位写入缓冲区
+ * @param out 输出缓冲区
+ * @param value 值
+ * @param digits 位数
+ */
+void write_hex(char* out, uint64_t value, int digits) {
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = kHexDigits[value & 0xf];
+        value >>= 4;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 获取当前线程的 64 位随机数
+ * @return 随机数
+ */
+uint64_t thread_random_u64() {
+    thread_local Xoshiro256 generator(thread_seed());
+    return generator.next();
+}
+
+/**
+ * @brief 将 UUID v4 写入固定缓冲区
+ * @param out 至少 36 字节的输出缓冲区
+ * 
+ * 122 个随机位来自两次 64 位随机数；
+ * 第13位固定为4（版本号），第17位为 8-b（变体标识）。
+ */
+void format_uuid(char* out) {
+    uint64_t hi = thread_random_u64();
+    uint64_t lo = thread_random_u64();
+    
+    write_hex(out, hi >> 32, 8);                 // xxxxxxxx
+    out[8] = '-';
+    write_hex(out + 9, hi >> 16, 4);             // xxxx
+    out[13] = '-';
+    out[14] = '4';                               // 版本号4
+    write_hex(out + 15, hi, 3);                  // xxx
+    out[18] = '-';
+    out[19] = kHexDigits[8 | (lo >> 62)];        // 变体标识 8-b
+    write_hex(out + 20, lo >> 48, 3);            // xxx
+    out[23] = '-';
+    write_hex(out + 24, lo, 12);                 // xxxxxxxxxxxx
+}
+
+/**
+ * @brief 生成 UUID
+ * @return 生成的 UUID 字符串
+ * 
+ * 使用线程局部生成器，多线程并发调用是安全的。
+ */
+std::string gen_uuid() {
+    char buffer[kUuidLength];
+    format_uuid(buffer);
+    return std::string(buffer, kUuidLength);
+}
+
+/**
+ * @brief 构造函数
+ * @param mode 初始生成模式
+ * 
+ * 随机选取 8 个十六进制字符作为紧凑模式的前缀。
+ */
+IdGenerator::IdGenerator(IdMode mode)
+    : mode_(mode),
+      counter_(0),
+      prefix_(8, '0') {
+    write_hex(&prefix_[0], thread_random_u64(), 8);
+}
+
+/**
+ * @brief 生成下一个请求 ID
+ * @return 请求 ID 字符串
+ * 
+ * 紧凑模式下只格式化计数器的有效十六进制位，
+ * 计数器小于 2^24 时 ID 不超过 15 个字符，可以使用短字符串优化。
+ * 数字模式下的 ID 就是计数器的十进制形式。
+ */
+std::string IdGenerator::next() {
+    IdMode mode = this->mode();
+    if (mode == IdMode::UUID) {
+        return gen_uuid();
+    }
+    
+    uint64_t value = counter_.fetch_add(1, std::memory_order_relaxed);
+    if (mode == IdMode::NUMERIC) {
+        return std::to_string(value);
+    }
+    
+    char buffer[8 + 1 + 16];
+    prefix_.copy(buffer, 8);
+    buffer[8] = '.';
+    
+    int digits = 1;
+    for (uint64_t rest = value >> 4; rest != 0; rest >>= 4) {
+        ++digits;
+    }
+    write_hex(buffer + 9, value, digits);
+    return std::string(buffer, 9 + digits);
+}
+
+} // namespace zenoh_rpc
@@ -1,34 +1,355 @@
 #include "zenoh_rpc/jsonrpc_client.hpp"
 #include "zenoh_rpc/errors.hpp"
+#include "zenoh_rpc/payload.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/message_parts.hpp"
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace zenoh_rpc {
 
 using json = nlohmann::json;
 
+/**
+ * @struct Client::PendingTable
+ * @brief 待处理请求表
+ * 
+ * 以 JSON-RPC 请求 ID 为键保存尚未完成的调用回调。
+ * 回复回调和丢弃回调通过 shared_ptr 共享此表，
+ * 每个请求只会被取出并完成一次。
+ */
+struct Client::PendingTable {
+    std::mutex mutex;                                    ///< 保护 calls
+    std::unordered_map<std::string, ResultCallback> calls; ///< 请求 ID 到完成回调的映射
+    std::mutex lifetime;                                 ///< 与客户端析构互斥，保护 open
+    bool open = true;                                    ///< 客户端是否仍然存在（按方法名重发需要客户端）
+    
+    /**
+     * @brief 取出并移除指定 ID 的回调
+     * @param id 请求ID
+     * @return 对应的回调；如果请求已完成则返回空回调
+     */
+    ResultCallback take(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = calls.find(id);
+        if (it == calls.end()) {
+            return nullptr;
+        }
+        ResultCallback callback = std::move(it->second);
+        calls.erase(it);
+        return callback;
+    }
+};
+
+/**
+ * @struct Client::MethodIdCache
+ * @brief 服务器的方法ID映射
+ * 
+ * 映射为空时由第一次调用在后台获取；获取期间和获取失败后的调用按方法名发送。
+ * 方法ID失效时只丢弃同一版本的映射，并发的失效不会重复获取。
+ */
+struct Client::MethodIdCache {
+    /// 映射状态
+    enum class State { EMPTY, LOADING, READY, FAILED, DISABLED };
+    
+    std::mutex mutex;                                  ///< 保护以下成员
+    State state;                                       ///< 当前状态
+    uint32_t version = 0;                              ///< 映射所属的方法表版本
+    std::unordered_map<std::string, uint32_t> ids;     ///< 方法名到方法ID的映射
+    
+    explicit MethodIdCache(bool enabled) : state(enabled ? State::EMPTY : State::DISABLED) {}
+    
+    /**
+     * @brief 查找方法ID
+     * @param method 方法名
+     * @param id 找到的方法ID
+     * @param table_version 方法ID所属的表版本
+     * @param fetch 映射为空、需要调用者开始获取时置为 true
+     * @return 找到方法ID时返回 true
+     */
+    bool find(const std::string& method, uint32_t& id, uint32_t& table_version, bool& fetch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        fetch = false;
+        if (state == State::EMPTY) {
+            state = State::LOADING;
+            fetch = true;
+            return false;
+        }
+        if (state != State::READY) {
+            return false;
+        }
+        auto it = ids.find(method);
+        if (it == ids.end()) {
+            return false;
+        }
+        id = it->second;
+        table_version = version;
+        return true;
+    }
+    
+    /**
+     * @brief 保存 "rpc.methods" 的回复
+     * @param reply {"version": 表版本, "methods": {方法名: 方法ID}}
+     * @param only_if_loading 只在后台获取期间保存（重新配置后到达的旧回复被忽略）
+     * @return 保存的方法ID数量
+     * @throws ParseError 当回复格式错误时
+     */
+    size_t store(const json& reply, bool only_if_loading) {
+        std::unordered_map<std::string, uint32_t> fresh;
+        uint32_t fresh_version = 0;
+        try {
+            fresh_version = reply.at("version").get<uint32_t>();
+            for (const auto& item : reply.at("methods").items()) {
+                fresh.emplace(item.key(), item.value().get<uint32_t>());
+            }
+        } catch (const json::exception& e) {
+            fail();
+            throw ParseError(std::string("Invalid method id table: ") + e.what());
+        }
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::DISABLED || (only_if_loading && state != State::LOADING)) {
+            return 0;
+        }
+        // 版本 0 表示服务器没有分配方法ID
+        state = fresh_version == 0 ? State::FAILED : State::READY;
+        version = fresh_version;
+        ids.swap(fresh);
+        return ids.size();
+    }
+    
+    /**
+     * @brief 获取失败，之后一直按方法名发送
+     */
+    void fail() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::LOADING) {
+            state = State::FAILED;
+        }
+    }
+    
+    /**
+     * @brief 丢弃指定版本的映射，下一次调用重新获取
+     * @param table_version 失效的方法ID所属的表版本
+     */
+    void invalidate(uint32_t table_version) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::READY && version == table_version) {
+            state = State::EMPTY;
+            ids.clear();
+        }
+    }
+    
+    /**
+     * @brief 丢弃映射并重新设置是否启用
+     * @param enabled 是否启用方法ID
+     */
+    void reset(bool enabled) {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = enabled ? State::EMPTY : State::DISABLED;
+        version = 0;
+        ids.clear();
+    }
+};
+
+/**
+ * @struct Client::ShardRoute
+ * @brief 分片服务器的请求路由
+ * 
+ * 回复附带分片数（见 sharded_server.hpp）时记下各分片的键表达式，之后的请求轮流发往各分片；
+ * 没有收到分片附件时请求发往服务键表达式。发往分片的请求超时后丢弃分片列表，
+ * 下一次请求回到服务键表达式，由新的回复重新确定分片数。
+ * 服务键表达式包含通配符时不按分片路由。
+ */
+struct Client::ShardRoute {
+    using Keys = std::vector<std::string>;
+    
+    const std::string base;                 ///< 服务键表达式
+    const bool shardable;                   ///< 服务键表达式不含通配符
+    std::shared_ptr<const Keys> keys;       ///< 分片键表达式（为空时发往 base），以 std::atomic_load/store 访问
+    std::atomic<size_t> next{0};            ///< 轮转计数
+    
+    explicit ShardRoute(const std::string& key_expr)
+        : base(key_expr), shardable(key_expr.find('*') == std::string::npos) {}
+    
+    /**
+     * @brief 选择请求的目标键表达式
+     * @param hold 保持所选分片列表有效，超时时传给 reset()
+     * @return 目标键表达式
+     */
+    const std::string& pick(std::shared_ptr<const Keys>& hold) {
+        hold = std::atomic_load(&keys);
+        if (!hold) {
+            return base;
+        }
+        return (*hold)[next.fetch_add(1, std::memory_order_relaxed) % hold->size()];
+    }
+    
+    /**
+     * @brief 按回复附带的分片数更新分片列表
+     * @param shards 分片数（0 时不做任何事）
+     */
+    void update(size_t shards) {
+        if (!shardable || shards == 0) {
+            return;
+        }
+        std::shared_ptr<const Keys> current = std::atomic_load(&keys);
+        if (current && current->size() == shards) {
+            return;
+        }
+        auto fresh = std::make_shared<Keys>();
+        fresh->reserve(shards);
+        for (size_t i = 0; i < shards; ++i) {
+            fresh->push_back(shard_key_expr(base, i));
+        }
+        std::atomic_store(&keys, std::shared_ptr<const Keys>(std::move(fresh)));
+    }
+    
+    /**
+     * @brief 丢弃超时请求使用的分片列表
+     * @param stale 超时请求选择时的分片列表（已被替换时不做任何事）
+     */
+    void reset(std::shared_ptr<const Keys> stale) {
+        std::atomic_compare_exchange_strong(&keys, &stale, std::shared_ptr<const Keys>());
+    }
+    
+    /**
+     * @brief 当前的分片数
+     */
+    size_t count() const {
+        std::shared_ptr<const Keys> current = std::atomic_load(&keys);
+        return current ? current->size() : 0;
+    }
+};
+
+namespace {
+
+/**
+ * @brief 按名称解析编解码器
+ * @param encoding 编码名称
+ * @return 注册表中的编解码器（一直存活到程序结束）
+ * @throws std::invalid_argument 当编码没有注册时，消息中列出已注册的编码
+ */
+const Codec* resolve_codec(const std::string& encoding) {
+    CodecRegistry& registry = CodecRegistry::instance();
+    if (const Codec* codec = registry.find(encoding)) {
+        return codec;
+    }
+    std::string supported;
+    for (const auto& name : registry.names()) {
+        supported += (supported.empty() ? "" : ", ") + name;
+    }
+    throw std::invalid_argument("Unsupported encoding: " + encoding + ". Supported: " + supported);
+}
+
+/**
+ * @brief 编码类型对应的默认请求 ID 模式
+ * @param type 编码类型
+ * @return 二进制信封使用数字 ID（以 8 字节整数传输），其他编码使用 UUID
+ */
+IdMode default_id_mode(EncodingType type) {
+    return type == EncodingType::BINARY ? IdMode::NUMERIC : IdMode::UUID;
+}
+
+/**
+ * @brief 将 JSON-RPC 错误对象转换为错误结果
+ * @param error 响应中的 error 对象，附加数据从中移出
+ * @return 错误结果（缺少或类型错误的字段使用默认值）
+ */
+RpcResult error_result(json& error) {
+    auto code = error.find("code");
+    auto message = error.find("message");
+    auto data = error.find("data");
+    return RpcResult::err(code != error.end() && code->is_number_integer() ? code->get<int>() : -32603,
+                          message != error.end() && message->is_string() ? message->get<std::string>()
+                                                                         : std::string("Unknown error"),
+                          data != error.end() ? std::move(*data) : json::object());
+}
+
+/**
+ * @brief 解析 JSON-RPC 响应并提取结果
+ * @param sample 回复样本
+ * @param encoding 客户端请求使用的编码类型
+ * @param id 期望的请求ID
+ * @return 方法执行结果；响应无效或包含错误时为错误结果
+ * @throws ParseError 当载荷无法解码时
+ * 
+ * 优先按回复上标记的 Zenoh Encoding 解码，未标记时使用请求的编码。
+ * 单遍扫描信封后只解析结果（或错误对象），不构造整个响应的 JSON 树。
+ * 错误响应直接转换为错误结果，不抛出异常。
+ */
+RpcResult parse_response(const zenoh::Sample& sample, EncodingType encoding, const std::string& id) {
+    auto reply_encoding = encoding_from_mime(sample.get_encoding().as_string());
+    PayloadView payload(sample.get_payload());
+    Envelope response = scan_envelope(payload.data(), payload.size(), reply_encoding.value_or(encoding));
+    
+    // 验证响应格式
+    if (!response.version_ok || response.id_kind != ValueKind::STRING || response.id != id) {
+        return RpcResult::err(-32600, "Invalid JSON-RPC response");
+    }
+    
+    // 错误响应：只解析 "error" 对象
+    if (response.error_kind != ValueKind::ABSENT) {
+        json error = response.parse_error();
+        return error_result(error);
+    }
+    
+    // 返回执行结果：只解析 "result" 的原始字节
+    if (response.result_kind == ValueKind::ABSENT) {
+        return RpcResult::err(-32600, "Response missing result field");
+    }
+    
+    return RpcResult::ok(response.parse_result());
+}
+
+/**
+ * @brief 将单个响应对象转换为调用结果
+ * @param response JSON-RPC 响应对象，结果和错误数据从中移出
+ * @return 成功结果或错误结果
+ */
+RpcResult to_result(json& response) {
+    if (response.contains("error") && response["error"].is_object()) {
+        return error_result(response["error"]);
+    }
+    auto result = response.find("result");
+    if (result == response.end()) {
+        return RpcResult::err(-32600, "Response missing result field");
+    }
+    return RpcResult::ok(std::move(*result));
+}
+
+} // namespace
+
 /**
  * @brief 构造函数（自动创建会话）
  * @param key_expr Zenoh 键表达式，用于标识远程服务
- * @param encoding 编码格式，支持 "json" 和 "msgpack"
+ * @param encoding 编码名称（见 codec.hpp 中的注册表）
  * @param timeout 默认超时时间（毫秒）
+ * @param sharing 会话共享方式
  * 
- * 创建新的 Zenoh 会话并初始化查询器。
+ * 从全局会话池获取默认配置的会话，或者创建独占的新会话。
  * 适用于独立使用客户端的场景。
  */
-Client::Client(const std::string& key_expr, const std::string& encoding, std::chrono::milliseconds timeout) 
+Client::Client(const std::string& key_expr, const std::string& encoding, std::chrono::milliseconds timeout,
+               SessionSharing sharing) 
     : key_expr_(key_expr), 
       session_(nullptr), 
       owns_session_(true),
-      owned_session_(std::make_unique<Session>()),
+      owned_session_(sharing == SessionSharing::SHARED ? SessionPool::global().acquire()
+                                                       : std::make_shared<Session>()),
       encoding_(encoding),
-      default_timeout_(timeout) {
+      codec_(resolve_codec(encoding)),
+      encoding_type_(codec_->type()),
+      default_timeout_(timeout),
+      id_generator_(default_id_mode(encoding_type_)),
+      pending_(std::make_shared<PendingTable>()),
+      method_ids_(std::make_shared<MethodIdCache>(encoding_type_ == EncodingType::BINARY)),
+      shards_(std::make_shared<ShardRoute>(key_expr)) {
     // 移除 querier_ 初始化，改用 Session::get() 方法
     session_ = owned_session_.get();
-    
-    // 验证编码格式
-    if (encoding_ != "json" && encoding_ != "msgpack") {
-        throw std::invalid_argument("Unsupported encoding: " + encoding_ + ". Supported: json, msgpack");
-    }
 }
 
 /**
@@ -36,34 +357,37 @@ Client::Client(const std::string& key_expr, const std::string& encoding, std::ch
  * @param key_expr Zenoh 键表达式，用于标识远程服务
  * @param mode 会话模式（client/peer/router）
  * @param connections 连接端点列表
- * @param encoding 编码格式，支持 "json" 和 "msgpack"
+ * @param encoding 编码名称（见 codec.hpp 中的注册表）
  * @param timeout 默认超时时间（毫秒）
+ * @param sharing 会话共享方式
  * 
- * 使用指定的模式和连接端点创建新的 Zenoh 会话并初始化查询器。
+ * 从全局会话池获取指定模式和连接端点的会话，或者创建独占的新会话。
  * 适用于需要特定网络配置的场景。
  */
 Client::Client(const std::string& key_expr, SessionMode mode, const std::vector<std::string>& connections, 
-               const std::string& encoding, std::chrono::milliseconds timeout) 
+               const std::string& encoding, std::chrono::milliseconds timeout, SessionSharing sharing) 
     : key_expr_(key_expr), 
       session_(nullptr), 
       owns_session_(true),
-      owned_session_(std::make_unique<Session>(mode, connections)),
+      owned_session_(sharing == SessionSharing::SHARED ? SessionPool::global().acquire(mode, connections)
+                                                       : std::make_shared<Session>(mode, connections)),
       encoding_(encoding),
-      default_timeout_(timeout) {
+      codec_(resolve_codec(encoding)),
+      encoding_type_(codec_->type()),
+      default_timeout_(timeout),
+      id_generator_(default_id_mode(encoding_type_)),
+      pending_(std::make_shared<PendingTable>()),
+      method_ids_(std::make_shared<MethodIdCache>(encoding_type_ == EncodingType::BINARY)),
+      shards_(std::make_shared<ShardRoute>(key_expr)) {
     // 移除 querier_ 初始化，改用 Session::get() 方法
     session_ = owned_session_.get();
-    
-    // 验证编码格式
-    if (encoding_ != "json" && encoding_ != "msgpack") {
-        throw std::invalid_argument("Unsupported encoding: " + encoding_ + ". Supported: json, msgpack");
-    }
 }
 
 /**
  * @brief 构造函数（使用现有会话）
  * @param key_expr Zenoh 键表达式，用于标识远程服务
  * @param session 现有的 Zenoh 会话引用
- * @param encoding 编码格式，支持 "json" 和 "msgpack"
+ * @param encoding 编码名称（见 codec.hpp 中的注册表）
  * @param timeout 默认超时时间（毫秒）
  * 
  * 使用提供的会话初始化查询器。
@@ -74,17 +398,40 @@ Client::Client(const std::string& key_expr, Session& session, const std::string&
       session_(&session), 
       owns_session_(false),
       encoding_(encoding),
-      default_timeout_(timeout) {
+      codec_(resolve_codec(encoding)),
+      encoding_type_(codec_->type()),
+      default_timeout_(timeout),
+      id_generator_(default_id_mode(encoding_type_)),
+      pending_(std::make_shared<PendingTable>()),
+      method_ids_(std::make_shared<MethodIdCache>(encoding_type_ == EncodingType::BINARY)),
+      shards_(std::make_shared<ShardRoute>(key_expr)) {
     // 移除 querier_ 初始化，改用 Session::get() 方法
-    
-    // 验证编码格式
-    if (encoding_ != "json" && encoding_ != "msgpack") {
-        throw std::invalid_argument("Unsupported encoding: " + encoding_ + ". Supported: json, msgpack");
-    }
 }
 
 
 
+/**
+ * @brief 析构函数
+ * 
+ * 以 ConnectionError 结束所有尚未完成的异步调用。
+ * 之后到达的回复会因为请求已从待处理表中移除而被忽略。
+ * 先关闭待处理表，正在按方法名重发的请求登记完成后才开始清理。
+ */
+Client::~Client() {
+    {
+        std::lock_guard<std::mutex> lock(pending_->lifetime);
+        pending_->open = false;
+    }
+    std::unordered_map<std::string, ResultCallback> calls;
+    {
+        std::lock_guard<std::mutex> lock(pending_->mutex);
+        calls.swap(pending_->calls);
+    }
+    for (auto& entry : calls) {
+        entry.second(RpcResult::err(-32001, "Client destroyed before reply was received"));
+    }
+}
+
 /**
  * @brief 调用远程 RPC 方法
  * @param method 要调用的方法名
@@ -100,112 +447,399 @@ Client::Client(const std::string& key_expr, Session& session, const std::string&
  * @throws ConnectionError 连接错误
  * @throws TimeoutError 超时错误
  * 
- * 执行完整的 RPC 调用流程：
+ * 同步调用是 try_call() 的包装：错误结果在这里才转换为异常。
+ */
+json Client::call(const std::string& method, json params, std::optional<std::chrono::milliseconds> timeout) {
+    return try_call(method, std::move(params), timeout).value();
+}
+
+/**
+ * @brief 调用远程方法，不抛出异常
+ * @param method 要调用的方法名
+ * @param params 方法参数（JSON对象或数组）
+ * @param timeout 超时时间（毫秒）
+ * @return 方法执行结果或错误信息
+ * 
+ * 发送请求后在 future 上等待结果对象。
+ */
+RpcResult Client::try_call(const std::string& method, json params, std::optional<std::chrono::milliseconds> timeout) {
+    auto promise = std::make_shared<std::promise<RpcResult>>();
+    std::future<RpcResult> future = promise->get_future();
+    try_call_async(method, std::move(params), [promise](RpcResult result) {
+        promise->set_value(std::move(result));
+    }, timeout);
+    return future.get();
+}
+
+/**
+ * @brief 异步调用远程方法（返回 future）
+ * @param method 要调用的方法名
+ * @param params 方法参数
+ * @param timeout 超时时间（毫秒）
+ * @return 方法执行结果的 future
+ */
+std::future<json> Client::call_async(const std::string& method, json params,
+                                     std::optional<std::chrono::milliseconds> timeout) {
+    auto promise = std::make_shared<std::promise<json>>();
+    std::future<json> future = promise->get_future();
+    
+    try_call_async(method, std::move(params), [promise](RpcResult result) {
+        if (result) {
+            promise->set_value(std::move(result).value());
+        } else {
+            promise->set_exception(result.exception());
+        }
+    }, timeout);
+    
+    return future;
+}
+
+/**
+ * @brief 异步调用远程方法（完成回调）
+ * @param method 要调用的方法名
+ * @param params 方法参数
+ * @param callback 完成回调
+ * @param timeout 超时时间（毫秒）
+ * 
+ * try_call_async() 的包装：错误结果以对应的 RpcError 异常传给回调。
+ */
+void Client::call_async(const std::string& method, json params, CallCallback callback,
+                        std::optional<std::chrono::milliseconds> timeout) {
+    if (!callback) {
+        throw std::invalid_argument("call_async requires a completion callback");
+    }
+    try_call_async(method, std::move(params), [callback = std::move(callback)](RpcResult result) {
+        if (result) {
+            callback(nullptr, std::move(result).value());
+        } else {
+            callback(result.exception(), nullptr);
+        }
+    }, timeout);
+}
+
+/**
+ * @brief 异步调用远程方法，不抛出异常（完成回调）
+ * @param method 要调用的方法名
+ * @param params 方法参数
+ * @param callback 完成回调
+ * @param timeout 超时时间（毫秒）
+ * 
+ * 执行完整的异步 RPC 调用流程：
  * 1. 生成唯一请求ID
- * 2. 创建JSON-RPC请求
- * 3. 通过Zenoh发送查询
- * 4. 等待并接收响应
- * 5. 解析和验证响应
- * 6. 处理错误或返回结果
- */
-json Client::call(const std::string& method, const json& params, std::optional<std::chrono::milliseconds> timeout) {
-    // 使用提供的超时时间或默认超时时间
-    auto actual_timeout = timeout.value_or(default_timeout_);
+ * 2. 直接编码 JSON-RPC 请求，不构造请求对象（有方法ID时以方法ID代替方法名）
+ * 3. 登记到待处理表并通过 Session::get() 发送查询
+ * 4. 回复到达时解析响应并完成调用；方法ID失效时以同一请求ID按方法名重发
+ */
+void Client::try_call_async(const std::string& method, json params, ResultCallback callback,
+                            std::optional<std::chrono::milliseconds> timeout) {
+    if (!callback) {
+        throw std::invalid_argument("try_call_async requires a completion callback");
+    }
+    
     // 生成唯一的请求ID
-    std::string id = gen_uuid();
+    std::string id = id_generator_.next();
     
-    // 创建 JSON-RPC 请求
-    json request = make_request(method, params, id);
-    std::string request_str;
+    // 请求引用方法名和参数，编码时直接写入载荷
+    MessageParts request = MessageParts::request(method, params, id);
+    std::chrono::milliseconds wait = timeout.value_or(default_timeout_);
+    auto parse = [encoding = encoding_type_, id](const zenoh::Sample& sample) {
+        return parse_response(sample, encoding, id);
+    };
     
-    // 根据编码格式选择编码函数
-    if (encoding_ == "json") {
-        request_str = encode_json(request);
-    } else if (encoding_ == "msgpack") {
-        request_str = encode_msgpack(request);
-    } else {
-        throw std::invalid_argument("Unsupported encoding: " + encoding_);
+    // 保留方法总是按方法名发送
+    uint32_t method_id = 0;
+    uint32_t table_version = 0;
+    bool fetch = false;
+    bool by_id = method.rfind("rpc.", 0) != 0 && method_ids_->find(method, method_id, table_version, fetch);
+    if (fetch) {
+        fetch_method_ids();
     }
-    
-    // 使用 Session::get() 方法进行查询
-    zenoh::Session::GetOptions options;
-    options.payload = request_str;
-    if (timeout) {
-        options.timeout_ms = timeout->count();
-    } else {
-        options.timeout_ms = default_timeout_.count();
+    if (!by_id) {
+        send_request(id, encode_payload(request, *codec_, shm_.get()), wait, std::move(parse), std::move(callback));
+        return;
     }
     
-    auto replies = session_->get_session().get(zenoh::KeyExpr(key_expr_), "", zenoh::channels::FifoChannel(16), std::move(options));
+    // 以方法ID编码；保留参数，方法ID失效时按方法名重发
+    request.method_id = method_id;
+    zenoh::Bytes payload = encode_payload(request, *codec_, shm_.get());
+    auto fallback = std::make_shared<json>(std::move(params));
     
-    // 等待回复
-    auto reply_result = replies.recv();
+    auto done = [this, pending = pending_, cache = method_ids_, table_version, method, fallback, id, wait, parse,
+                 callback = std::move(callback)](RpcResult result) {
+        if (!result && result.error().code == -32003) {
+            std::lock_guard<std::mutex> lock(pending->lifetime);
+            if (pending->open) {
+                cache->invalidate(table_version);
+                try {
+                    MessageParts by_name = MessageParts::request(method, *fallback, id);
+                    send_request(id, encode_payload(by_name, *codec_, shm_.get()), wait, parse, callback);
+                    return;
+                } catch (...) {
+                    result = RpcResult::from_exception(std::current_exception());
+                }
+            }
+        }
+        callback(std::move(result));
+    };
+    send_request(id, std::move(payload), wait, std::move(parse), std::move(done));
+}
+
+/**
+ * @brief 发送通知（不等待结果）
+ * @param method 要调用的方法名
+ * @param params 方法参数
+ * 
+ * 通知不需要请求ID，也不进入待处理表。
+ * 发布者在会话中按键表达式只声明一次；put() 期间持有发布者，会话并发关闭时不会失效。
+ */
+void Client::notify(const std::string& method, json params) {
+    zenoh::Publisher::PutOptions options;
+    options.encoding = zenoh::Encoding(codec_->mime());
+    std::shared_ptr<zenoh::Publisher> publisher = session_->get_publisher(key_expr_);
+    publisher->put(encode_payload(MessageParts::notification(method, params), *codec_, shm_.get()), std::move(options));
+}
+
+/**
+ * @brief 批量调用远程方法
+ * @param calls 要调用的方法列表
+ * @param timeout 超时时间（毫秒）
+ * @return 与 calls 一一对应的调用结果
+ */
+std::vector<RpcResult> Client::call_batch(std::vector<BatchCall> calls,
+                                          std::optional<std::chrono::milliseconds> timeout) {
+    return call_batch_async(std::move(calls), timeout).get();
+}
+
+/**
+ * @brief 异步批量调用远程方法
+ * @param calls 要调用的方法列表
+ * @param timeout 超时时间（毫秒）
+ * @return 调用结果列表的 future
+ * 
+ * 所有请求打包成一个 JSON-RPC 批量数组，通过一次查询发送。
+ * 服务器返回的响应数组按请求ID映射回各条目：
+ * - 单条请求失败只影响对应的结果
+ * - 整个批量请求被拒绝（例如解析错误）时，future 中保存对应的异常
+ * - 响应中缺少的条目以 -32603 错误结果返回
+ */
+std::future<std::vector<RpcResult>> Client::call_batch_async(std::vector<BatchCall> calls,
+                                                             std::optional<std::chrono::milliseconds> timeout) {
+    auto promise = std::make_shared<std::promise<std::vector<RpcResult>>>();
+    std::future<std::vector<RpcResult>> future = promise->get_future();
     
-    if (!std::holds_alternative<zenoh::Reply>(reply_result)) {
-        throw TimeoutError("No reply received within timeout");
+    if (calls.empty()) {
+        promise->set_value({});
+        return future;
     }
     
-    const auto& reply = std::get<zenoh::Reply>(reply_result);
-    
-    if (!reply.is_ok()) {
-        throw ConnectionError("Received error reply");
+    // 为每个条目生成请求ID并打包成批量数组
+    std::vector<std::string> ids;
+    ids.reserve(calls.size());
+    json batch = json::array();
+    for (auto& call : calls) {
+        ids.push_back(id_generator_.next());
+        batch.push_back(make_request(call.method, std::move(call.params), ids.back()));
     }
     
-    const auto& sample = reply.get_ok();
-    std::string response_str = sample.get_payload().as_string();
+    // 批量请求以第一个条目的ID登记到待处理表
+    std::string batch_id = ids.front();
     
-    // 根据编码格式解析响应
-    json response;
-    if (encoding_ == "json") {
-        response = decode_json(response_str);
-    } else if (encoding_ == "msgpack") {
-        response = decode_msgpack(response_str);
-    } else {
-        throw std::invalid_argument("Unsupported encoding: " + encoding_);
-    }
+    // 扫描响应数组，每个条目只保留 id 和解析后的 result 或 error
+    auto parse = [encoding = encoding_type_](const zenoh::Sample& sample) {
+        auto reply_encoding = encoding_from_mime(sample.get_encoding().as_string());
+        PayloadView payload(sample.get_payload());
+        ScannedMessage message = scan_message(payload.data(), payload.size(), reply_encoding.value_or(encoding));
+        
+        // 整个批量请求被拒绝时，服务器返回单个错误响应
+        if (!message.is_batch) {
+            const Envelope& response = message.entries.front();
+            if (response.error_kind != ValueKind::ABSENT) {
+                json error = response.parse_error();
+                return error_result(error);
+            }
+            return RpcResult::err(-32600, "Invalid JSON-RPC batch response");
+        }
+        
+        json responses = json::array();
+        for (const auto& entry : message.entries) {
+            if (entry.id_kind != ValueKind::STRING) {
+                continue;
+            }
+            json response = {{"id", entry.id}};
+            if (entry.error_kind != ValueKind::ABSENT) {
+                response["error"] = entry.parse_error();
+            } else if (entry.result_kind != ValueKind::ABSENT) {
+                response["result"] = entry.parse_result();
+            }
+            responses.push_back(std::move(response));
+        }
+        return RpcResult::ok(std::move(responses));
+    };
     
-    // 验证响应格式
-    if (!response.contains("jsonrpc") || response["jsonrpc"] != "2.0" ||
-        !response.contains("id") || response["id"] != id) {
-        throw InvalidRequestError("Invalid JSON-RPC response");
+    auto done = [promise, ids = std::move(ids)](RpcResult reply) {
+        if (!reply) {
+            promise->set_exception(reply.exception());
+            return;
+        }
+        json responses = std::move(reply).value();
+        
+        // 按请求ID索引响应
+        std::unordered_map<std::string, json*> by_id;
+        for (auto& response : responses) {
+            if (response.is_object() && response.contains("id") && response["id"].is_string()) {
+                by_id[response["id"].get<std::string>()] = &response;
+            }
+        }
+        
+        std::vector<RpcResult> results;
+        results.reserve(ids.size());
+        for (const auto& id : ids) {
+            auto it = by_id.find(id);
+            if (it == by_id.end()) {
+                results.push_back(RpcResult::err(-32603, "Missing response for batch entry"));
+            } else {
+                results.push_back(to_result(*it->second));
+            }
+        }
+        promise->set_value(std::move(results));
+    };
+    
+    send_request(batch_id, encode_payload(batch, *codec_, shm_.get()), timeout.value_or(default_timeout_),
+                 std::move(parse), std::move(done));
+    return future;
+}
+
+/**
+ * @brief 发送已编码的请求
+ * @param id 在待处理表中登记的ID
+ * @param payload 已编码的请求载荷
+ * @param timeout 超时时间
+ * @param parse 回复解析函数，载荷格式错误时可以抛出异常
+ * @param callback 完成回调
+ * 
+ * 回复到达时从待处理表取出回调，解析回复并完成调用；
+ * 查询结束仍未收到回复时，以 -32002 错误结果完成调用。
+ * 只有解码失败需要捕获异常，错误响应、错误回复和超时都不构造异常对象。
+ */
+void Client::send_request(const std::string& id, zenoh::Bytes payload, std::chrono::milliseconds timeout,
+                          ReplyParser parse, ResultCallback callback) {
+    // 登记到待处理表，回复回调通过 ID 找回完成回调
+    {
+        std::lock_guard<std::mutex> lock(pending_->mutex);
+        pending_->calls.emplace(id, std::move(callback));
     }
     
-    // 检查是否有错误
-    if (response.contains("error")) {
-        json error = response["error"];
-        int code = error["code"];
-        std::string message = error["message"];
-        json data = error.contains("data") ? error["data"] : json::object();
+    zenoh::Session::GetOptions options;
+    options.payload = std::move(payload);
+    options.encoding = zenoh::Encoding(codec_->mime());
+    options.timeout_ms = timeout.count();
+    
+    std::shared_ptr<const ShardRoute::Keys> route;
+    const std::string& target = shards_->pick(route);
+    
+    auto on_reply = [pending = pending_, shards = shards_, parse = std::move(parse), id](const zenoh::Reply& reply) {
+        ResultCallback done = pending->take(id);
+        if (!done) {
+            return;  // 已经完成（重复回复或客户端已析构）
+        }
+        if (!reply.is_ok()) {
+            done(RpcResult::err(-32001, "Received error reply"));
+            return;
+        }
+        
+        // 分片服务器在回复附件中告知分片数
+        if (auto attachment = reply.get_ok().get_attachment()) {
+            shards->update(parse_shards_attachment(attachment->get().as_string()));
+        }
         
-        // 根据错误代码抛出相应的异常
-        switch (code) {
-            case -32700:  // 解析错误
-                throw ParseError(message, data);
-            case -32600:  // 无效请求
-                throw InvalidRequestError(message, data);
-            case -32601:  // 方法不存在
-                throw MethodNotFoundError(message, data);
-            case -32602:  // 参数无效
-                throw InvalidParamsError(message, data);
-            case -32603:  // 内部错误
-                throw InternalError(message, data);
-            case -32000:  // 服务器错误
-                throw ServerError(message, data);
-            case -32001:  // 连接错误
-                throw ConnectionError(message, data);
-            case -32002:  // 超时错误
-                throw TimeoutError(message, data);
-            default:      // 其他错误
-                throw ServerError(message, data);
-        }
-    }
-    
-    // 返回执行结果
-    if (!response.contains("result")) {
-        throw InvalidRequestError("Response missing result field");
-    }
-    
-    return response["result"];
+        std::optional<RpcResult> result;
+        try {
+            result.emplace(parse(reply.get_ok()));
+        } catch (...) {
+            result.emplace(RpcResult::from_exception(std::current_exception()));
+        }
+        done(std::move(*result));
+    };
+    
+    auto on_done = [pending = pending_, shards = shards_, route, id]() {
+        // 查询结束（超时或没有可查询对象）时仍未收到回复
+        ResultCallback done = pending->take(id);
+        if (done) {
+            if (route) {
+                shards->reset(route);  // 分片可能已经不存在，下一次请求回到服务键表达式
+            }
+            done(RpcResult::err(-32002, "No reply received within timeout"));
+        }
+    };
+    
+    try {
+        session_->get_session().get(zenoh::KeyExpr(target), "", std::move(on_reply), std::move(on_done), std::move(options));
+    } catch (...) {
+        // 发送失败时撤销登记，错误直接抛给调用者
+        pending_->take(id);
+        throw;
+    }
+}
+
+/**
+ * @brief 启用或关闭方法ID
+ * @param enabled 是否以方法ID发送调用
+ * 
+ * 只对二进制编码生效，其他编码的客户端保持关闭。
+ */
+void Client::set_method_ids(bool enabled) {
+    method_ids_->reset(enabled && encoding_type_ == EncodingType::BINARY);
+}
+
+/**
+ * @brief 立即获取服务器的方法ID映射
+ * @param timeout 超时时间（毫秒）
+ * @return 获取到的方法ID数量（没有启用方法ID时为 0）
+ */
+size_t Client::refresh_method_ids(std::optional<std::chrono::milliseconds> timeout) {
+    json reply = call(kMethodIdsMethod, json::object(), timeout);
+    return method_ids_->store(reply, false);
+}
+
+/**
+ * @brief 在后台获取方法ID映射
+ * 
+ * 回调只持有映射的 shared_ptr，客户端析构后到达的回复仍可安全保存。
+ * 获取失败（例如服务器不认识 "rpc.methods"）后一直按方法名发送。
+ */
+void Client::fetch_method_ids() {
+    std::shared_ptr<MethodIdCache> cache = method_ids_;
+    try {
+        try_call_async(kMethodIdsMethod, json::object(), [cache](RpcResult reply) {
+            if (!reply) {
+                cache->fail();
+                return;
+            }
+            try {
+                cache->store(reply.value(), true);
+            } catch (const RpcError&) {
+            }
+        });
+    } catch (...) {
+        cache->fail();
+    }
+}
+
+/**
+ * @brief 获取服务器的分片数
+ * @return 从回复附件得知的分片数（0 表示请求发往服务键表达式）
+ */
+size_t Client::shard_count() const {
+    return shards_->count();
+}
+
+/**
+ * @brief 获取尚未完成的异步调用数量
+ * @return 待处理表中的请求数量
+ */
+size_t Client::pending_calls() const {
+    std::lock_guard<std::mutex> lock(pending_->mutex);
+    return pending_->calls.size();
 }
 
 } // namespace zenoh_rpc
\ No newline at end of file
@@ -1,66 +1,13 @@
 #include "zenoh_rpc/jsonrpc_proto.hpp"
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/codec.hpp"
 #include "zenoh_rpc/errors.hpp"
-#include <random>
-#include <sstream>
-#include <iomanip>
 
 namespace zenoh_rpc {
 
 using json = nlohmann::json;
 
-/**
- * @brief 生成 UUID v4 字符串
- * @return 格式为 xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx 的 UUID 字符串
- * 
- * 生成符合 RFC 4122 标准的 UUID v4。
- * 使用随机数生成器确保唯一性，适用于 JSON-RPC 请求 ID。
- * 
- * UUID 格式说明：
- * - 第13位固定为4（版本号）
- * - 第17位为8-b之间的值（变体标识）
- * - 其余位为随机十六进制数字
- */
-std::string gen_uuid() {
-    static std::random_device rd;  ///< 硬件随机数生成器
-    static std::mt19937 gen(rd()); ///< 梅森旋转算法随机数生成器
-    static std::uniform_int_distribution<> dis(0, 15);  ///< 0-15的均匀分布（十六进制数字）
-    static std::uniform_int_distribution<> dis2(8, 11); ///< 8-11的均匀分布（UUID变体标识）
-    
-    std::stringstream ss;
-    int i;
-    ss << std::hex;
-    
-    // 生成前8位
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    
-    // 生成4位
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    ss << "-4";  // 版本号4
-    
-    // 生成3位
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    
-    // 生成变体标识和3位
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    
-    // 生成最后12位
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    }
-    return ss.str();
-}
+// gen_uuid() 的实现位于 id_generator.cpp（线程局部随机数生成器）
 
 /**
  * @brief 创建 JSON-RPC 请求
@@ -71,12 +18,24 @@ std::string gen_uuid() {
  * 
  * 创建符合 JSON-RPC 2.0 规范的请求对象。
  * 请求包含必需的 jsonrpc、method、params 和 id 字段。
+ * 参数复制一次后交给移入参数的版本。
  */
 json make_request(const std::string& method, const json& params, const std::string& id) {
+    return make_request(method, json(params), id);
+}
+
+/**
+ * @brief 创建 JSON-RPC 请求（移入参数）
+ * @param method 要调用的方法名
+ * @param params 方法参数，移动到请求中
+ * @param id 请求标识符（如果为空则自动生成）
+ * @return 完整的 JSON-RPC 请求对象
+ */
+json make_request(const std::string& method, json&& params, const std::string& id) {
     json request;
-    request["jsonrpc"] = "2.0";  // JSON-RPC 版本
-    request["method"] = method;   // 方法名
-    request["params"] = params;   // 参数
+    request["jsonrpc"] = "2.0";             // JSON-RPC 版本
+    request["method"] = method;              // 方法名
+    request["params"] = std::move(params);   // 参数
     
     // 如果 ID 为空，则自动生成
     if (id.empty()) {
@@ -88,6 +47,39 @@ json make_request(const std::string& method, const json& params, const std::stri
     return request;
 }
 
+/**
+ * @brief 创建 JSON-RPC 通知
+ * @param method 要调用的方法名
+ * @param params 方法参数（JSON对象或数组）
+ * @return 不带 id 字段的 JSON-RPC 请求对象
+ */
+json make_notification(const std::string& method, const json& params) {
+    return make_notification(method, json(params));
+}
+
+/**
+ * @brief 创建 JSON-RPC 通知（移入参数）
+ * @param method 要调用的方法名
+ * @param params 方法参数，移动到通知中
+ * @return 不带 id 字段的 JSON-RPC 请求对象
+ */
+json make_notification(const std::string& method, json&& params) {
+    json notification;
+    notification["jsonrpc"] = "2.0";             // JSON-RPC 版本
+    notification["method"] = method;              // 方法名
+    notification["params"] = std::move(params);   // 参数
+    return notification;
+}
+
+/**
+ * @brief 判断请求是否为通知
+ * @param request 请求对象
+ * @return 如果请求是没有 "id" 字段的对象则返回 true
+ */
+bool is_notification(const json& request) {
+    return request.is_object() && !request.contains("id");
+}
+
 /**
  * @brief 创建带关键字参数的 JSON-RPC 请求
  * @param method 要调用的方法名
@@ -102,6 +94,17 @@ json make_request_kwargs(const std::string& method, const json& kwargs, const st
     return make_request(method, kwargs, id);
 }
 
+/**
+ * @brief 创建带关键字参数的 JSON-RPC 请求（移入参数）
+ * @param method 要调用的方法名
+ * @param kwargs 关键字参数（JSON对象），移动到请求中
+ * @param id 请求标识符（如果为空则自动生成）
+ * @return 完整的 JSON-RPC 请求对象
+ */
+json make_request_kwargs(const std::string& method, json&& kwargs, const std::string& id) {
+    return make_request(method, std::move(kwargs), id);
+}
+
 /**
  * @brief 使用初始化列表创建位置参数的 JSON-RPC 请求
  * @param method 要调用的方法名
@@ -117,7 +120,7 @@ json make_request_list(const std::string& method, const std::initializer_list<js
     for (const auto& arg : args) {
         params.push_back(arg);
     }
-    return make_request(method, params, id);
+    return make_request(method, std::move(params), id);
 }
 
 /**
@@ -160,6 +163,35 @@ bool validate_request(const json& request) {
     return true;
 }
 
+/**
+ * @brief 验证 JSON-RPC 通知的有效性
+ * @param notification 要验证的通知对象
+ * @return 如果通知有效则返回 true
+ * 
+ * 检查版本、方法名和参数类型，并要求没有 "id" 字段。
+ */
+bool validate_notification(const json& notification) {
+    if (!is_notification(notification)) {
+        return false;
+    }
+    
+    // 检查 jsonrpc 和 method 字段
+    if (!notification.contains("jsonrpc") || notification["jsonrpc"] != "2.0" ||
+        !notification.contains("method") || !notification["method"].is_string()) {
+        return false;
+    }
+    
+    // 检查 params 字段（可选，但如果存在必须是对象或数组）
+    if (notification.contains("params")) {
+        const auto& params = notification["params"];
+        if (!params.is_object() && !params.is_array()) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
 /**
  * @brief 验证 JSON-RPC 响应的有效性
  * @param response 要验证的响应对象
@@ -216,12 +248,23 @@ bool validate_response(const json& response) {
  * 
  * 创建符合 JSON-RPC 2.0 规范的成功响应。
  * 响应包含 jsonrpc、result 和 id 字段。
+ * 结果复制一次后交给移入结果的版本。
  */
 json make_response_ok(const json& result, const std::string& id) {
+    return make_response_ok(json(result), id);
+}
+
+/**
+ * @brief 创建成功的 JSON-RPC 响应（移入结果）
+ * @param result 方法执行结果，移动到响应中
+ * @param id 对应请求的ID
+ * @return JSON-RPC 成功响应对象
+ */
+json make_response_ok(json&& result, const std::string& id) {
     json response;
-    response["jsonrpc"] = "2.0";  // JSON-RPC 版本
-    response["result"] = result;   // 执行结果
-    response["id"] = id;           // 对应的请求ID
+    response["jsonrpc"] = "2.0";             // JSON-RPC 版本
+    response["result"] = std::move(result);   // 执行结果
+    response["id"] = id;                      // 对应的请求ID
     return response;
 }
 
@@ -278,6 +321,170 @@ std::string get_encoding() {
     return "application/json";
 }
 
+/**
+ * @brief 根据编码名称获取编码类型
+ * @param name 编码名称
+ * @return 对应的编码类型；名称不支持时返回空值
+ */
+std::optional<EncodingType> encoding_from_name(const std::string& name) {
+    if (const Codec* codec = CodecRegistry::instance().find(name)) {
+        return codec->type();
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief 获取编码类型对应的 MIME 类型字符串
+ * @param type 编码类型
+ * @return MIME 类型字符串
+ */
+std::string encoding_mime(EncodingType type) {
+    return codec_for(type).mime();
+}
+
+/**
+ * @brief 取出 Zenoh Encoding 字符串中的 MIME 类型
+ * @param mime Zenoh Encoding 的字符串形式
+ * @return 去掉 "zenoh/bytes;" 前缀和 ";schema" 后缀后的 MIME 类型
+ */
+std::string mime_base(const std::string& mime) {
+    static const std::string kBytesPrefix = "zenoh/bytes;";
+    size_t start = mime.compare(0, kBytesPrefix.size(), kBytesPrefix) == 0 ? kBytesPrefix.size() : 0;
+    size_t end = mime.find(';', start);
+    return mime.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+/**
+ * @brief 根据 MIME 类型字符串获取编码类型
+ * @param mime Zenoh Encoding 的字符串形式
+ * @return 对应的编码类型；无法识别时返回空值
+ * 
+ * 接受 Zenoh 为非预定义 MIME 类型生成的 "zenoh/bytes;<mime>" 形式，
+ * 忽略 ";" 之后的 schema 部分，同时接受 "text/json"。
+ * 常用的三种编码直接比较，其他 MIME 类型在注册表中查找。
+ */
+std::optional<EncodingType> encoding_from_mime(const std::string& mime) {
+    std::string base = mime_base(mime);
+    if (base == "application/json" || base == "text/json") {
+        return EncodingType::JSON;
+    }
+    if (base == "application/msgpack" || base == "application/x-msgpack") {
+        return EncodingType::MSGPACK;
+    }
+    if (base == "application/x-zenoh-rpc-binary") {
+        return EncodingType::BINARY;
+    }
+    if (const Codec* codec = CodecRegistry::instance().find_mime(base)) {
+        return codec->type();
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief 根据载荷首字节推测编码类型
+ * @param data 载荷数据
+ * @return 推测的编码类型
+ * 
+ * JSON-RPC 消息总是对象或数组（批量请求），因此只需检查首个有效字节：
+ * - JSON：跳过空白后为 '{' 或 '['
+ * - MessagePack：fixmap (0x80-0x8f)、fixarray (0x90-0x9f)、
+ *   array16/array32 (0xdc/0xdd)、map16/map32 (0xde/0xdf)
+ * - 二进制信封：首字节为 0xc1（MessagePack 从不使用这个字节）
+ */
+EncodingType sniff_encoding(const std::string& data) {
+    return sniff_encoding(data.data(), data.size());
+}
+
+/**
+ * @brief 根据载荷首字节推测编码类型（连续字节视图）
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @return 推测的编码类型
+ */
+EncodingType sniff_encoding(const char* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        unsigned char byte = static_cast<unsigned char>(data[i]);
+        if (byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r') {
+            continue;
+        }
+        if ((byte >= 0x80 && byte <= 0x9f) || (byte >= 0xdc && byte <= 0xdf)) {
+            return EncodingType::MSGPACK;
+        }
+        if (byte == binary_format::kMagic) {
+            return EncodingType::BINARY;
+        }
+        return EncodingType::JSON;
+    }
+    return EncodingType::JSON;
+}
+
+/**
+ * @brief 按指定编码类型编码 JSON 对象
+ * @param data 要编码的 JSON 对象
+ * @param type 编码类型
+ * @return 编码后的字符串
+ */
+std::string encode(const json& data, EncodingType type) {
+    std::string out;
+    encode_into(data, type, out);
+    return out;
+}
+
+/**
+ * @brief 按指定编码类型编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param type 编码类型
+ * @param out 输出缓冲区
+ */
+void encode_into(const json& data, EncodingType type, std::string& out) {
+    switch (type) {
+        case EncodingType::MSGPACK:
+            encode_msgpack_into(data, out);
+            break;
+        case EncodingType::BINARY:
+            encode_binary_into(data, out);
+            break;
+        case EncodingType::JSON:
+            encode_json_into(data, out);
+            break;
+        default:
+            codec_for(type).encode_into(data, out);
+            break;
+    }
+}
+
+/**
+ * @brief 按指定编码类型解码字符串
+ * @param data 要解码的字符串
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ */
+json decode(const std::string& data, EncodingType type) {
+    return decode(data.data(), data.size(), type);
+}
+
+/**
+ * @brief 按指定编码类型解码连续字节视图
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ */
+json decode(const char* data, std::size_t size, EncodingType type) {
+    switch (type) {
+        case EncodingType::MSGPACK:
+            return decode_msgpack(data, size);
+        case EncodingType::BINARY:
+            return decode_binary(data, size);
+        case EncodingType::JSON:
+            return decode_json(data, size);
+        default:
+            return codec_for(type).decode(data, size);
+    }
+}
+
 /**
  * @brief 获取指定编码类型的编码/解码函数对
  * @param type 编码类型枚举值
@@ -291,7 +498,9 @@ std::string get_encoding() {
  * 
  * 支持的编码类型：
  * - JSON: 标准 JSON 编码
- * - MSGPACK: MessagePack 编码（当前回退到 JSON）
+ * - MSGPACK: MessagePack 编码
+ * - BINARY: 二进制信封（只能编码 JSON-RPC 消息）
+ * - 其他注册的编解码器（CBOR、UBJSON、BSON 等）
  */
 std::pair<std::function<std::string(const json&)>, std::function<json(const std::string&)>> get_encoding_funcs(EncodingType type) {
     switch (type) {
@@ -305,8 +514,18 @@ std::pair<std::function<std::string(const json&)>, std::function<json(const std:
                 [](const json& data) { return encode_msgpack(data); },
                 [](const std::string& data) { return decode_msgpack(data); }
             );
-        default:
-            throw std::invalid_argument("Unsupported encoding type");
+        case EncodingType::BINARY:
+            return std::make_pair(
+                [](const json& data) { return encode_binary(data); },
+                [](const std::string& data) { return decode_binary(data.data(), data.size()); }
+            );
+        default: {
+            const Codec* codec = &codec_for(type);
+            return std::make_pair(
+                [codec](const json& data) { return codec->encode(data); },
+                [codec](const std::string& data) { return codec->decode(data.data(), data.size()); }
+            );
+        }
     }
 }
 
@@ -322,6 +541,44 @@ std::string encode_json(const json& data) {
     return data.dump();
 }
 
+/**
+ * 本库中唯一使用 nlohmann::json 内部接口（nlohmann::detail）的地方，
+ * 在 nlohmann_json 3.11.2 上测试；CMake 要求 3.11 及以上版本。
+ * 二进制格式（MessagePack、CBOR、UBJSON、BSON）使用公共的 json::to_*(j, std::string&) 追加写入；
+ * JSON 文本没有追加到已有字符串的公共接口，dump() 总是返回新字符串。
+ */
+static_assert(NLOHMANN_JSON_VERSION_MAJOR == 3 && NLOHMANN_JSON_VERSION_MINOR >= 11,
+              "append_json() uses nlohmann::detail::serializer, tested with nlohmann_json 3.11");
+
+/**
+ * @brief 将 JSON 对象以紧凑格式追加到 out
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区（不清空）
+ * 
+ * 与 dump() 使用相同的序列化器（紧凑格式，非法 UTF-8 抛出异常）。
+ * 输出适配器放在栈上，用 shared_ptr 的别名构造函数包装（不拥有、不分配）；
+ * 序列化器每次调用构造一次，抛出异常后不会残留状态。
+ */
+void append_json(const json& data, std::string& out) {
+    nlohmann::detail::output_string_adapter<char, std::string> adapter(out);
+    nlohmann::detail::output_adapter_t<char> output(std::shared_ptr<void>(), &adapter);
+    nlohmann::detail::serializer<json> serializer(output, ' ', nlohmann::detail::error_handler_t::strict);
+    serializer.dump(data, false, false, 0);
+}
+
+/**
+ * @brief 将 JSON 对象编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区
+ * 
+ * 与 dump() 使用相同的序列化器（紧凑格式，非法 UTF-8 抛出异常），
+ * 但输出写入已清空的 out 中，从而复用其容量。
+ */
+void encode_json_into(const json& data, std::string& out) {
+    out.clear();
+    append_json(data, out);
+}
+
 /**
  * @brief 将字符串解码为 JSON 对象
  * @param data 要解码的 JSON 字符串
@@ -332,8 +589,21 @@ std::string encode_json(const json& data) {
  * 如果解析失败，会抛出 ParseError 异常，包含详细的错误信息。
  */
 json decode_json(const std::string& data) {
+    return decode_json(data.data(), data.size());
+}
+
+/**
+ * @brief 将连续字节视图解码为 JSON 对象
+ * @param data JSON 文本起始地址
+ * @param size JSON 文本字节数
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当 JSON 解析失败时
+ * 
+ * 以指针区间作为 nlohmann::json 的输入适配器，解析过程不复制输入。
+ */
+json decode_json(const char* data, std::size_t size) {
     try {
-        return json::parse(data);
+        return json::parse(data, data + size);
     } catch (const json::parse_error& e) {
         throw ParseError("Failed to parse JSON: " + std::string(e.what()));
     }
@@ -344,15 +614,25 @@ json decode_json(const std::string& data) {
  * @param data 要编码的 JSON 对象
  * @return 编码后的 MessagePack 字符串
  * 
- * 将 JSON 对象序列化为 MessagePack 二进制格式，然后转换为字符串。
+ * 将 JSON 对象序列化为 MessagePack 二进制格式，直接写入返回的字符串。
  * MessagePack 是一种高效的二进制序列化格式，比 JSON 更紧凑。
  */
 std::string encode_msgpack(const json& data) {
-    // 使用 nlohmann::json 的内置 MessagePack 支持
-    std::vector<std::uint8_t> msgpack_data = json::to_msgpack(data);
-    
-    // 将二进制数据转换为字符串
-    return std::string(msgpack_data.begin(), msgpack_data.end());
+    std::string out;
+    encode_msgpack_into(data, out);
+    return out;
+}
+
+/**
+ * @brief 将 JSON 对象以 MessagePack 格式编码到调用方提供的缓冲区
+ * @param data 要编码的 JSON 对象
+ * @param out 输出缓冲区
+ * 
+ * 使用 nlohmann::json 的 MessagePack 写入器直接追加到已清空的 out。
+ */
+void encode_msgpack_into(const json& data, std::string& out) {
+    out.clear();
+    json::to_msgpack(data, out);
 }
 
 /**
@@ -365,12 +645,22 @@ std::string encode_msgpack(const json& data) {
  * 如果解析失败，会抛出 ParseError 异常，包含详细的错误信息。
  */
 json decode_msgpack(const std::string& data) {
+    return decode_msgpack(data.data(), data.size());
+}
+
+/**
+ * @brief 将连续字节视图解码为 MessagePack 对应的 JSON 对象
+ * @param data MessagePack 数据起始地址
+ * @param size MessagePack 数据字节数
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当 MessagePack 解析失败时
+ * 
+ * 以指针区间作为 nlohmann::json 的输入适配器，解析过程不复制输入。
+ */
+json decode_msgpack(const char* data, std::size_t size) {
     try {
-        // 将字符串转换为字节向量
-        std::vector<std::uint8_t> msgpack_data(data.begin(), data.end());
-        
-        // 使用 nlohmann::json 的内置 MessagePack 支持
-        return json::from_msgpack(msgpack_data);
+        const auto* first = reinterpret_cast<const std::uint8_t*>(data);
+        return json::from_msgpack(first, first + size);
     } catch (const json::parse_error& e) {
         throw ParseError("Failed to parse MessagePack: " + std::string(e.what()));
     } catch (const std::exception& e) {
@@ -378,4 +668,51 @@ json decode_msgpack(const std::string& data) {
     }
 }
 
+/**
+ * @brief 获取分片的键表达式
+ * @param key_expr 服务键表达式
+ * @param shard 分片序号
+ * @return "<key_expr>/@shard/<shard>"
+ * 
+ * "@shard" 是 Zenoh 的逐字匹配段（verbatim chunk），只有同样写出 "@shard" 的键表达式才能匹配它。
+ * 因此在服务键表达式后接 ** 的订阅者和查询对象不会收到发往分片的查询，
+ * 发往服务键表达式的通配符查询也不会到达分片。
+ */
+std::string shard_key_expr(const std::string& key_expr, size_t shard) {
+    return key_expr + "/@shard/" + std::to_string(shard);
+}
+
+/**
+ * @brief 编码分片附件
+ * @param shards 分片数
+ * @return "rpc.shards=<shards>"，由 parse_shards_attachment() 解析
+ * 
+ * 分片服务器附加在每个回复上，客户端据此得知分片数并直接查询分片。
+ */
+std::string make_shards_attachment(size_t shards) {
+    return kShardsAttachmentPrefix + std::to_string(shards);
+}
+
+/**
+ * @brief 解析分片附件
+ * @param attachment 回复附件内容
+ * @return 分片数；不是分片附件或格式错误时返回 0
+ * 
+ * 每个回复都会调用，只做前缀比较和十进制解析，不分配内存。
+ */
+size_t parse_shards_attachment(std::string_view attachment) {
+    std::string_view prefix(kShardsAttachmentPrefix);
+    if (attachment.size() <= prefix.size() || attachment.substr(0, prefix.size()) != prefix) {
+        return 0;
+    }
+    size_t shards = 0;
+    for (char c : attachment.substr(prefix.size())) {
+        if (c < '0' || c > '9' || shards > 1000000) {
+            return 0;
+        }
+        shards = shards * 10 + static_cast<size_t>(c - '0');
+    }
+    return shards;
+}
+
 } // namespace zenoh_rpc
\ No newline at end of file
@@ -1,13 +1,119 @@
 #include "zenoh_rpc/jsonrpc_server.hpp"
 #include "zenoh_rpc/errors.hpp"
+#include "zenoh_rpc/payload.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/message_parts.hpp"
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <functional>
+#include <future>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+#include <atomic>
+#include <utility>
+#include <vector>
 
 namespace zenoh_rpc {
 
 using json = nlohmann::json;
 
+/**
+ * @struct DispatcherBase::MethodEntry
+ * @brief 一个已注册的方法（同步、结果对象或异步处理函数之一）
+ */
+struct DispatcherBase::MethodEntry {
+    MethodHandler sync;     ///< 同步处理函数
+    ResultHandler result;   ///< 返回结果对象的处理函数
+    AsyncHandler async;     ///< 异步处理函数
+};
+
+/**
+ * @struct DispatcherBase::MethodTable
+ * @brief 发布的方法表快照
+ * 
+ * 发布后不再修改；entries 与索引中的键顺序相同。
+ */
+struct DispatcherBase::MethodTable {
+    PerfectHashIndex index;                                    ///< 方法名索引
+    std::vector<std::shared_ptr<const MethodEntry>> entries;   ///< 方法条目
+    uint32_t version = 0;                                      ///< 表版本（低 16 位不为 0）
+};
+
+namespace {
+
+/// 方法ID中位置所占的位数
+constexpr unsigned kMethodIndexBits = 16;
+
+/// 可以分配方法ID的最大方法数
+constexpr size_t kMaxMethodIds = size_t{1} << kMethodIndexBits;
+
+/**
+ * @brief 由表版本和方法位置组成方法ID
+ */
+uint32_t make_method_id(uint32_t version, size_t index) {
+    return (version << kMethodIndexBits) | static_cast<uint32_t>(index);
+}
+
+/**
+ * @brief 方法不存在的错误结果
+ * @param method_name 方法名
+ */
+RpcResult method_not_found(std::string_view method_name) {
+    return RpcResult::err(-32601, "Method '" + std::string(method_name) + "' not found");
+}
+
+/**
+ * @brief 方法ID失效的错误结果
+ * @param method_id 方法ID
+ */
+RpcResult stale_method_id(uint32_t method_id) {
+    return RpcResult::err(-32003, "Method id " + std::to_string(method_id) + " is stale");
+}
+
+/**
+ * @brief 执行处理函数，把抛出的异常转换为错误结果
+ * @param fn 返回 RpcResult 的函数
+ * @return fn 的结果；fn 抛出异常时为对应的错误结果（保留原始异常）
+ */
+template<typename Fn>
+RpcResult guarded(Fn&& fn) {
+    try {
+        return fn();
+    } catch (...) {
+        return RpcResult::from_exception(std::current_exception());
+    }
+}
+
+/**
+ * @brief 把以异常报告错误的完成回调包装为结果回调
+ * @param done 完成回调
+ * @return 结果回调：错误结果以 RpcResult::exception() 传给 done
+ */
+ResultCallback to_result_callback(DispatchCallback done) {
+    return [done = std::move(done)](RpcResult result) {
+        if (result) {
+            done(nullptr, std::move(result).value());
+        } else {
+            done(result.exception(), nullptr);
+        }
+    };
+}
+
+} // namespace
+
+DispatcherBase::DispatcherBase() = default;
+
+/**
+ * @brief 析构分发器
+ * 
+ * 此时不应再有并发的分发，直接释放当前快照。
+ */
+DispatcherBase::~DispatcherBase() {
+    delete table_.load();
+}
+
 /**
  * @brief 注册方法处理器
  * @param method_name 方法名称
@@ -16,8 +122,236 @@ using json = nlohmann::json;
  * 将方法名与其处理函数关联起来。
  * 如果方法名已存在，会覆盖原有的处理函数。
  */
-void DispatcherBase::register_method(const std::string& method_name, std::function<json(const json&)> handler) {
-    methods_[method_name] = handler;
+void DispatcherBase::register_method(const std::string& method_name, MethodHandler handler) {
+    auto entry = std::make_shared<MethodEntry>();
+    entry->sync = std::move(handler);
+    update_method(method_name, std::move(entry));
+}
+
+/**
+ * @brief 注册异步方法处理器
+ * @param method_name 方法名称
+ * @param handler 异步处理函数
+ * 
+ * 如果方法名已存在（同步或异步），会覆盖原有的处理函数。
+ */
+void DispatcherBase::register_async_method(const std::string& method_name, AsyncHandler handler) {
+    auto entry = std::make_shared<MethodEntry>();
+    entry->async = std::move(handler);
+    update_method(method_name, std::move(entry));
+}
+
+/**
+ * @brief 注册返回结果对象的方法处理器
+ * @param method_name 方法名称
+ * @param handler 返回 RpcResult 的处理函数
+ * 
+ * 如果方法名已存在（同步或异步），会覆盖原有的处理函数。
+ */
+void DispatcherBase::register_result_method(const std::string& method_name, ResultHandler handler) {
+    auto entry = std::make_shared<MethodEntry>();
+    entry->result = std::move(handler);
+    update_method(method_name, std::move(entry));
+}
+
+/**
+ * @brief 注销方法
+ * @param method_name 方法名称
+ * @return 方法存在并被注销时返回 true
+ */
+bool DispatcherBase::unregister_method(std::string_view method_name) {
+    return update_method(method_name, nullptr);
+}
+
+/**
+ * @brief 修改注册表
+ * @param method_name 方法名
+ * @param entry 新的方法条目；为空时注销该方法
+ * @return 注册表发生变化时返回 true
+ * 
+ * 已发布时同时发布新表；构建失败时恢复注册表并重新抛出异常。
+ */
+bool DispatcherBase::update_method(std::string_view method_name, std::shared_ptr<const MethodEntry> entry) {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto it = methods_.find(method_name);
+    std::shared_ptr<const MethodEntry> previous;
+    if (entry) {
+        if (it == methods_.end()) {
+            it = methods_.emplace(std::string(method_name), nullptr).first;
+        }
+        previous = std::exchange(it->second, std::move(entry));
+    } else {
+        if (it == methods_.end()) {
+            return false;
+        }
+        previous = std::move(it->second);
+        methods_.erase(it);
+    }
+    
+    if (table_.load()) {
+        try {
+            publish_locked();
+        } catch (...) {
+            if (previous) {
+                methods_[std::string(method_name)] = std::move(previous);
+            } else {
+                methods_.erase(methods_.find(method_name));
+            }
+            throw;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 发布方法表
+ */
+void DispatcherBase::publish() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    if (!table_.load()) {
+        publish_locked();
+    }
+}
+
+/**
+ * @brief 由注册表构建新表并替换快照
+ * 
+ * 方法条目由注册表和各个快照共享，不复制处理函数。
+ * 替换后等待仍可能读取旧快照的查找结束，再释放旧快照。
+ */
+void DispatcherBase::publish_locked() {
+    std::vector<std::string> names;
+    auto table = std::make_unique<MethodTable>();
+    
+    // 版本的低 16 位进入方法ID，跳过为 0 的值，使方法ID不会与上一轮的版本混淆
+    uint32_t version = table_version_ + 1;
+    if ((version & (kMaxMethodIds - 1)) == 0) {
+        ++version;
+    }
+    table->version = version;
+    names.reserve(methods_.size());
+    table->entries.reserve(methods_.size());
+    for (const auto& [name, entry] : methods_) {
+        names.push_back(name);
+        table->entries.push_back(entry);
+    }
+    table->index = PerfectHashIndex(std::move(names));
+    table_version_ = version;
+    
+    std::unique_ptr<const MethodTable> previous(table_.exchange(table.release()));
+    if (previous) {
+        readers_.synchronize();
+    }
+}
+
+/**
+ * @brief 方法表是否已经发布
+ */
+bool DispatcherBase::is_published() const {
+    return table_.load() != nullptr;
+}
+
+/**
+ * @brief 是否注册了指定方法
+ * @param method_name 方法名
+ */
+bool DispatcherBase::has_method(std::string_view method_name) const {
+    return find_method(method_name) != nullptr;
+}
+
+/**
+ * @brief 是否存在指定方法ID对应的方法
+ * @param method_id 方法ID
+ */
+bool DispatcherBase::has_method(uint32_t method_id) const {
+    return find_method(method_id) != nullptr;
+}
+
+/**
+ * @brief 已注册的方法数量
+ */
+size_t DispatcherBase::method_count() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    return methods_.size();
+}
+
+/**
+ * @brief 已注册的方法名（按名称排序）
+ */
+std::vector<std::string> DispatcherBase::method_names() const {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    std::vector<std::string> names;
+    names.reserve(methods_.size());
+    for (const auto& entry : methods_) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+/**
+ * @brief 当前发布的表的方法ID映射
+ * 
+ * 持有 registry_mutex_ 时快照不会被替换，可以直接读取。
+ */
+json DispatcherBase::method_ids() const {
+    json methods = json::object();
+    uint32_t version = 0;
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    const MethodTable* table = table_.load();
+    if (table && table->entries.size() <= kMaxMethodIds) {
+        version = table->version;
+        for (size_t i = 0; i < table->entries.size(); ++i) {
+            methods[table->index.key(i)] = make_method_id(version, i);
+        }
+    }
+    return json{{"version", version}, {"methods", std::move(methods)}};
+}
+
+/**
+ * @brief 查找方法
+ * @param method_name 方法名
+ * @return 方法条目；不存在时返回 nullptr
+ * 
+ * 发布后在快照的完美哈希索引中查找，只在读临界区内复制条目的 shared_ptr，
+ * 处理函数在临界区外执行，写者不会等待处理函数。
+ * 发布前在互斥锁保护下查找注册表。两种方式都不构造 std::string。
+ */
+std::shared_ptr<const DispatcherBase::MethodEntry> DispatcherBase::find_method(std::string_view method_name) const {
+    unsigned slot = readers_.enter();
+    if (const MethodTable* table = table_.load()) {
+        size_t index = table->index.find(method_name);
+        std::shared_ptr<const MethodEntry> entry;
+        if (index != PerfectHashIndex::npos) {
+            entry = table->entries[index];
+        }
+        readers_.leave(slot);
+        return entry;
+    }
+    readers_.leave(slot);
+    
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto it = methods_.find(method_name);
+    return it == methods_.end() ? nullptr : it->second;
+}
+
+/**
+ * @brief 按方法ID查找方法
+ * @param method_id 方法ID
+ * @return 方法条目；方法ID不属于当前发布的表时返回 nullptr
+ * 
+ * 比较方法ID中的版本后按位置取出条目。
+ */
+std::shared_ptr<const DispatcherBase::MethodEntry> DispatcherBase::find_method(uint32_t method_id) const {
+    std::shared_ptr<const MethodEntry> entry;
+    unsigned slot = readers_.enter();
+    if (const MethodTable* table = table_.load()) {
+        size_t index = method_id & (kMaxMethodIds - 1);
+        if (make_method_id(table->version, index) == method_id && index < table->entries.size()) {
+            entry = table->entries[index];
+        }
+    }
+    readers_.leave(slot);
+    return entry;
 }
 
 /**
@@ -27,15 +361,1078 @@ void DispatcherBase::register_method(const std::string& method_name, std::functi
  * @return 方法执行结果
  * @throws MethodNotFoundError 当方法不存在时
  * 
- * 根据方法名查找对应的处理函数并执行。
- * 如果方法不存在，会抛出 MethodNotFoundError 异常。
+ * 错误结果在这里才转换为异常。
  */
-json DispatcherBase::dispatch(const std::string& method_name, const json& params) {
-    auto it = methods_.find(method_name);
-    if (it == methods_.end()) {
-        throw MethodNotFoundError("Method '" + method_name + "' not found");
+json DispatcherBase::dispatch(std::string_view method_name, const json& params) {
+    return try_dispatch(method_name, params).value();
+}
+
+/**
+ * @brief 分发方法调用，不抛出异常
+ * @param method_name 要调用的方法名
+ * @param params 方法参数
+ * @return 方法执行结果或错误信息
+ */
+RpcResult DispatcherBase::try_dispatch(std::string_view method_name, const json& params) {
+    std::shared_ptr<const MethodEntry> entry = find_method(method_name);
+    if (!entry) {
+        return method_not_found(method_name);
+    }
+    if (entry->sync) {
+        return guarded([&] { return RpcResult::ok(entry->sync(params)); });
+    }
+    if (entry->result) {
+        return guarded([&] { return entry->result(params); });
+    }
+    
+    // 异步方法：等待回复句柄完成
+    auto promise = std::make_shared<std::promise<RpcResult>>();
+    std::future<RpcResult> result = promise->get_future();
+    invoke_async(*entry, params, [promise](RpcResult value) {
+        promise->set_value(std::move(value));
+    });
+    return result.get();
+}
+
+/**
+ * @brief 以回调方式分发方法调用
+ * @param method_name 要调用的方法名
+ * @param params 方法参数
+ * @param done 完成回调
+ * 
+ * 处理函数抛出的异常以 done(error) 报告；done 自身抛出的异常向调用者传播。
+ */
+void DispatcherBase::dispatch_async(std::string_view method_name, const json& params, DispatchCallback done) {
+    try_dispatch_async(method_name, params, to_result_callback(std::move(done)));
+}
+
+/**
+ * @brief 按方法ID以回调方式分发方法调用
+ * @param method_id 方法ID
+ * @param params 方法参数
+ * @param done 完成回调
+ */
+void DispatcherBase::dispatch_async(uint32_t method_id, const json& params, DispatchCallback done) {
+    try_dispatch_async(method_id, params, to_result_callback(std::move(done)));
+}
+
+/**
+ * @brief 以回调方式分发方法调用，不抛出异常
+ * @param method_name 要调用的方法名
+ * @param params 方法参数
+ * @param done 完成回调
+ * 
+ * 处理函数抛出的异常转换为错误结果；done 自身抛出的异常向调用者传播。
+ */
+void DispatcherBase::try_dispatch_async(std::string_view method_name, const json& params, ResultCallback done) {
+    std::shared_ptr<const MethodEntry> entry = find_method(method_name);
+    if (!entry) {
+        done(method_not_found(method_name));
+        return;
+    }
+    invoke_async(*entry, params, std::move(done));
+}
+
+/**
+ * @brief 按方法ID以回调方式分发方法调用，不抛出异常
+ * @param method_id 方法ID
+ * @param params 方法参数
+ * @param done 完成回调
+ */
+void DispatcherBase::try_dispatch_async(uint32_t method_id, const json& params, ResultCallback done) {
+    std::shared_ptr<const MethodEntry> entry = find_method(method_id);
+    if (!entry) {
+        done(stale_method_id(method_id));
+        return;
+    }
+    invoke_async(*entry, params, std::move(done));
+}
+
+/**
+ * @brief 以回调方式执行已找到的方法
+ * @param entry 方法条目（调用期间由调用者保持存活）
+ * @param params 方法参数
+ * @param done 完成回调
+ * 
+ * done 在 try 块之外调用，它抛出的异常不会被当作方法的错误。
+ */
+void DispatcherBase::invoke_async(const MethodEntry& entry, const json& params, ResultCallback done) {
+    if (entry.sync) {
+        done(guarded([&] { return RpcResult::ok(entry.sync(params)); }));
+        return;
+    }
+    if (entry.result) {
+        done(guarded([&] { return entry.result(params); }));
+        return;
+    }
+    
+    ReplyHandle reply(std::move(done));
+    try {
+        entry.async(params, reply);
+    } catch (...) {
+        reply.reject(std::current_exception());
+    }
+}
+
+/**
+ * @struct ReplyHandle::State
+ * @brief 回复句柄的共享状态
+ * 
+ * 最后一个句柄副本销毁时，如果请求仍未完成，以内部错误完成请求。
+ */
+struct ReplyHandle::State {
+    std::atomic<bool> completed{false};  ///< 是否已经完成
+    ResultCallback done;                 ///< 完成回调
+    
+    explicit State(ResultCallback callback) : done(std::move(callback)) {}
+    
+    /**
+     * @brief 完成请求（只有第一次调用生效）
+     */
+    void complete(RpcResult result) {
+        if (completed.exchange(true)) {
+            return;
+        }
+        ResultCallback callback = std::move(done);
+        callback(std::move(result));
+    }
+    
+    ~State() {
+        if (!completed.load()) {
+            try {
+                complete(RpcResult::err(-32603, "Method returned without replying"));
+            } catch (const std::exception& e) {
+                std::cerr << "Error completing abandoned reply: " << e.what() << std::endl;
+            }
+        }
     }
-    return it->second(params);
+};
+
+/**
+ * @brief 创建回复句柄
+ * @param done 完成回调
+ */
+ReplyHandle::ReplyHandle(DispatchCallback done) : ReplyHandle(to_result_callback(std::move(done))) {}
+
+/**
+ * @brief 创建回复句柄（以结果对象完成）
+ * @param done 完成回调
+ */
+ReplyHandle::ReplyHandle(ResultCallback done) : state_(std::make_shared<State>(std::move(done))) {}
+
+/**
+ * @brief 以结果完成请求
+ * @param result 方法执行结果
+ */
+void ReplyHandle::resolve(json result) const {
+    state_->complete(RpcResult::ok(std::move(result)));
+}
+
+/**
+ * @brief 以异常完成请求
+ * @param error 异常
+ */
+void ReplyHandle::reject(std::exception_ptr error) const {
+    state_->complete(RpcResult::from_exception(std::move(error)));
+}
+
+/**
+ * @brief 以错误代码完成请求
+ * @param code JSON-RPC 错误代码
+ * @param message 错误消息
+ * @param data 附加错误数据
+ */
+void ReplyHandle::reject(int code, const std::string& message, const json& data) const {
+    state_->complete(RpcResult::err(code, message, data));
+}
+
+/**
+ * @brief 以结果对象完成请求
+ * @param result 成功值或错误信息
+ */
+void ReplyHandle::complete(RpcResult result) const {
+    state_->complete(std::move(result));
+}
+
+/**
+ * @brief 请求是否已经完成
+ * @return 已完成时返回 true
+ */
+bool ReplyHandle::is_completed() const {
+    return state_->completed.load();
+}
+
+/**
+ * @struct Server::State
+ * @brief 服务器运行状态
+ * 
+ * Zenoh 回调和工作线程任务通过 shared_ptr 共享此状态，
+ * 即使 Server 对象先于回调销毁也不会访问悬空内存。
+ */
+struct Server::State {
+    std::mutex mutex;                ///< 保护以下字段
+    std::condition_variable cv;      ///< in_flight 归零或 running 变化时通知
+    bool accepting = false;          ///< 是否接受新的查询和通知
+    bool running = false;            ///< start() 之后、stop() 完成之前为 true
+    size_t in_flight = 0;            ///< 正在处理（含排队）的查询和通知数
+    
+    std::atomic<uint64_t> queries{0};        ///< 已处理的查询数
+    std::atomic<uint64_t> notifications{0};  ///< 已执行的通知数
+    std::atomic<uint64_t> errors{0};         ///< 回复的错误响应数
+    std::atomic<uint64_t> rejected{0};       ///< 被拒绝的查询和丢弃的通知数
+    
+    /**
+     * @brief 登记一个新的处理任务
+     * @return 服务器正在接受请求时返回 true
+     */
+    bool try_enter() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!accepting) {
+            return false;
+        }
+        in_flight++;
+        return true;
+    }
+    
+    /**
+     * @brief 结束一个处理任务
+     */
+    void leave() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--in_flight == 0) {
+            cv.notify_all();
+        }
+    }
+    
+    /**
+     * @brief 获取计数器快照
+     */
+    ServerStats stats() const {
+        ServerStats stats;
+        stats.queries = queries.load(std::memory_order_relaxed);
+        stats.notifications = notifications.load(std::memory_order_relaxed);
+        stats.errors = errors.load(std::memory_order_relaxed);
+        stats.rejected = rejected.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+namespace {
+
+/**
+ * @class InFlightTicket
+ * @brief 在途任务凭证
+ * 
+ * 析构时结束登记。随任务一起移动，
+ * 任务无论正常执行还是被丢弃都只结束一次。
+ */
+class InFlightTicket {
+public:
+    explicit InFlightTicket(std::shared_ptr<Server::State> state) : state_(std::move(state)) {}
+    InFlightTicket(InFlightTicket&& other) noexcept = default;
+    InFlightTicket(const InFlightTicket&) = delete;
+    InFlightTicket& operator=(const InFlightTicket&) = delete;
+    ~InFlightTicket() {
+        if (state_) {
+            state_->leave();
+        }
+    }
+    
+    /// 所属服务器的运行状态
+    Server::State& state() const { return *state_; }
+
+private:
+    std::shared_ptr<Server::State> state_;
+};
+
+/**
+ * @struct ReplyContext
+ * @brief 等待回复的查询
+ * 
+ * 复制的查询句柄使查询在回调返回后仍然有效，
+ * 直到工作线程或异步方法的回复句柄发送回复。
+ * 上下文销毁时结束在途登记，Zenoh 随之结束该查询。
+ */
+struct ReplyContext {
+    zenoh::Query query;                         ///< 查询句柄
+    InFlightTicket ticket;                      ///< 在途登记
+    EncodingType encoding = EncodingType::JSON; ///< 回复编码（与请求一致）
+    size_t shards = 0;                          ///< 回复附带的分片数（0 表示不附带）
+    const ShmPool* shm = nullptr;               ///< 大回复使用的共享内存池
+};
+
+/**
+ * @struct Response
+ * @brief 单个请求的响应
+ * 
+ * 以组成部分保存结果或错误：单个请求的回复直接从组成部分编码，不构造响应对象；
+ * 批量请求的条目在组装响应数组时才转换为响应对象（结果移动，不复制）。
+ */
+struct Response {
+    MessageParts::Kind kind = MessageParts::Kind::NOTIFICATION;  ///< NOTIFICATION 表示不回复
+    std::string id;         ///< 请求ID
+    json result;            ///< 成功响应的结果
+    int code = 0;           ///< 错误代码
+    std::string message;    ///< 错误消息
+    json data;              ///< 错误附加数据
+    
+    /**
+     * @brief 成功响应
+     */
+    static Response ok(json result, std::string id) {
+        Response response;
+        response.kind = MessageParts::Kind::RESPONSE_OK;
+        response.id = std::move(id);
+        response.result = std::move(result);
+        return response;
+    }
+    
+    /**
+     * @brief 错误响应
+     */
+    static Response error(int code, std::string message, std::string id, json data = nullptr) {
+        Response response;
+        response.kind = MessageParts::Kind::RESPONSE_ERR;
+        response.id = std::move(id);
+        response.code = code;
+        response.message = std::move(message);
+        response.data = std::move(data);
+        return response;
+    }
+    
+    /**
+     * @brief 由方法的结果对象构造响应（移走结果或错误信息）
+     */
+    static Response from(RpcResult result, std::string id) {
+        if (result) {
+            return ok(std::move(result).value(), std::move(id));
+        }
+        RpcErrorInfo error = std::move(result).error();
+        return Response::error(error.code, std::move(error.message), std::move(id), std::move(error.data));
+    }
+    
+    /**
+     * @brief 是否需要回复（通知不回复）
+     */
+    bool empty() const { return kind == MessageParts::Kind::NOTIFICATION; }
+    
+    /**
+     * @brief 是否为错误响应
+     */
+    bool is_error() const { return kind == MessageParts::Kind::RESPONSE_ERR; }
+    
+    /**
+     * @brief 引用本响应的组成部分
+     */
+    MessageParts parts() const {
+        return is_error() ? MessageParts::response_err(code, message, id, &data) : MessageParts::response_ok(result, id);
+    }
+    
+    /**
+     * @brief 转换为响应对象（移走结果和附加数据）
+     */
+    json take() {
+        return is_error() ? make_response_err(code, message, id, data) : make_response_ok(std::move(result), id);
+    }
+};
+
+/// 单个请求的完成回调：通知以空响应调用
+using ResponseCallback = std::function<void(Response response)>;
+
+/// 批量请求的完成回调：参数为响应数组、单个错误响应或 null（不回复）
+using BatchCallback = std::function<void(json response)>;
+
+/**
+ * @brief 确定载荷的编码类型
+ * @param encoding 对端附带的 Zenoh Encoding（可以为空）
+ * @param payload 载荷
+ * @return 编码类型
+ * 
+ * 优先使用对端附带的 Zenoh Encoding；
+ * 对端没有标记或标记无法识别时，根据载荷首字节推测。
+ */
+EncodingType detect_encoding(const zenoh::Encoding* encoding, const PayloadView& payload) {
+    if (encoding) {
+        if (auto type = encoding_from_mime(encoding->as_string())) {
+            return *type;
+        }
+    }
+    return payload.sniff();
+}
+
+/**
+ * @brief 确定查询载荷的编码类型
+ * @param query Zenoh 查询
+ * @param payload 查询载荷
+ * @return 编码类型
+ */
+EncodingType detect_encoding(const zenoh::Query& query, const PayloadView& payload) {
+    auto encoding_opt = query.get_encoding();
+    return detect_encoding(encoding_opt.has_value() ? &encoding_opt->get() : nullptr, payload);
+}
+
+/**
+ * @brief 创建回复选项
+ * @param encoding 编码类型（与请求一致）
+ * @param shards 附带的分片数（0 表示不附带附件）
+ */
+zenoh::Query::ReplyOptions reply_options(EncodingType encoding, size_t shards) {
+    zenoh::Query::ReplyOptions options;
+    options.encoding = zenoh::Encoding(encoding_mime(encoding));
+    if (shards > 0) {
+        options.attachment = zenoh::Bytes(make_shards_attachment(shards));
+    }
+    return options;
+}
+
+/**
+ * @brief 以指定编码发送回复
+ * @param query Zenoh 查询
+ * @param message 回复的 JSON-RPC 消息
+ * @param encoding 编码类型（与请求一致）
+ * @param shards 附带的分片数（0 表示不附带附件）
+ * @param shm 共享内存池（可以为空）
+ */
+void send_reply(const zenoh::Query& query, const json& message, EncodingType encoding, size_t shards = 0,
+                const ShmPool* shm = nullptr) {
+    query.reply(query.get_keyexpr(), encode_payload(message, encoding, shm), reply_options(encoding, shards));
+}
+
+/**
+ * @brief 以指定编码发送回复（不构造响应对象）
+ * @param query Zenoh 查询
+ * @param parts 回复的组成部分
+ * @param encoding 编码类型（与请求一致）
+ * @param shards 附带的分片数（0 表示不附带附件）
+ * @param shm 共享内存池（可以为空）
+ */
+void send_reply(const zenoh::Query& query, const MessageParts& parts, EncodingType encoding, size_t shards = 0,
+                const ShmPool* shm = nullptr) {
+    query.reply(query.get_keyexpr(), encode_payload(parts, encoding, shm), reply_options(encoding, shards));
+}
+
+/**
+ * @brief 检查参数是否超过大小限制
+ * @param message 请求或通知的信封
+ * @param options 服务器配置
+ * @return 未配置限制或参数不超过限制时返回 true
+ */
+bool params_within_limit(const Envelope& message, const ServerOptions& options) {
+    return options.max_params_size == 0 || message.params.size() <= options.max_params_size;
+}
+
+/**
+ * @brief 用于日志的方法名
+ * @param message 请求或通知的信封
+ * @return 方法名；以方法ID表示时为 "#<方法ID>"
+ */
+std::string method_label(const Envelope& message) {
+    return message.method_kind == ValueKind::NUMBER ? "#" + std::to_string(message.method_id) : message.method;
+}
+
+/**
+ * @brief 查找请求的目标方法，不存在时返回对应的错误结果
+ * @param dispatcher 方法分发器
+ * @param message 请求或通知的信封
+ * @return 方法存在时为空；否则为 -32601 或 -32003 错误结果
+ */
+std::optional<RpcResult> check_target(const DispatcherBase& dispatcher, const Envelope& message) {
+    if (message.method_kind == ValueKind::NUMBER) {
+        if (dispatcher.has_method(message.method_id)) {
+            return std::nullopt;
+        }
+        return stale_method_id(message.method_id);
+    }
+    if (dispatcher.has_method(message.method)) {
+        return std::nullopt;
+    }
+    return method_not_found(message.method);
+}
+
+/**
+ * @brief 按方法名或方法ID分发
+ * @param dispatcher 方法分发器
+ * @param message 请求或通知的信封
+ * @param params 已解析的参数
+ * @param done 完成回调
+ */
+void dispatch_target(DispatcherBase& dispatcher, const Envelope& message, const json& params, ResultCallback done) {
+    if (message.method_kind == ValueKind::NUMBER) {
+        dispatcher.try_dispatch_async(message.method_id, params, std::move(done));
+    } else {
+        dispatcher.try_dispatch_async(message.method, params, std::move(done));
+    }
+}
+
+/**
+ * @brief 执行 JSON-RPC 通知
+ * @param dispatcher 方法分发器
+ * @param notification 通知的信封
+ * @param options 服务器配置
+ * @param keep_alive 在方法完成前保持有效的对象（在途登记），可以为空
+ * 
+ * 通知没有回复，方法执行中的错误只记录到标准错误输出。
+ * 参数在分发前才从原始字节解析；方法不存在或参数过大时不解析参数。
+ * 异步方法在回复句柄完成时才释放 keep_alive。
+ */
+void process_notification(DispatcherBase& dispatcher, const Envelope& notification, const ServerOptions& options,
+                          std::shared_ptr<void> keep_alive = nullptr) {
+    std::string name = method_label(notification);
+    if (std::optional<RpcResult> missing = check_target(dispatcher, notification)) {
+        std::cerr << "Notification '" << name << "' failed: " << missing->error().message << std::endl;
+        return;
+    }
+    if (!params_within_limit(notification, options)) {
+        std::cerr << "Notification '" << name << "' failed: Invalid params: " << notification.params.size()
+                  << " bytes exceeds limit of " << options.max_params_size << std::endl;
+        return;
+    }
+    json params;
+    try {
+        params = notification.parse_params();
+    } catch (const std::exception& e) {
+        std::cerr << "Notification '" << name << "' failed: " << e.what() << std::endl;
+        return;
+    }
+    dispatch_target(dispatcher, notification, params,
+        [method = std::move(name), keep_alive = std::move(keep_alive)](RpcResult result) {
+            if (!result) {
+                std::cerr << "Notification '" << method << "' failed: " << result.error().message << std::endl;
+            }
+        });
+}
+
+/**
+ * @brief 处理单个 JSON-RPC 请求
+ * @param dispatcher 方法分发器
+ * @param request 请求的信封
+ * @param options 服务器配置
+ * @param done 响应完成回调；请求为通知时以空响应调用
+ * @param keep_alive 在方法完成前保持有效的对象（用于通知），可以为空
+ * 
+ * 验证请求格式并分发方法调用，所有错误都转换为错误响应，不会抛出异常。
+ * 信封字段已经在扫描时提取；方法不存在或参数超过 max_params_size 时
+ * 直接回复错误，不解析参数。保留方法 "rpc.methods" 回复分发器的方法ID映射，
+ * 以方法ID表示的请求按位置分发，方法ID失效时回复 -32003。
+ * 同步方法在返回前调用 done，异步方法在其回复句柄完成时调用 done。
+ * 单个请求和批量请求中的每个条目都使用此函数处理。
+ */
+void process_request(DispatcherBase& dispatcher, const Envelope& request, const ServerOptions& options,
+                     ResponseCallback done, std::shared_ptr<void> keep_alive = nullptr) {
+    // 通知只执行，不生成响应
+    if (request.is_valid_notification()) {
+        process_notification(dispatcher, request, options, std::move(keep_alive));
+        done(Response());
+        return;
+    }
+    
+    // 验证 JSON-RPC 请求格式（服务器只接受字符串 id）
+    bool has_id = request.id_kind == ValueKind::STRING;
+    if (!request.is_valid_request() || !has_id) {
+        done(Response::error(-32600, "Invalid Request", has_id ? request.id : "null"));
+        return;
+    }
+    
+    const std::string& id = request.id;
+    if (request.method_kind == ValueKind::STRING && request.method == kMethodIdsMethod) {
+        done(Response::ok(dispatcher.method_ids(), id));
+        return;
+    }
+    
+    // 在解析参数之前拒绝不存在的方法和过大的参数
+    if (std::optional<RpcResult> missing = check_target(dispatcher, request)) {
+        done(Response::from(std::move(*missing), id));
+        return;
+    }
+    if (!params_within_limit(request, options)) {
+        done(Response::error(-32602, "Invalid params: " + std::to_string(request.params.size()) +
+                             " bytes exceeds limit of " + std::to_string(options.max_params_size), id));
+        return;
+    }
+    
+    json params;
+    try {
+        params = request.parse_params();
+    } catch (...) {
+        done(Response::from(RpcResult::from_exception(std::current_exception()), id));
+        return;
+    }
+    
+    // 分发方法调用，结果或错误信息移动进响应，不复制，也不经过异常
+    dispatch_target(dispatcher, request, params, [id, done = std::move(done)](RpcResult result) {
+        done(Response::from(std::move(result), id));
+    });
+}
+
+/**
+ * @struct BatchCollector
+ * @brief 批量请求的响应收集器
+ * 
+ * 每个条目完成时写入对应位置，最后一个完成的条目组装响应数组并调用完成回调。
+ */
+struct BatchCollector {
+    std::mutex mutex;                   ///< 保护 responses 和 remaining
+    std::vector<Response> responses;    ///< 与请求数组顺序相同的响应
+    size_t remaining;                   ///< 尚未完成的条目数
+    BatchCallback done;                 ///< 批量完成回调
+    
+    BatchCollector(size_t size, BatchCallback callback)
+        : responses(size), remaining(size), done(std::move(callback)) {}
+    
+    /**
+     * @brief 记录一个条目的响应
+     * @param index 条目位置
+     * @param response 响应（通知为空响应）
+     */
+    void complete(size_t index, Response response) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            responses[index] = std::move(response);
+            if (--remaining > 0) {
+                return;
+            }
+        }
+        
+        json result = json::array();
+        for (auto& entry : responses) {
+            if (!entry.empty()) {
+                result.push_back(entry.take());
+            }
+        }
+        done(result.empty() ? json(nullptr) : std::move(result));
+    }
+};
+
+/**
+ * @struct BatchChunks
+ * @brief 并行分发的批量块
+ * 
+ * 块由处理批量请求的线程和提交到执行器的任务共同领取，每个块只执行一次。
+ * 处理线程领取完剩余的块后只等待其他线程正在执行的块，不等待仍在队列中的任务，
+ * 因此执行器的工作线程全部被占用时也不会死锁。
+ * 所有块都被领取后才开始运行的任务直接返回，不再访问批量请求。
+ */
+struct BatchChunks {
+    std::function<void(size_t)> run;    ///< 执行一个块（引用处理线程栈上的批量请求）
+    size_t count;                       ///< 块数
+    std::atomic<size_t> next{0};        ///< 下一个待领取的块
+    std::mutex mutex;                   ///< 保护 finished
+    std::condition_variable all_done;   ///< 所有块执行完时通知
+    size_t finished = 0;                ///< 已执行完的块数
+    
+    BatchChunks(std::function<void(size_t)> runner, size_t chunks)
+        : run(std::move(runner)), count(chunks) {}
+    
+    /// 领取并执行块，直到没有剩余的块
+    void drain() {
+        for (size_t chunk = next.fetch_add(1); chunk < count; chunk = next.fetch_add(1)) {
+            run(chunk);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (++finished == count) {
+                all_done.notify_all();
+            }
+        }
+    }
+    
+    /// 等待所有块执行完
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [this] { return finished == count; });
+    }
+};
+
+/**
+ * @brief 处理 JSON-RPC 批量请求
+ * @param dispatcher 方法分发器
+ * @param message 扫描得到的批量请求
+ * @param options 服务器配置
+ * @param done 完成回调：响应数组；批量请求本身无效时为单个错误响应；全部为通知时为 null
+ * 
+ * batch_parallelism 大于1且服务器有执行器时，条目被分成若干连续的块，
+ * 除当前线程执行的块外，其余块提交到服务器的执行器，不创建新线程；
+ * 执行器队列已满或工作线程都在忙时，当前线程自己执行这些块。
+ * 响应数组保持与请求数组相同的顺序，通知条目不产生响应。
+ * 每个条目完成时交给收集器，最后一个完成的条目（包括异步方法）调用 done。
+ */
+void process_batch(DispatcherBase& dispatcher, const ScannedMessage& message, const ServerOptions& options,
+                   BatchCallback done) {
+    const std::vector<Envelope>& batch = message.entries;
+    if (batch.empty()) {
+        done(make_response_err(-32600, "Invalid Request: empty batch", "null"));
+        return;
+    }
+    if (batch.size() > options.max_batch_size) {
+        done(make_response_err(-32600, "Invalid Request: batch of " + std::to_string(batch.size()) +
+                               " entries exceeds limit of " + std::to_string(options.max_batch_size), "null"));
+        return;
+    }
+    
+    auto collector = std::make_shared<BatchCollector>(batch.size(), std::move(done));
+    size_t chunks = options.executor ? std::min(std::max<size_t>(options.batch_parallelism, 1), batch.size()) : 1;
+    size_t chunk_size = (batch.size() + chunks - 1) / chunks;
+    
+    auto run_chunk = [&](size_t chunk) {
+        size_t begin = chunk * chunk_size;
+        size_t end = std::min(begin + chunk_size, batch.size());
+        for (size_t i = begin; i < end; ++i) {
+            process_request(dispatcher, batch[i], options, [collector, i](Response response) {
+                collector->complete(i, std::move(response));
+            });
+        }
+    };
+    if (chunks == 1) {
+        run_chunk(0);
+        return;
+    }
+    
+    // 条目引用查询载荷，当前线程返回前必须等待其他线程正在执行的块
+    auto shared = std::make_shared<BatchChunks>(run_chunk, chunks);
+    for (size_t i = 1; i < chunks; ++i) {
+        if (!options.executor->try_submit([shared] { shared->drain(); })) {
+            break;
+        }
+    }
+    shared->drain();
+    shared->wait();
+}
+
+/**
+ * @brief 统计响应中的错误数
+ * @param response 单个响应或批量响应数组
+ * @return 错误响应的数量
+ */
+uint64_t count_errors(const json& response) {
+    if (response.is_array()) {
+        return static_cast<uint64_t>(std::count_if(response.begin(), response.end(),
+            [](const json& entry) { return entry.contains("error"); }));
+    }
+    return response.is_object() && response.contains("error") ? 1 : 0;
+}
+
+/**
+ * @brief 发送回复并累计错误数
+ * @param context 查询及其回复编码
+ * @param message 回复的组成部分或批量响应数组
+ * @param errors 回复中的错误响应数
+ * 
+ * 发送失败只记录到标准错误输出。
+ */
+template<typename Message>
+void deliver_reply(ReplyContext& context, const Message& message, uint64_t errors) {
+    context.ticket.state().errors.fetch_add(errors, std::memory_order_relaxed);
+    try {
+        send_reply(context.query, message, context.encoding, context.shards, context.shm);
+    } catch (const std::exception& e) {
+        std::cerr << "Error sending reply: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 处理单个查询
+ * @param dispatcher 方法分发器
+ * @param context 查询及其在途登记
+ * @param options 服务器配置
+ * 
+ * 完成解码、验证、方法分发、编码和回复的完整流程。
+ * 载荷为数组时按 JSON-RPC 批量请求处理，以一个响应数组回复。
+ * 回复使用与请求相同的编码格式；单个请求的回复直接从结果编码，不构造响应对象。
+ * 可以在 Zenoh 回调线程中直接调用，也可以在工作线程中调用；
+ * 异步方法完成时在其回复线程中发送回复，context 保持到回复发送之后。
+ */
+void handle_query(DispatcherBase& dispatcher, std::shared_ptr<ReplyContext> context, const ServerOptions& options) {
+    Server::State& state = context->ticket.state();
+    try {
+        // 获取查询载荷
+        auto payload_opt = context->query.get_payload();
+        if (!payload_opt.has_value()) {
+            std::cerr << "Received query without payload" << std::endl;
+            return;
+        }
+        state.queries.fetch_add(1, std::memory_order_relaxed);
+        
+        // 直接在 Zenoh 缓冲区上扫描，不复制载荷
+        PayloadView payload(payload_opt->get());
+        context->encoding = detect_encoding(context->query, payload);
+        context->shards = options.shard_count;
+        context->shm = options.shm;
+        
+        // 单遍扫描信封，参数保持为原始字节，分发前才解析
+        ScannedMessage message;
+        try {
+            message = scan_message(payload.data(), payload.size(), context->encoding);
+        } catch (const ParseError& e) {
+            state.errors.fetch_add(1, std::memory_order_relaxed);
+            send_reply(context->query, MessageParts::response_err(-32700, e.what(), "null"), context->encoding,
+                       context->shards);
+            return;
+        }
+        
+        // 通知（或全部由通知组成的批量请求）不回复
+        if (message.is_batch) {
+            process_batch(dispatcher, message, options, [context](json response) {
+                if (!response.is_null()) {
+                    deliver_reply(*context, response, count_errors(response));
+                }
+            });
+        } else {
+            process_request(dispatcher, message.entries.front(), options, [context](Response response) {
+                if (!response.empty()) {
+                    deliver_reply(*context, response.parts(), response.is_error() ? 1 : 0);
+                }
+            });
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error processing query: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 处理通过 put 发布的通知
+ * @param dispatcher 方法分发器
+ * @param bytes 样本载荷
+ * @param encoding 样本附带的 Zenoh Encoding（可以为空）
+ * @param options 服务器配置
+ * @param ticket 在途登记，异步方法完成后才释放
+ * 
+ * 订阅路径从不回复。载荷可以是单个通知或由通知组成的批量数组，
+ * 带 id 的请求无法通过 put 回复，会被忽略。
+ */
+void handle_notification(DispatcherBase& dispatcher, const zenoh::Bytes& bytes, const zenoh::Encoding* encoding,
+                         const ServerOptions& options, std::shared_ptr<InFlightTicket> ticket) {
+    Server::State& state = ticket->state();
+    try {
+        PayloadView payload(bytes);
+        ScannedMessage message = scan_message(payload.data(), payload.size(), detect_encoding(encoding, payload));
+        
+        for (const auto& entry : message.entries) {
+            if (entry.is_valid_notification()) {
+                state.notifications.fetch_add(1, std::memory_order_relaxed);
+                process_notification(dispatcher, entry, options, ticket);
+            } else {
+                std::cerr << "Ignoring published message that is not a valid notification" << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error processing notification: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 以 -32000 错误拒绝查询
+ * @param query Zenoh 查询
+ * @param message 错误消息（"Server busy" 或 "Server shutting down"）
+ * @param state 服务器运行状态（更新计数器）
+ * 
+ * 工作队列已满或服务器正在停止时在回调线程中直接回复，
+ * 只扫描出请求ID以便客户端匹配响应，不解析参数。
+ * 批量请求以单个错误响应整体拒绝。
+ */
+void reply_rejected(const zenoh::Query& query, const std::string& message, Server::State& state) {
+    state.rejected.fetch_add(1, std::memory_order_relaxed);
+    try {
+        auto payload_opt = query.get_payload();
+        if (!payload_opt.has_value()) {
+            return;
+        }
+        PayloadView payload(payload_opt->get());
+        EncodingType encoding = detect_encoding(query, payload);
+        Envelope request = scan_envelope(payload.data(), payload.size(), encoding);
+        std::string_view id = request.id_kind == ValueKind::STRING ? std::string_view(request.id) : "null";
+        send_reply(query, MessageParts::response_err(-32000, message, id), encoding);
+    } catch (const std::exception& e) {
+        std::cerr << "Error rejecting query: " << e.what() << std::endl;
+    }
+}
+
+} // namespace
+
+
+/**
+ * @brief 创建服务器（不立即开始服务）
+ * @param key_expr Zenoh 键表达式
+ * @param dispatcher 方法分发器
+ * @param session Zenoh 会话
+ * @param options 服务器配置
+ */
+Server::Server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session, const ServerOptions& options)
+    : key_expr_(key_expr)
+    , dispatcher_(dispatcher)
+    , session_(session)
+    , options_(options)
+    , state_(std::make_shared<State>()) {}
+
+/**
+ * @brief 析构函数
+ * 
+ * 服务器仍在运行时按默认期限停止。
+ */
+Server::~Server() {
+    stop();
+}
+
+/**
+ * @brief 声明可查询对象和通知订阅者，开始服务
+ * @throws std::logic_error 当服务器已经在运行时
+ * 
+ * 配置了执行器时，Zenoh 回调只复制查询句柄并放入执行器队列，
+ * 解码、分发、编码和回复在工作线程中完成，
+ * 队列已满时直接回复 -32000 "Server busy"。
+ * 未配置执行器时在 Zenoh 回调线程中直接处理查询。
+ * 异步方法的查询在回复句柄完成时才回复，在此之前计入在途请求。
+ * 
+ * 订阅者执行客户端通过 put 发布的通知，从不回复。
+ * 启动时发布分发器的方法表（见 DispatcherBase::publish()），运行期间仍可注册和注销方法。
+ * 停止后可以再次调用 start()。
+ */
+void Server::start() {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->running) {
+            throw std::logic_error("Server on '" + key_expr_ + "' is already running");
+        }
+        dispatcher_.publish();
+        state_->accepting = true;
+        state_->running = true;
+    }
+    
+    DispatcherBase& dispatcher = dispatcher_;
+    const ServerOptions options = options_;
+    std::shared_ptr<State> state = state_;
+    
+    std::function<void(const zenoh::Query&)> on_query;
+    std::function<void(const zenoh::Sample&)> on_sample;
+    
+    if (options.executor) {
+        on_query = [&dispatcher, options, state](const zenoh::Query& query) {
+            if (!state->try_enter()) {
+                reply_rejected(query, "Server shutting down", *state);
+                return;
+            }
+            auto context = std::make_shared<ReplyContext>(ReplyContext{query, InFlightTicket(state)});
+            if (!options.executor->submit([&dispatcher, context, options]() {
+                    handle_query(dispatcher, context, options);
+                })) {
+                reply_rejected(query, "Server busy", *state);
+            }
+        };
+        
+        on_sample = [&dispatcher, options, state](const zenoh::Sample& sample) {
+            if (!state->try_enter()) {
+                return;
+            }
+            // zenoh::Bytes 和 zenoh::Encoding 的复制只增加引用计数，不复制载荷
+            auto ticket = std::make_shared<InFlightTicket>(state);
+            if (!options.executor->submit([&dispatcher, payload = sample.get_payload(), encoding = sample.get_encoding(),
+                                           options, ticket]() {
+                    handle_notification(dispatcher, payload, &encoding, options, ticket);
+                })) {
+                state->rejected.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "Dropping notification: server busy" << std::endl;
+            }
+        };
+    } else {
+        // 在 Zenoh 回调线程中直接处理查询和通知
+        on_query = [&dispatcher, options, state](const zenoh::Query& query) {
+            if (!state->try_enter()) {
+                reply_rejected(query, "Server shutting down", *state);
+                return;
+            }
+            handle_query(dispatcher, std::make_shared<ReplyContext>(ReplyContext{query, InFlightTicket(state)}), options);
+        };
+        
+        on_sample = [&dispatcher, options, state](const zenoh::Sample& sample) {
+            if (!state->try_enter()) {
+                return;
+            }
+            handle_notification(dispatcher, sample.get_payload(), &sample.get_encoding(), options,
+                                std::make_shared<InFlightTicket>(state));
+        };
+    }
+    
+    try {
+        // 声明可查询对象（请求）和订阅者（通知）
+        queryable_.emplace(session_.declare_queryable(key_expr_, std::move(on_query)));
+        subscriber_.emplace(session_.declare_subscriber(key_expr_, std::move(on_sample)));
+    } catch (...) {
+        queryable_.reset();
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->accepting = false;
+        state_->running = false;
+        throw;
+    }
+}
+
+/**
+ * @brief 停止服务器并等待在途请求完成
+ * @param drain_timeout 等待在途请求完成的最长时间
+ * @return 所有在途请求在期限内完成时返回 true
+ * 
+ * 停止流程：
+ * 1. 停止接受：此后到达的查询回复 -32000 "Server shutting down"，通知被忽略
+ * 2. 撤销可查询对象和订阅者，路由不再把新查询发往本实例
+ *    （滚动重启时由其他实例接手）
+ * 3. 等待已接受的查询和通知（包括执行器队列中的）处理完成，最多 drain_timeout
+ * 4. 唤醒 wait()
+ * 
+ * 返回 false 时仍有处理器在运行，分发器必须保持有效直到它们结束。
+ * 服务器未运行时直接返回 true。
+ */
+bool Server::stop(std::chrono::milliseconds drain_timeout) {
+    std::lock_guard<std::mutex> lifecycle(lifecycle_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->running) {
+            return true;
+        }
+        state_->accepting = false;
+    }
+    
+    queryable_.reset();
+    subscriber_.reset();
+    
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    bool drained = state_->cv.wait_for(lock, drain_timeout, [this] { return state_->in_flight == 0; });
+    state_->running = false;
+    state_->cv.notify_all();
+    return drained;
+}
+
+/**
+ * @brief 阻塞直到服务器被停止
+ * 
+ * 服务器未运行时立即返回。
+ */
+void Server::wait() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [this] { return !state_->running; });
+}
+
+/**
+ * @brief 服务器是否正在运行
+ * @return start() 之后、stop() 完成之前返回 true
+ */
+bool Server::is_running() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->running;
+}
+
+/**
+ * @brief 获取服务器计数器
+ * @return 计数器快照（跨 stop()/start() 累计）
+ */
+ServerStats Server::stats() const {
+    return state_->stats();
+}
+
+/**
+ * @brief 正在处理的查询和通知数
+ * @return 在途数量（包括执行器队列中等待的）
+ */
+size_t Server::in_flight() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->in_flight;
 }
 
 /**
@@ -49,73 +1446,56 @@ json DispatcherBase::dispatch(const std::string& method_name, const json& params
  * 
  * 处理流程：
  * 1. 接收 Zenoh 查询请求
- * 2. 解析 JSON-RPC 请求
+ * 2. 解析 JSON-RPC 请求（单个或批量）
  * 3. 验证请求格式
  * 4. 调用对应的方法处理器
  * 5. 生成并发送 JSON-RPC 响应
  */
 void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session) {
-    std::cout << "Starting RPC server on '" << key_expr << "'..." << std::endl;
-    
-    // 定义查询处理回调函数
-    auto on_query = [&dispatcher](const zenoh::Query& query) {
-        try {
-            // 获取查询载荷
-            auto payload_opt = query.get_payload();
-            if (!payload_opt.has_value()) {
-                std::cerr << "Received query without payload" << std::endl;
-                return;
-            }
-            
-            std::string payload_str = payload_opt->get().as_string();
-            std::cout << "Received query with payload: " << payload_str << std::endl;
-            
-            // 解码 JSON-RPC 请求
-            json request = decode_json(payload_str);
-            
-            // 验证 JSON-RPC 请求格式
-            if (!request.contains("jsonrpc") || request["jsonrpc"] != "2.0" ||
-                !request.contains("method") || !request.contains("id")) {
-                json error_response = make_response_err(-32600, "Invalid Request", 
-                    request.contains("id") ? request["id"].get<std::string>() : "null");
-                query.reply(query.get_keyexpr(), encode_json(error_response));
-                return;
-            }
-            
-            // 提取请求字段
-            std::string method = request["method"];
-            json params = request.contains("params") ? request["params"] : json::object();
-            std::string id = request["id"];
-            
-            try {
-                // 分发方法调用
-                json result = dispatcher.dispatch(method, params);
-                json response = make_response_ok(result, id);
-                query.reply(query.get_keyexpr(), encode_json(response));
-            } catch (const RpcError& e) {
-                // 处理 RPC 错误，包含正确的错误代码和数据
-                json error_response = make_response_err(e.get_code(), e.what(), id, e.get_data());
-                query.reply(query.get_keyexpr(), encode_json(error_response));
-            } catch (const std::exception& e) {
-                // 处理其他异常
-                json error_response = make_response_err(-32603, "Internal error: " + std::string(e.what()), id);
-                query.reply(query.get_keyexpr(), encode_json(error_response));
-            }
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Error processing query: " << e.what() << std::endl;
-        }
-    };
+    run_server(key_expr, dispatcher, session, ServerOptions());
+}
+
+/**
+ * @brief 运行 RPC 服务器（使用现有会话和工作线程池）
+ * @param key_expr Zenoh 键表达式，用于标识服务
+ * @param dispatcher 方法分发器引用
+ * @param session 现有的 Zenoh 会话引用
+ * @param executor 处理请求的执行器
+ */
+void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session, Executor& executor) {
+    ServerOptions options;
+    options.executor = &executor;
+    run_server(key_expr, dispatcher, session, options);
+}
+
+/**
+ * @brief 运行 RPC 服务器（使用现有会话和服务器配置）
+ * @param key_expr Zenoh 键表达式，用于标识服务
+ * @param dispatcher 方法分发器引用
+ * @param session 现有的 Zenoh 会话引用
+ * @param options 服务器配置
+ * 
+ * 配置了执行器时，Zenoh 回调只复制查询句柄并放入执行器队列，
+ * 解码、分发、编码和回复在工作线程中完成，
+ * 队列已满时直接回复 -32000 "Server busy"。
+ * 未配置执行器时在 Zenoh 回调线程中直接处理查询。
+ * 异步方法的查询在回复句柄完成时才回复，在此之前计入在途请求。
+ * 
+ * 服务器同时订阅同一键表达式，执行客户端通过 put 发布的通知，从不回复。
+ */
+void run_server(const std::string& key_expr, DispatcherBase& dispatcher, Session& session, const ServerOptions& options) {
+    if (options.executor) {
+        std::cout << "Starting RPC server on '" << key_expr << "' with "
+                  << options.executor->num_threads() << " worker threads..." << std::endl;
+    } else {
+        std::cout << "Starting RPC server on '" << key_expr << "'..." << std::endl;
+    }
     
-    // 声明可查询对象
-    auto queryable = session.declare_queryable(key_expr, on_query);
+    Server server(key_expr, dispatcher, session, options);
+    server.start();
     
     std::cout << "RPC server running. Press Ctrl+C to stop..." << std::endl;
-    
-    // 保持服务器运行
-    while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+    server.wait();
 }
 
 /**
@@ -0,0 +1,375 @@
+#include "zenoh_rpc/message_parts.hpp"
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+#include <cstdint>
+#include <string>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/**
+ * @brief 判断字符串可以原样放进 JSON 字符串
+ * @return 只包含可打印 ASCII 且没有 '"' 和 '\\' 时返回 true
+ */
+bool is_plain_text(std::string_view text) {
+    for (char c : text) {
+        if (c < 0x20 || c > 0x7e || c == '"' || c == '\\') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @class JsonMessageWriter
+ * @brief 以紧凑 JSON 追加写入 out
+ * 
+ * 值使用与 encode_json_into() 相同的 append_json()（非法 UTF-8 抛出异常），
+ * 键、固定的 "2.0" 和整数直接追加。
+ */
+class JsonMessageWriter {
+public:
+    explicit JsonMessageWriter(std::string& out) : out_(out) {}
+    
+    /// 追加原样的文本
+    void raw(const char* text) { out_.append(text); }
+    
+    /// 追加 JSON 字符串（需要转义时交给序列化器）
+    void text(std::string_view text) {
+        if (!is_plain_text(text)) {
+            value(json(std::string(text)));
+            return;
+        }
+        out_.push_back('"');
+        out_.append(text.data(), text.size());
+        out_.push_back('"');
+    }
+    
+    /// 追加整数
+    void integer(int64_t value) { out_.append(std::to_string(value)); }
+    
+    /// 追加任意值
+    void value(const json& value) { append_json(value, out_); }
+
+private:
+    std::string& out_;
+};
+
+/**
+ * @class MsgpackMessageWriter
+ * @brief 以 MessagePack 追加写入 out
+ * 
+ * 值使用 json::to_msgpack() 追加；map 头部和字符串直接追加，
+ * 格式选择与 nlohmann 相同（fixstr、str8、str16、str32）。
+ */
+class MsgpackMessageWriter {
+public:
+    explicit MsgpackMessageWriter(std::string& out) : out_(out) {}
+    
+    /// 追加元素数不超过 15 的 map 头部
+    void map(uint8_t size) { out_.push_back(static_cast<char>(0x80 | size)); }
+    
+    /// 追加字符串
+    void text(std::string_view text) {
+        std::size_t size = text.size();
+        if (size <= 31) {
+            out_.push_back(static_cast<char>(0xa0 | size));
+        } else if (size <= 0xff) {
+            out_.push_back(static_cast<char>(0xd9));
+            put_be(size, 1);
+        } else if (size <= 0xffff) {
+            out_.push_back(static_cast<char>(0xda));
+            put_be(size, 2);
+        } else {
+            out_.push_back(static_cast<char>(0xdb));
+            put_be(size, 4);
+        }
+        out_.append(text.data(), size);
+    }
+    
+    /// 追加整数（格式选择与 nlohmann 相同，取最短的编码）
+    void integer(int64_t value) {
+        if (value >= 0) {
+            uint64_t n = static_cast<uint64_t>(value);
+            if (n < 0x80) {
+                out_.push_back(static_cast<char>(n));
+            } else if (n <= 0xff) {
+                out_.push_back(static_cast<char>(0xcc));
+                put_be(n, 1);
+            } else if (n <= 0xffff) {
+                out_.push_back(static_cast<char>(0xcd));
+                put_be(n, 2);
+            } else if (n <= 0xffffffff) {
+                out_.push_back(static_cast<char>(0xce));
+                put_be(n, 4);
+            } else {
+                out_.push_back(static_cast<char>(0xcf));
+                put_be(n, 8);
+            }
+        } else if (value >= -32) {
+            out_.push_back(static_cast<char>(value));
+        } else if (value >= INT8_MIN) {
+            out_.push_back(static_cast<char>(0xd0));
+            put_be(static_cast<uint64_t>(value), 1);
+        } else if (value >= INT16_MIN) {
+            out_.push_back(static_cast<char>(0xd1));
+            put_be(static_cast<uint64_t>(value), 2);
+        } else if (value >= INT32_MIN) {
+            out_.push_back(static_cast<char>(0xd2));
+            put_be(static_cast<uint64_t>(value), 4);
+        } else {
+            out_.push_back(static_cast<char>(0xd3));
+            put_be(static_cast<uint64_t>(value), 8);
+        }
+    }
+    
+    /// 追加任意值
+    void value(const json& value) { json::to_msgpack(value, out_); }
+
+private:
+    /// 大端写入 bytes 个字节
+    void put_be(uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) {
+            out_.push_back(static_cast<char>(static_cast<uint8_t>(value >> (8 * i))));
+        }
+    }
+    
+    std::string& out_;
+};
+
+/**
+ * @brief 以 JSON 编码
+ * 
+ * 键按 nlohmann::json 对象的顺序（字典序）写出，与编码消息对象的结果相同。
+ */
+void write_json(const MessageParts& parts, std::string& out) {
+    using Kind = MessageParts::Kind;
+    JsonMessageWriter writer(out);
+    switch (parts.kind) {
+        case Kind::REQUEST:
+        case Kind::NOTIFICATION:
+            if (parts.kind == Kind::REQUEST) {
+                writer.raw("{\"id\":");
+                writer.text(parts.id);
+                writer.raw(",\"jsonrpc\":\"2.0\",\"method\":");
+            } else {
+                writer.raw("{\"jsonrpc\":\"2.0\",\"method\":");
+            }
+            if (parts.method_id) {
+                writer.integer(*parts.method_id);
+            } else {
+                writer.text(parts.method);
+            }
+            if (parts.params) {
+                writer.raw(",\"params\":");
+                writer.value(*parts.params);
+            }
+            writer.raw("}");
+            break;
+        case Kind::RESPONSE_OK:
+            writer.raw("{\"id\":");
+            writer.text(parts.id);
+            writer.raw(",\"jsonrpc\":\"2.0\",\"result\":");
+            writer.value(*parts.result);
+            writer.raw("}");
+            break;
+        case Kind::RESPONSE_ERR:
+            writer.raw("{\"error\":{\"code\":");
+            writer.integer(parts.code);
+            if (parts.data) {
+                writer.raw(",\"data\":");
+                writer.value(*parts.data);
+            }
+            writer.raw(",\"message\":");
+            writer.text(parts.message);
+            writer.raw("},\"id\":");
+            writer.text(parts.id);
+            writer.raw(",\"jsonrpc\":\"2.0\"}");
+            break;
+    }
+}
+
+/**
+ * @brief 以 MessagePack 编码
+ * 
+ * 键的顺序与 write_json() 相同。
+ */
+void write_msgpack(const MessageParts& parts, std::string& out) {
+    using Kind = MessageParts::Kind;
+    MsgpackMessageWriter writer(out);
+    switch (parts.kind) {
+        case Kind::REQUEST:
+        case Kind::NOTIFICATION: {
+            bool request = parts.kind == Kind::REQUEST;
+            writer.map(static_cast<uint8_t>(2 + (request ? 1 : 0) + (parts.params ? 1 : 0)));
+            if (request) {
+                writer.text("id");
+                writer.text(parts.id);
+            }
+            writer.text("jsonrpc");
+            writer.text("2.0");
+            writer.text("method");
+            if (parts.method_id) {
+                writer.integer(*parts.method_id);
+            } else {
+                writer.text(parts.method);
+            }
+            if (parts.params) {
+                writer.text("params");
+                writer.value(*parts.params);
+            }
+            break;
+        }
+        case Kind::RESPONSE_OK:
+            writer.map(3);
+            writer.text("id");
+            writer.text(parts.id);
+            writer.text("jsonrpc");
+            writer.text("2.0");
+            writer.text("result");
+            writer.value(*parts.result);
+            break;
+        case Kind::RESPONSE_ERR:
+            writer.map(3);
+            writer.text("error");
+            writer.map(static_cast<uint8_t>(parts.data ? 3 : 2));
+            writer.text("code");
+            writer.integer(parts.code);
+            if (parts.data) {
+                writer.text("data");
+                writer.value(*parts.data);
+            }
+            writer.text("message");
+            writer.text(parts.message);
+            writer.text("id");
+            writer.text(parts.id);
+            writer.text("jsonrpc");
+            writer.text("2.0");
+            break;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 请求
+ */
+MessageParts MessageParts::request(std::string_view method, const json& params, std::string_view id) {
+    MessageParts parts;
+    parts.kind = Kind::REQUEST;
+    parts.method = method;
+    parts.params = &params;
+    parts.id = id;
+    return parts;
+}
+
+/**
+ * @brief 通知
+ */
+MessageParts MessageParts::notification(std::string_view method, const json& params) {
+    MessageParts parts;
+    parts.kind = Kind::NOTIFICATION;
+    parts.method = method;
+    parts.params = &params;
+    return parts;
+}
+
+/**
+ * @brief 成功响应
+ */
+MessageParts MessageParts::response_ok(const json& result, std::string_view id) {
+    MessageParts parts;
+    parts.kind = Kind::RESPONSE_OK;
+    parts.result = &result;
+    parts.id = id;
+    return parts;
+}
+
+/**
+ * @brief 错误响应
+ * 
+ * 附加数据为 null 或空容器时省略，与 make_response_err() 相同。
+ */
+MessageParts MessageParts::response_err(int code, std::string_view message, std::string_view id, const json* data) {
+    MessageParts parts;
+    parts.kind = Kind::RESPONSE_ERR;
+    parts.code = code;
+    parts.message = message;
+    parts.id = id;
+    parts.data = data && !data->empty() ? data : nullptr;
+    return parts;
+}
+
+/**
+ * @brief 构造等价的消息对象
+ */
+json MessageParts::to_json() const {
+    json message = {{"jsonrpc", "2.0"}};
+    switch (kind) {
+        case Kind::REQUEST:
+        case Kind::NOTIFICATION:
+            if (method_id) {
+                message["method"] = *method_id;
+            } else {
+                message["method"] = std::string(method);
+            }
+            if (params) {
+                message["params"] = *params;
+            }
+            break;
+        case Kind::RESPONSE_OK:
+            message["result"] = *result;
+            break;
+        case Kind::RESPONSE_ERR:
+            message["error"] = {{"code", code}, {"message", std::string(this->message)}};
+            if (data) {
+                message["error"]["data"] = *data;
+            }
+            break;
+    }
+    if (kind != Kind::NOTIFICATION) {
+        message["id"] = std::string(id);
+    }
+    return message;
+}
+
+/**
+ * @brief 把消息的组成部分编码到调用方提供的缓冲区
+ * @param parts 消息的组成部分
+ * @param type 编码类型
+ * @param out 输出缓冲区
+ */
+void encode_message_into(const MessageParts& parts, EncodingType type, std::string& out) {
+    switch (type) {
+        case EncodingType::JSON:
+            out.clear();
+            write_json(parts, out);
+            break;
+        case EncodingType::MSGPACK:
+            out.clear();
+            write_msgpack(parts, out);
+            break;
+        case EncodingType::BINARY:
+            encode_binary_into(parts, out);
+            break;
+        default:
+            codec_for(type).encode_message_into(parts, out);
+            break;
+    }
+}
+
+/**
+ * @brief 把消息的组成部分编码为新的字符串
+ * @param parts 消息的组成部分
+ * @param type 编码类型
+ * @return 编码后的字节
+ */
+std::string encode_message(const MessageParts& parts, EncodingType type) {
+    std::string out;
+    encode_message_into(parts, type, out);
+    return out;
+}
+
+} // namespace zenoh_rpc
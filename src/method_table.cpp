@@ -0,0 +1,221 @@
+#include "zenoh_rpc/method_table.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/// 空槽位标记
+constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+/// 每个桶尝试的最大位移值
+constexpr uint32_t kMaxDisplacement = 1u << 20;
+
+/// 构建失败时更换种子的次数
+constexpr int kMaxSeeds = 16;
+
+/**
+ * @brief 64位混合函数（splitmix64 的终结步骤）
+ */
+uint64_t mix(uint64_t z) noexcept {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief 由键的哈希值和桶的位移值计算槽位
+ */
+uint64_t slot_hash(uint64_t h, uint32_t displacement) noexcept {
+    return mix(h ^ (static_cast<uint64_t>(displacement) * 0x9e3779b97f4a7c15ULL));
+}
+
+/**
+ * @brief 当前线程使用的读者计数分片（首次使用时轮转分配）
+ */
+size_t reader_shard() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % ReadEpoch::kShards;
+    return shard;
+}
+
+/**
+ * @brief 不小于 n 的最小2的幂
+ */
+uint64_t next_pow2(uint64_t n) noexcept {
+    uint64_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief 构建索引
+ * @param keys 互不相同的键
+ * @throws std::invalid_argument 当存在重复的键时
+ * 
+ * 槽位数为键数的 1.25 倍向上取到2的幂，桶数约为键数的一半。
+ * 极少数情况下（哈希值完全相同）当前种子无法放置所有键，此时更换种子重建。
+ */
+PerfectHashIndex::PerfectHashIndex(std::vector<std::string> keys) : keys_(std::move(keys)) {
+    std::unordered_set<std::string_view> unique(keys_.begin(), keys_.end());
+    if (unique.size() != keys_.size()) {
+        throw std::invalid_argument("PerfectHashIndex keys must be unique");
+    }
+    if (keys_.empty()) {
+        return;
+    }
+    
+    for (int attempt = 0; attempt < kMaxSeeds; ++attempt) {
+        if (try_build(mix(0x5eed0000ULL + static_cast<uint64_t>(attempt)))) {
+            return;
+        }
+    }
+    throw std::runtime_error("Failed to build perfect hash index");
+}
+
+/**
+ * @brief 以指定种子构建索引
+ * @param seed 哈希种子
+ * @return 所有键都放置成功时返回 true
+ */
+bool PerfectHashIndex::try_build(uint64_t seed) {
+    seed_ = seed;
+    const uint64_t n = keys_.size();
+    const uint64_t bucket_count = next_pow2(std::max<uint64_t>(1, n / 2));
+    const uint64_t slot_count = next_pow2(n + (n + 3) / 4);
+    bucket_mask_ = bucket_count - 1;
+    slot_mask_ = slot_count - 1;
+    displacements_.assign(bucket_count, 0);
+    slots_.assign(slot_count, kEmptySlot);
+    
+    // 按桶分组，先放置较大的桶
+    std::vector<uint64_t> hashes(n);
+    std::vector<std::vector<uint32_t>> buckets(bucket_count);
+    for (uint64_t i = 0; i < n; ++i) {
+        hashes[i] = hash(keys_[i]);
+        buckets[hashes[i] & bucket_mask_].push_back(static_cast<uint32_t>(i));
+    }
+    std::vector<uint32_t> order(bucket_count);
+    for (uint32_t b = 0; b < bucket_count; ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+    
+    std::vector<uint64_t> candidate;
+    for (uint32_t b : order) {
+        const auto& members = buckets[b];
+        if (members.empty()) {
+            break;
+        }
+        
+        bool placed = false;
+        for (uint32_t d = 0; d < kMaxDisplacement && !placed; ++d) {
+            candidate.clear();
+            placed = true;
+            for (uint32_t key_index : members) {
+                uint64_t slot = slot_hash(hashes[key_index], d) & slot_mask_;
+                if (slots_[slot] != kEmptySlot ||
+                    std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+            if (placed) {
+                displacements_[b] = d;
+                for (size_t k = 0; k < members.size(); ++k) {
+                    slots_[candidate[k]] = members[k];
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 计算键的哈希值（带种子的 FNV-1a 加混合）
+ */
+uint64_t PerfectHashIndex::hash(std::string_view key) const noexcept {
+    uint64_t h = 0xcbf29ce484222325ULL ^ seed_;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return mix(h);
+}
+
+/**
+ * @brief 查找键
+ * @param key 要查找的键
+ * @return 键的位置；不存在时返回 npos
+ */
+size_t PerfectHashIndex::find(std::string_view key) const noexcept {
+    if (keys_.empty()) {
+        return npos;
+    }
+    uint64_t h = hash(key);
+    uint32_t index = slots_[slot_hash(h, displacements_[h & bucket_mask_]) & slot_mask_];
+    if (index == kEmptySlot || keys_[index] != key) {
+        return npos;
+    }
+    return index;
+}
+
+/**
+ * @brief 进入读临界区
+ * @return 传给 leave() 的计数器编号
+ * 
+ * 在当前纪元的计数器上登记；登记期间纪元发生变化时撤销并重试，
+ * 保证读者登记在 synchronize() 会等待的计数器上，或者已经能看到新指针。
+ * 返回值的低位是纪元的奇偶，其余位是分片编号。
+ */
+unsigned ReadEpoch::enter() const noexcept {
+    const size_t shard = reader_shard();
+    for (;;) {
+        uint64_t epoch = epoch_.load();
+        auto& readers = readers_[epoch & 1][shard].value;
+        readers.fetch_add(1);
+        if (epoch_.load() == epoch) {
+            return static_cast<unsigned>(shard << 1 | (epoch & 1));
+        }
+        readers.fetch_sub(1);
+    }
+}
+
+/**
+ * @brief 离开读临界区
+ * @param slot enter() 的返回值
+ */
+void ReadEpoch::leave(unsigned slot) const noexcept {
+    readers_[slot & 1][slot >> 1].value.fetch_sub(1);
+}
+
+/**
+ * @brief 等待调用前进入的读者全部离开
+ * 
+ * 切换纪元后新读者使用另一组计数器，只需等待旧纪元的各个分片归零。
+ * 读临界区很短，等待期间让出 CPU。
+ */
+void ReadEpoch::synchronize() noexcept {
+    uint64_t previous = epoch_.fetch_add(1);
+    for (auto& counter : readers_[previous & 1]) {
+        while (counter.value.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace zenoh_rpc
@@ -0,0 +1,208 @@
+#include "zenoh_rpc/payload.hpp"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/**
+ * @class EncodeBufferPool
+ * @brief 编码缓冲区池
+ * 
+ * 保存已归还的 std::string 缓冲区及其容量。
+ * 空闲缓冲区的数量和单个缓冲区保留的容量都有上限，
+ * 偶尔出现的超大消息不会让池一直占用大块内存。
+ */
+class EncodeBufferPool {
+public:
+    static constexpr std::size_t kMaxPooled = 64;                  ///< 最多保留的空闲缓冲区数
+    static constexpr std::size_t kMaxRetainedCapacity = 4u << 20;  ///< 单个缓冲区最多保留的容量
+    
+    /**
+     * @brief 获取全局缓冲区池
+     * 
+     * 池对象有意不析构：进程退出时 Zenoh 线程仍可能归还缓冲区。
+     */
+    static EncodeBufferPool& instance() {
+        static EncodeBufferPool* pool = new EncodeBufferPool();
+        return *pool;
+    }
+    
+    /**
+     * @brief 取出一个已清空的缓冲区
+     */
+    std::unique_ptr<std::string> acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!buffers_.empty()) {
+                std::unique_ptr<std::string> buffer = std::move(buffers_.back());
+                buffers_.pop_back();
+                return buffer;
+            }
+        }
+        return std::make_unique<std::string>();
+    }
+    
+    /**
+     * @brief 归还缓冲区
+     */
+    void release(std::unique_ptr<std::string> buffer) {
+        if (buffer->capacity() > kMaxRetainedCapacity) {
+            return;
+        }
+        buffer->clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffers_.size() < kMaxPooled) {
+            buffers_.push_back(std::move(buffer));
+        }
+    }
+    
+    /**
+     * @brief 空闲缓冲区数量
+     */
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffers_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<std::string>> buffers_;
+};
+
+} // namespace
+
+/**
+ * @brief 构造载荷视图
+ * @param bytes Zenoh 载荷
+ * 
+ * 遍历载荷分片：只有一个分片时直接指向该分片；
+ * 有多个分片时按 bytes.size() 预留空间后拼接，只分配和复制一次。
+ */
+PayloadView::PayloadView(const zenoh::Bytes& bytes) {
+    auto slices = bytes.slice_iter();
+    auto first = slices.next();
+    if (!first.has_value()) {
+        return;
+    }
+    
+    auto next = slices.next();
+    if (!next.has_value()) {
+        data_ = reinterpret_cast<const char*>(first->data);
+        size_ = first->len;
+        return;
+    }
+    
+    storage_.reserve(bytes.size());
+    storage_.append(reinterpret_cast<const char*>(first->data), first->len);
+    for (; next.has_value(); next = slices.next()) {
+        storage_.append(reinterpret_cast<const char*>(next->data), next->len);
+    }
+    data_ = storage_.data();
+    size_ = storage_.size();
+}
+
+/**
+ * @brief 直接从 zenoh::Bytes 解码 JSON-RPC 消息
+ * @param bytes Zenoh 载荷
+ * @param type 编码类型
+ * @return 解码后的 JSON 对象
+ * @throws ParseError 当解码失败时
+ */
+json decode_payload(const zenoh::Bytes& bytes, EncodingType type) {
+    return PayloadView(bytes).decode(type);
+}
+
+namespace {
+
+/**
+ * @brief 把 write 写入池化缓冲区的结果交给 zenoh::Bytes
+ * @param write 接收输出缓冲区的编码函数
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ * 
+ * 编码结果达到共享内存池的阈值时复制到共享内存，缓冲区留在池中；
+ * 共享内存池已满时和小载荷一样把缓冲区交给 Zenoh。
+ */
+template<typename Write>
+zenoh::Bytes encode_pooled(Write&& write, const ShmPool* shm) {
+    EncodeBufferPool& pool = EncodeBufferPool::instance();
+    std::unique_ptr<std::string> buffer = pool.acquire();
+    try {
+        write(*buffer);
+    } catch (...) {
+        pool.release(std::move(buffer));
+        throw;
+    }
+    
+    if (shm) {
+        std::optional<zenoh::Bytes> shared = shm->try_copy(buffer->data(), buffer->size());
+        if (shared) {
+            pool.release(std::move(buffer));
+            return std::move(*shared);
+        }
+    }
+    
+    std::string* raw = buffer.release();
+    return zenoh::Bytes(reinterpret_cast<uint8_t*>(raw->data()), raw->size(),
+                        [raw](uint8_t*) { EncodeBufferPool::instance().release(std::unique_ptr<std::string>(raw)); });
+}
+
+} // namespace
+
+/**
+ * @brief 将 JSON-RPC 消息编码为 zenoh::Bytes
+ * @param message 要编码的消息
+ * @param type 编码类型
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ */
+zenoh::Bytes encode_payload(const json& message, EncodingType type, const ShmPool* shm) {
+    return encode_pooled([&](std::string& out) { encode_into(message, type, out); }, shm);
+}
+
+/**
+ * @brief 以指定的编解码器将 JSON-RPC 消息编码为 zenoh::Bytes
+ * @param message 要编码的消息
+ * @param codec 编解码器
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ */
+zenoh::Bytes encode_payload(const json& message, const Codec& codec, const ShmPool* shm) {
+    return encode_pooled([&](std::string& out) { codec.encode_into(message, out); }, shm);
+}
+
+/**
+ * @brief 把消息的组成部分编码为 zenoh::Bytes
+ * @param parts 消息的组成部分
+ * @param type 编码类型
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ */
+zenoh::Bytes encode_payload(const MessageParts& parts, EncodingType type, const ShmPool* shm) {
+    return encode_pooled([&](std::string& out) { encode_message_into(parts, type, out); }, shm);
+}
+
+/**
+ * @brief 以指定的编解码器把消息的组成部分编码为 zenoh::Bytes
+ * @param parts 消息的组成部分
+ * @param codec 编解码器
+ * @param shm 共享内存池（可以为空）
+ * @return 持有编码结果的 zenoh::Bytes
+ */
+zenoh::Bytes encode_payload(const MessageParts& parts, const Codec& codec, const ShmPool* shm) {
+    return encode_pooled([&](std::string& out) { codec.encode_message_into(parts, out); }, shm);
+}
+
+/**
+ * @brief 获取编码缓冲区池中空闲缓冲区的数量
+ * @return 空闲缓冲区数量
+ */
+std::size_t pooled_encode_buffers() {
+    return EncodeBufferPool::instance().size();
+}
+
+} // namespace zenoh_rpc
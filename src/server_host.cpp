@@ -0,0 +1,193 @@
+#include "zenoh_rpc/server_host.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace zenoh_rpc {
+
+/**
+ * @brief 创建服务宿主
+ * @param session 所有服务共享的 Zenoh 会话
+ * @param options 服务器配置
+ */
+ServerHost::ServerHost(Session& session, const ServerOptions& options)
+    : session_(session)
+    , options_(options) {
+    if (!options_.executor) {
+        owned_executor_ = std::make_unique<Executor>();
+        options_.executor = owned_executor_.get();
+    }
+}
+
+/**
+ * @brief 析构函数
+ * 
+ * 先停止所有服务，再销毁宿主拥有的执行器（执行器析构时处理完队列中的任务）。
+ */
+ServerHost::~ServerHost() {
+    stop();
+}
+
+/**
+ * @brief 添加服务
+ * @param key_expr 服务键表达式
+ * @param dispatcher 方法分发器
+ * @throws std::invalid_argument 当键表达式已被托管，或与已托管的键表达式相交时
+ */
+void ServerHost::add_service(const std::string& key_expr, DispatcherBase& dispatcher) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (services_.count(key_expr) > 0) {
+        throw std::invalid_argument("Service '" + key_expr + "' is already hosted");
+    }
+    zenoh::KeyExpr key(key_expr);
+    for (const auto& entry : services_) {
+        if (zenoh::KeyExpr(entry.first).intersects(key)) {
+            throw std::invalid_argument("Service '" + key_expr + "' overlaps hosted service '" + entry.first + "'");
+        }
+    }
+    
+    auto server = std::make_unique<Server>(key_expr, dispatcher, session_, options_);
+    if (running_) {
+        server->start();
+    }
+    services_.emplace(key_expr, std::move(server));
+}
+
+/**
+ * @brief 移除服务
+ * @param key_expr 服务键表达式
+ * @param drain_timeout 等待该服务在途请求完成的最长时间
+ * @return 服务存在且其在途请求在期限内完成时返回 true
+ * 
+ * 其他服务在此期间继续处理请求。
+ */
+bool ServerHost::remove_service(const std::string& key_expr, std::chrono::milliseconds drain_timeout) {
+    std::unique_ptr<Server> server;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = services_.find(key_expr);
+        if (it == services_.end()) {
+            return false;
+        }
+        server = std::move(it->second);
+        services_.erase(it);
+    }
+    return server->stop(drain_timeout);
+}
+
+/**
+ * @brief 启动所有服务
+ * @throws std::logic_error 当宿主已经在运行时
+ * 
+ * 某个服务声明失败时，已经启动的服务会被停止，宿主保持未运行状态。
+ */
+void ServerHost::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        throw std::logic_error("ServerHost is already running");
+    }
+    
+    try {
+        for (auto& entry : services_) {
+            entry.second->start();
+        }
+    } catch (...) {
+        for (auto& entry : services_) {
+            entry.second->stop(std::chrono::milliseconds(0));
+        }
+        throw;
+    }
+    running_ = true;
+}
+
+/**
+ * @brief 停止所有服务
+ * @param drain_timeout 等待所有在途请求完成的总期限
+ * @return 所有服务的在途请求都在期限内完成时返回 true
+ * 
+ * 依次停止每个服务，每个服务使用总期限的剩余时间；
+ * 尚未轮到的服务在此期间继续处理请求。
+ */
+bool ServerHost::stop(std::chrono::milliseconds drain_timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        return true;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + drain_timeout;
+    bool drained = true;
+    for (auto& entry : services_) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        drained = entry.second->stop(std::max(remaining, std::chrono::milliseconds(0))) && drained;
+    }
+    
+    running_ = false;
+    stopped_.notify_all();
+    return drained;
+}
+
+/**
+ * @brief 阻塞直到宿主被停止
+ * 
+ * 宿主未运行时立即返回。
+ */
+void ServerHost::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_.wait(lock, [this] { return !running_; });
+}
+
+/**
+ * @brief 宿主是否正在运行
+ * @return start() 之后、stop() 完成之前返回 true
+ */
+bool ServerHost::is_running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+/**
+ * @brief 获取托管的服务键表达式
+ * @return 按字典序排列的键表达式列表
+ */
+std::vector<std::string> ServerHost::services() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> keys;
+    keys.reserve(services_.size());
+    for (const auto& entry : services_) {
+        keys.push_back(entry.first);
+    }
+    return keys;
+}
+
+/**
+ * @brief 所有服务正在处理的查询和通知数
+ * @return 在途数量之和
+ */
+size_t ServerHost::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& entry : services_) {
+        total += entry.second->in_flight();
+    }
+    return total;
+}
+
+/**
+ * @brief 获取指标快照
+ * @return 汇总计数器、每个服务的计数器和共享执行器指标
+ */
+ServerHostMetrics ServerHost::metrics() const {
+    ServerHostMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : services_) {
+            ServerStats stats = entry.second->stats();
+            metrics.total += stats;
+            metrics.services.emplace(entry.first, stats);
+        }
+    }
+    metrics.executor = options_.executor->metrics();
+    return metrics;
+}
+
+} // namespace zenoh_rpc
@@ -1,4 +1,5 @@
 #include "zenoh_rpc/session.hpp"
+#include "zenoh_rpc/shm.hpp"
 
 namespace zenoh_rpc {
 
@@ -43,6 +44,11 @@ Session::~Session() {
 
 void Session::close() {
     if (active_) {
+        {
+            // 缓存的发布者在会话关闭前撤销声明；正在使用的发布者在其持有者释放时撤销
+            std::lock_guard<std::mutex> lock(publishers_mutex_);
+            publishers_.clear();
+        }
         session_.close();
         active_ = false;
     }
@@ -104,6 +110,24 @@ zenoh::Publisher Session::declare_publisher(const std::string& key_expr) {
     return session_.declare_publisher(key_expr);
 }
 
+/**
+ * @brief 获取缓存的发布者
+ * @param key_expr 键表达式
+ * @return 共享的发布者
+ * 
+ * 首次使用某个键表达式时声明发布者并缓存，之后直接复用。
+ * 返回共享所有权：并发的 close() 清空缓存时，正在 put() 的调用者不会访问已销毁的发布者。
+ */
+std::shared_ptr<zenoh::Publisher> Session::get_publisher(const std::string& key_expr) {
+    std::lock_guard<std::mutex> lock(publishers_mutex_);
+    auto it = publishers_.find(key_expr);
+    if (it == publishers_.end()) {
+        auto publisher = std::make_shared<zenoh::Publisher>(session_.declare_publisher(key_expr));
+        it = publishers_.emplace(key_expr, std::move(publisher)).first;
+    }
+    return it->second;
+}
+
 zenoh::Subscriber<void> Session::declare_subscriber(const std::string& key_expr,
                                                     std::function<void(const zenoh::Sample&)> callback) {
     return session_.declare_subscriber(key_expr, 
@@ -152,6 +176,11 @@ zenoh::Config Session::create_config(SessionMode mode, const std::vector<std::st
         config.insert_json5("connect/endpoints", connect_str);
     }
     
+#if ZENOH_RPC_HAS_SHM
+    // 同机会话之间通过共享内存传递大载荷（见 shm.hpp）
+    config.insert_json5("transport/shared_memory/enabled", "true");
+#endif
+    
     return config;
 }
 
@@ -0,0 +1,111 @@
+#include "zenoh_rpc/session_pool.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/// 默认配置会话的键（不与任何模式键冲突）
+const char* const kDefaultKey = "default";
+
+/**
+ * @brief 生成会话键
+ * @param mode 会话模式
+ * @param connections 连接端点列表
+ * @return 模式和排序后的端点拼成的键
+ */
+std::string session_key(SessionMode mode, std::vector<std::string> connections) {
+    std::sort(connections.begin(), connections.end());
+    connections.erase(std::unique(connections.begin(), connections.end()), connections.end());
+    
+    std::string key = std::to_string(static_cast<int>(mode));
+    for (const auto& endpoint : connections) {
+        key += '|';
+        key += endpoint;
+    }
+    return key;
+}
+
+} // namespace
+
+SessionPool& SessionPool::global() {
+    static SessionPool pool;
+    return pool;
+}
+
+std::shared_ptr<Session> SessionPool::acquire() {
+    return acquire_keyed(kDefaultKey, [] { return std::make_shared<Session>(); });
+}
+
+std::shared_ptr<Session> SessionPool::acquire(SessionMode mode, const std::vector<std::string>& connections) {
+    return acquire_keyed(session_key(mode, connections),
+                         [&] { return std::make_shared<Session>(mode, connections); });
+}
+
+size_t SessionPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(sessions_.begin(), sessions_.end(),
+                                             [](const auto& entry) { return !entry.second.session.expired(); }));
+}
+
+/**
+ * @brief 查找或创建会话
+ * @param key 会话键
+ * @param open 创建会话的函数
+ * @return 共享会话
+ * @throws 与 open() 相同的异常；等待同一会话的其他调用也得到该异常
+ * 
+ * 会话在池锁之外打开，打开一个配置的会话不阻塞其他配置的获取。
+ * 同一配置的并发获取等待条目中的 pending，只打开一个会话。
+ * 顺便清理已经没有持有者的条目，会话表的大小不超过同时使用的配置数。
+ */
+template<typename Open>
+std::shared_ptr<Session> SessionPool::acquire_keyed(const std::string& key, Open&& open) {
+    std::promise<std::shared_ptr<Session>> promise;
+    std::shared_future<std::shared_ptr<Session>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(key);
+        if (it != sessions_.end()) {
+            if (auto session = it->second.session.lock()) {
+                return session;
+            }
+            pending = it->second.pending;
+        }
+        
+        if (!pending.valid()) {
+            for (it = sessions_.begin(); it != sessions_.end();) {
+                bool unused = it->second.session.expired() && !it->second.pending.valid();
+                it = unused ? sessions_.erase(it) : std::next(it);
+            }
+            sessions_[key].pending = promise.get_future().share();
+        }
+    }
+    if (pending.valid()) {
+        return pending.get();
+    }
+    
+    std::shared_ptr<Session> session;
+    try {
+        session = open();
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = sessions_[key];
+        entry.session = session;
+        entry.pending = {};
+    }
+    promise.set_value(session);
+    return session;
+}
+
+} // namespace zenoh_rpc
@@ -0,0 +1,193 @@
+#include "zenoh_rpc/sharded_server.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace zenoh_rpc {
+
+namespace {
+
+/**
+ * @brief 检查服务键表达式
+ * @param key_expr 服务键表达式
+ * @throws std::invalid_argument 当键表达式包含通配符时
+ * 
+ * 分片键表达式由服务键表达式拼接而成，通配符会让一个分片应答其他服务的请求。
+ */
+const std::string& check_key_expr(const std::string& key_expr) {
+    if (key_expr.find('*') != std::string::npos) {
+        throw std::invalid_argument("Sharded service key '" + key_expr + "' must not contain wildcards");
+    }
+    return key_expr;
+}
+
+} // namespace
+
+/**
+ * @brief 在一个会话上创建分片服务器
+ * @param key_expr 服务键表达式
+ * @param dispatcher 方法分发器
+ * @param session 所有分片共用的 Zenoh 会话
+ * @param options 分片服务器配置
+ */
+ShardedServer::ShardedServer(const std::string& key_expr, DispatcherBase& dispatcher, Session& session,
+                             const ShardedServerOptions& options)
+    : key_expr_(check_key_expr(key_expr)) {
+    sessions_.assign(std::max<size_t>(options.shards, 1), &session);
+    build(dispatcher, options);
+}
+
+/**
+ * @brief 为每个分片打开独立的会话
+ * @param key_expr 服务键表达式
+ * @param dispatcher 方法分发器
+ * @param make_config 按分片序号创建会话配置
+ * @param options 分片服务器配置
+ */
+ShardedServer::ShardedServer(const std::string& key_expr, DispatcherBase& dispatcher,
+                             const ShardConfigFactory& make_config, const ShardedServerOptions& options)
+    : key_expr_(check_key_expr(key_expr)) {
+    size_t count = std::max<size_t>(options.shards, 1);
+    for (size_t i = 0; i < count; ++i) {
+        owned_sessions_.push_back(std::make_unique<Session>(make_config(i)));
+        sessions_.push_back(owned_sessions_.back().get());
+    }
+    build(dispatcher, options);
+}
+
+/**
+ * @brief 析构函数
+ * 
+ * 先停止所有分片，再销毁执行器和分片服务器打开的会话。
+ */
+ShardedServer::~ShardedServer() {
+    stop();
+}
+
+/**
+ * @brief 创建各分片的执行器和服务器
+ * @param dispatcher 方法分发器
+ * @param options 分片服务器配置
+ * 
+ * 每个分片的执行器只有一个工作线程，分片内的请求按到达顺序处理。
+ * 所有服务器的回复都附带分片数。
+ */
+void ShardedServer::build(DispatcherBase& dispatcher, const ShardedServerOptions& options) {
+    ExecutorOptions executor_options;
+    executor_options.num_threads = 1;
+    executor_options.queue_capacity = options.queue_capacity;
+    executor_options.overflow = options.overflow;
+    
+    ServerOptions server_options = options.server;
+    server_options.shard_count = sessions_.size();
+    
+    shards_.reserve(sessions_.size());
+    for (size_t i = 0; i < sessions_.size(); ++i) {
+        Shard shard;
+        shard.executor = std::make_unique<Executor>(executor_options);
+        server_options.executor = shard.executor.get();
+        shard.server = std::make_unique<Server>(shard_key_expr(key_expr_, i), dispatcher, *sessions_[i], server_options);
+        shards_.push_back(std::move(shard));
+    }
+    
+    server_options.executor = shards_.front().executor.get();
+    front_ = std::make_unique<Server>(key_expr_, dispatcher, *sessions_.front(), server_options);
+}
+
+/**
+ * @brief 启动所有分片
+ * @throws std::logic_error 当服务器已经在运行时
+ * 
+ * 先启动各分片，最后启动服务键表达式上的服务器：
+ * 客户端从第一个回复得知分片数时，各分片已经在应答。
+ */
+void ShardedServer::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        throw std::logic_error("ShardedServer on '" + key_expr_ + "' is already running");
+    }
+    
+    try {
+        for (auto& shard : shards_) {
+            shard.server->start();
+        }
+        front_->start();
+    } catch (...) {
+        front_->stop(std::chrono::milliseconds(0));
+        for (auto& shard : shards_) {
+            shard.server->stop(std::chrono::milliseconds(0));
+        }
+        throw;
+    }
+    running_ = true;
+}
+
+/**
+ * @brief 停止所有分片
+ * @param drain_timeout 等待所有在途请求完成的总期限
+ * @return 所有分片的在途请求都在期限内完成时返回 true
+ * 
+ * 每个服务器使用总期限的剩余时间；尚未轮到的分片在此期间继续处理请求。
+ */
+bool ShardedServer::stop(std::chrono::milliseconds drain_timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        return true;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + drain_timeout;
+    auto remaining = [deadline] {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        return std::max(left, std::chrono::milliseconds(0));
+    };
+    bool drained = front_->stop(remaining());
+    for (auto& shard : shards_) {
+        drained = shard.server->stop(remaining()) && drained;
+    }
+    
+    running_ = false;
+    stopped_.notify_all();
+    return drained;
+}
+
+/**
+ * @brief 阻塞直到服务器被停止
+ * 
+ * 服务器未运行时立即返回。
+ */
+void ShardedServer::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_.wait(lock, [this] { return !running_; });
+}
+
+bool ShardedServer::is_running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+ServerStats ShardedServer::stats() const {
+    ServerStats total = front_->stats();
+    for (const auto& shard : shards_) {
+        total += shard.server->stats();
+    }
+    return total;
+}
+
+std::vector<ServerStats> ShardedServer::shard_stats() const {
+    std::vector<ServerStats> stats;
+    stats.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        stats.push_back(shard.server->stats());
+    }
+    stats.front() += front_->stats();
+    return stats;
+}
+
+size_t ShardedServer::in_flight() const {
+    size_t total = front_->in_flight();
+    for (const auto& shard : shards_) {
+        total += shard.server->in_flight();
+    }
+    return total;
+}
+
+} // namespace zenoh_rpc
@@ -0,0 +1,93 @@
+#include "zenoh_rpc/shm.hpp"
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+namespace zenoh_rpc {
+
+#if ZENOH_RPC_HAS_SHM
+
+/**
+ * @struct ShmPool::Impl
+ * @brief Zenoh POSIX 共享内存提供者和计数器
+ */
+struct ShmPool::Impl {
+    zenoh::PosixShmProvider provider;           ///< 共享内存提供者
+    std::atomic<uint64_t> shm_payloads{0};      ///< 放入共享内存的载荷数
+    std::atomic<uint64_t> shm_bytes{0};         ///< 放入共享内存的字节数
+    std::atomic<uint64_t> heap_fallbacks{0};    ///< 回退到堆缓冲区的载荷数
+    
+    explicit Impl(size_t pool_size)
+        : provider(zenoh::MemoryLayout(pool_size, zenoh::AllocAlignment({0}))) {}
+};
+
+bool ShmPool::supported() {
+    return true;
+}
+
+ShmPool::ShmPool(const ShmOptions& options)
+    : options_(options)
+    , impl_(std::make_unique<Impl>(options.pool_size)) {}
+
+/**
+ * @brief 把编码后的载荷复制到共享内存
+ * @param data 载荷起始地址
+ * @param size 载荷字节数
+ * @return 持有共享内存缓冲区的载荷；小于阈值或共享内存池已满时返回空值
+ * 
+ * 使用不阻塞的 alloc_gc_defrag()：RPC 线程不会等待其他进程释放缓冲区。
+ */
+std::optional<zenoh::Bytes> ShmPool::try_copy(const char* data, size_t size) const {
+    if (size < options_.threshold) {
+        return std::nullopt;
+    }
+    
+    auto result = impl_->provider.alloc_gc_defrag(size, zenoh::AllocAlignment({0}));
+    auto* buffer = std::get_if<zenoh::ZShmMut>(&result);
+    if (!buffer) {
+        impl_->heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    std::memcpy(buffer->data(), data, size);
+    impl_->shm_payloads.fetch_add(1, std::memory_order_relaxed);
+    impl_->shm_bytes.fetch_add(size, std::memory_order_relaxed);
+    return zenoh::Bytes(std::move(*buffer));
+}
+
+ShmStats ShmPool::stats() const {
+    ShmStats stats;
+    stats.shm_payloads = impl_->shm_payloads.load(std::memory_order_relaxed);
+    stats.shm_bytes = impl_->shm_bytes.load(std::memory_order_relaxed);
+    stats.heap_fallbacks = impl_->heap_fallbacks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#else
+
+/// 没有共享内存支持时不会创建
+struct ShmPool::Impl {};
+
+bool ShmPool::supported() {
+    return false;
+}
+
+ShmPool::ShmPool(const ShmOptions& options) : options_(options) {
+    throw std::runtime_error(
+        "zenoh_rpc was built without shared memory support "
+        "(requires zenoh-c with shared-memory and -DZENOH_RPC_ENABLE_SHM=ON)");
+}
+
+std::optional<zenoh::Bytes> ShmPool::try_copy(const char*, size_t) const {
+    return std::nullopt;
+}
+
+ShmStats ShmPool::stats() const {
+    return ShmStats();
+}
+
+#endif
+
+ShmPool::~ShmPool() = default;
+
+} // namespace zenoh_rpc
@@ -0,0 +1,215 @@
+/**
+ * @file test_async_handlers.cpp
+ * @brief 异步方法处理器测试
+ * 
+ * 分发器部分不需要网络：验证 dispatch_async、回复句柄只完成一次、
+ * 句柄未回复即销毁时以 -32603 完成。
+ * 服务器部分使用本机回环端点，验证异步方法在其他线程中回复、
+ * 批量请求等待所有异步条目，以及 stop() 等待未完成的回复句柄。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/async_handlers";
+const std::string kEndpoint = "tcp/127.0.0.1:7463";
+
+/**
+ * @class AsyncDispatcher
+ * @brief 带有异步方法的分发器
+ * 
+ * "delayed" 在独立线程中延迟回复，模拟等待下游服务的处理器。
+ */
+class AsyncDispatcher : public DispatcherBase {
+public:
+    AsyncDispatcher() {
+        register_method("sync_add", [](const json& params) -> json {
+            return params[0].get<int>() + params[1].get<int>();
+        });
+        register_async_method("immediate", [](const json& params, ReplyHandle reply) {
+            reply.resolve(params);
+        });
+        register_async_method("delayed", [this](const json& params, ReplyHandle reply) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back([params, reply]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(params[0].get<int>()));
+                reply.resolve(params[0]);
+            });
+        });
+        register_async_method("rejected", [](const json&, ReplyHandle reply) {
+            reply.reject(-32602, "bad params", json{{"field", "x"}});
+        });
+        register_async_method("throws", [](const json&, ReplyHandle) {
+            throw std::runtime_error("handler failed");
+        });
+        register_async_method("dropped", [](const json&, ReplyHandle) {});
+    }
+    
+    ~AsyncDispatcher() {
+        join_workers();
+    }
+    
+    void join_workers() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+};
+
+void test_dispatch_async() {
+    std::cout << "Testing dispatch_async..." << std::endl;
+    
+    AsyncDispatcher dispatcher;
+    json result;
+    std::exception_ptr error;
+    auto capture = [&](std::exception_ptr e, json r) {
+        error = e;
+        result = std::move(r);
+    };
+    
+    // 同步方法也可以通过回调分发
+    dispatcher.dispatch_async("sync_add", json::array({2, 3}), capture);
+    assert(!error && result == 5);
+    
+    dispatcher.dispatch_async("immediate", json::array({"x"}), capture);
+    assert(!error && result == json::array({"x"}));
+    
+    dispatcher.dispatch_async("missing", json::object(), capture);
+    assert(error);
+    try {
+        std::rethrow_exception(error);
+    } catch (const MethodNotFoundError&) {
+    }
+    
+    dispatcher.dispatch_async("rejected", json::object(), capture);
+    try {
+        std::rethrow_exception(error);
+    } catch (const InvalidParamsError& e) {
+        assert(e.get_data()["field"] == "x");
+    }
+    
+    dispatcher.dispatch_async("throws", json::object(), capture);
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::runtime_error& e) {
+        assert(std::string(e.what()) == "handler failed");
+    }
+    
+    // 未回复即丢弃句柄：以内部错误完成
+    error = nullptr;
+    dispatcher.dispatch_async("dropped", json::object(), capture);
+    try {
+        std::rethrow_exception(error);
+    } catch (const InternalError&) {
+    }
+    
+    // 同步 dispatch() 等待异步方法完成
+    assert(dispatcher.dispatch("delayed", json::array({20})) == 20);
+    
+    std::cout << "dispatch_async tests passed!" << std::endl;
+}
+
+void test_reply_handle_completes_once() {
+    std::cout << "Testing reply handle..." << std::endl;
+    
+    int calls = 0;
+    {
+        ReplyHandle reply([&](std::exception_ptr error, json result) {
+            ++calls;
+            assert(!error && result == 1);
+        });
+        ReplyHandle copy = reply;
+        assert(!reply.is_completed());
+        copy.resolve(1);
+        assert(reply.is_completed());
+        reply.resolve(2);
+        reply.reject(-32000, "late");
+    }
+    assert(calls == 1);
+    
+    // 注册同名同步方法会替换异步方法
+    AsyncDispatcher dispatcher;
+    dispatcher.register_method("immediate", [](const json&) -> json { return "sync"; });
+    assert(dispatcher.dispatch("immediate", json::object()) == "sync");
+    
+    std::cout << "Reply handle tests passed!" << std::endl;
+}
+
+void test_server_replies_later(Session& server_session, Client& client) {
+    std::cout << "Testing async replies over zenoh..." << std::endl;
+    
+    AsyncDispatcher dispatcher;
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    assert(client.call("delayed", json::array({50})) == 50);
+    assert(client.call("immediate", json::array({1})) == json::array({1}));
+    
+    bool threw = false;
+    try {
+        client.call("dropped");
+    } catch (const InternalError&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // 批量请求等待所有异步条目完成，顺序与请求相同
+    auto results = client.call_batch({
+        {"delayed", json::array({80})},
+        {"sync_add", json::array({1, 2})},
+        {"delayed", json::array({10})},
+        {"rejected", json::object()},
+    });
+    assert(results.size() == 4);
+    assert(results[0].value() == 80);
+    assert(results[1].value() == 3);
+    assert(results[2].value() == 10);
+    assert(!results[3] && results[3].error().code == -32602);
+    
+    // 回调返回后尚未回复的请求计入在途，stop() 等待其完成
+    auto slow = client.call_async("delayed", json::array({300}));
+    for (int i = 0; i < 200 && server.in_flight() == 0; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    assert(server.in_flight() == 1);
+    assert(server.stop(2s));
+    assert(slow.get() == 300);
+    assert(server.stats().errors == 2);
+    
+    dispatcher.join_workers();
+    std::cout << "Async reply tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_dispatch_async();
+        test_reply_handle_completes_once();
+        
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        Client client(kKeyExpr, client_session);
+        test_server_replies_later(server_session, client);
+        
+        std::cout << "\nAll async handler tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file test_binary_envelope.cpp
+ * @brief 二进制信封测试
+ * 
+ * 验证 EncodingType::BINARY 的编码、解码和扫描：固定头部中的 id、方法和错误代码，
+ * MessagePack 主体，批量消息，编码协商以及格式错误的载荷。不需要网络。
+ */
+
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include "zenoh_rpc/id_generator.hpp"
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace zenoh_rpc;
+
+/**
+ * @brief 编码应当失败
+ */
+bool encode_fails(const json& message) {
+    try {
+        encode_binary(message);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 扫描应当失败
+ */
+bool scan_fails(const std::string& payload) {
+    try {
+        scan_message(payload.data(), payload.size(), EncodingType::BINARY);
+    } catch (const ParseError&) {
+        return true;
+    }
+    return false;
+}
+
+void test_round_trip() {
+    std::cout << "Testing round trip..." << std::endl;
+    
+    json messages = json::array({
+        make_request("math.add", json::array({1, 2}), "42"),
+        make_request("echo", json{{"text", "hi"}, {"blob", json::binary({1, 2, 3})}}, "3f9a1c2e.1a"),
+        make_request("no_params", json::object(), "0"),
+        make_notification("set_led", json{{"on", true}}),
+        make_response_ok(json{{"sum", 3}}, "18446744073709551615"),
+        make_response_ok(nullptr, "007"),
+        make_response_err(-32601, "Method not found", "42"),
+        make_response_err(-32000, "Server busy", "null", json{{"retry_ms", 50}}),
+    });
+    for (const auto& message : messages) {
+        std::string encoded = encode(message, EncodingType::BINARY);
+        assert(static_cast<uint8_t>(encoded[0]) == binary_format::kMagic);
+        assert(sniff_encoding(encoded) == EncodingType::BINARY);
+        assert(decode(encoded, EncodingType::BINARY) == message);
+    }
+    
+    // 没有 params 字段的请求解码后也没有 params
+    json bare = {{"jsonrpc", "2.0"}, {"method", "ping"}, {"id", "1"}};
+    assert(decode_binary(encode_binary(bare).data(), encode_binary(bare).size()) == bare);
+    
+    // 批量消息
+    std::string batch = encode_binary(messages);
+    assert(decode(batch, EncodingType::BINARY) == messages);
+    assert(decode(encode_binary(json::array()), EncodingType::BINARY) == json::array());
+    
+    // 通过 get_encoding_funcs 协商
+    auto funcs = get_encoding_funcs(EncodingType::BINARY);
+    assert(funcs.second(funcs.first(messages[0])) == messages[0]);
+    
+    std::cout << "Round trip tests passed!" << std::endl;
+}
+
+void test_header_layout() {
+    std::cout << "Testing header layout..." << std::endl;
+    
+    // 数字 id 以 8 字节整数传输，方法名以 u16 长度为前缀
+    std::string encoded = encode_binary(make_request("add", json::array({1, 2}), "258"));
+    std::string expected("\xc1\x01\x00", 3);
+    expected += std::string("\x02\x01\x00\x00\x00\x00\x00\x00", 8);
+    expected += std::string("\x03\x00" "add", 5);
+    expected += std::string("\x92\x01\x02", 3);
+    assert(encoded == expected);
+    
+    // 非数字 id 以长度加字节传输
+    encoded = encode_binary(make_request("add", json::array(), "a1"));
+    assert(static_cast<uint8_t>(encoded[2]) == binary_format::kTextId);
+    assert(encoded.substr(3, 4) == std::string("\x02\x00" "a1", 4));
+    
+    // 错误代码在头部，主体只有 message 和 data
+    encoded = encode_binary(make_response_err(-32601, "nf", "1"));
+    assert(static_cast<uint8_t>(encoded[2]) == binary_format::RESPONSE_ERR);
+    assert(encoded.substr(11, 4) == std::string("\xa7\x80\xff\xff", 4));
+    
+    // 数字 id 的二进制信封不到默认 MessagePack 请求（UUID id）的一半
+    IdGenerator ids(IdMode::NUMERIC);
+    json request = make_request("math.add", json::array({1, 2}), ids.next());
+    assert(encode_binary(request).size() < encode(request, EncodingType::MSGPACK).size());
+    json uuid_request = make_request("math.add", json::array({1, 2}), gen_uuid());
+    assert(encode_binary(request).size() < encode(uuid_request, EncodingType::MSGPACK).size() / 2);
+    
+    std::cout << "Header layout tests passed!" << std::endl;
+}
+
+void test_scan() {
+    std::cout << "Testing scan..." << std::endl;
+    
+    json request = make_request("math.add", json{{"a", 1}, {"b", 2}}, "7");
+    std::string encoded = encode_binary(request);
+    Envelope envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType::BINARY);
+    assert(envelope.encoding == EncodingType::BINARY);
+    assert(envelope.is_valid_request());
+    assert(envelope.method == "math.add" && envelope.id == "7");
+    assert(envelope.params_kind == ValueKind::OBJECT);
+    assert(envelope.params.data() > encoded.data() && envelope.parse_params() == request["params"]);
+    
+    encoded = encode_binary(make_notification("tick"));
+    envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType::BINARY);
+    assert(envelope.is_valid_notification() && envelope.id_kind == ValueKind::ABSENT);
+    
+    encoded = encode_binary(make_response_err(-32602, "bad", "9", json::array({1})));
+    envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType::BINARY);
+    assert(envelope.error_code == -32602);
+    assert(envelope.parse_error() == json({{"code", -32602}, {"message", "bad"}, {"data", {1}}}));
+    
+    // 方法ID
+    json by_id = {{"jsonrpc", "2.0"}, {"method", 17}, {"params", {1}}, {"id", "1"}};
+    encoded = encode_binary(by_id);
+    envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType::BINARY);
+    assert(envelope.method_kind == ValueKind::NUMBER && envelope.method_id == 17);
+    assert(envelope.is_valid_request());
+    assert(decode_binary(encoded.data(), encoded.size()) == by_id);
+    
+    std::cout << "Scan tests passed!" << std::endl;
+}
+
+void test_invalid() {
+    std::cout << "Testing invalid messages..." << std::endl;
+    
+    assert(encode_fails(json(42)));
+    assert(encode_fails(json::array({make_request("a", json::array(), "1"), 42})));
+    assert(encode_fails(json{{"jsonrpc", "2.0"}, {"method", "a"}, {"id", 1}}));
+    assert(encode_fails(json{{"jsonrpc", "2.0"}, {"method", true}, {"id", "1"}}));
+    assert(encode_fails(json{{"jsonrpc", "2.0"}, {"id", "1"}}));
+    assert(encode_fails(json{{"jsonrpc", "2.0"}, {"error", {{"message", "x"}}}, {"id", "1"}}));
+    assert(encode_fails(make_request(std::string(70000, 'm'), json::array(), "1")));
+    
+    std::string encoded = encode_binary(make_request("math.add", json::array({1, 2}), "1"));
+    for (size_t size = 0; size < encoded.size(); ++size) {
+        if (size != 21) {  // 21 字节时恰好是没有参数的请求
+            assert(scan_fails(encoded.substr(0, size)));
+        }
+    }
+    assert(scan_fails(encoded + "\x01"));
+    std::string bad = encoded;
+    bad[1] = 2;
+    assert(scan_fails(bad));
+    bad = encoded;
+    bad[2] = 0x40;
+    assert(scan_fails(bad));
+    
+    std::string batch = encode_binary(json::array({make_request("a", json::array(), "1")}));
+    assert(scan_fails(batch.substr(0, batch.size() - 1)));
+    assert(scan_fails(batch + "x"));
+    
+    // 成功响应必须有结果，错误响应的主体必须是 map
+    std::string no_result("\xc1\x01\x02\x01\x00\x00\x00\x00\x00\x00\x00", 11);
+    assert(scan_fails(no_result));
+    assert(!scan_fails(no_result + "\x01"));
+    std::string error_body("\xc1\x01\x03\x01\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00", 15);
+    assert(!scan_fails(error_body + "\x80"));
+    assert(scan_fails(error_body + "\x01"));
+    
+    std::cout << "Invalid message tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_round_trip();
+        test_header_layout();
+        test_scan();
+        test_invalid();
+        
+        std::cout << "\nAll binary envelope tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
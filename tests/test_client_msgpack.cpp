@@ -1,5 +1,6 @@
 #include <iostream>
 #include <iomanip>
+#include <zenoh.hxx>
 #include "zenoh_rpc/jsonrpc_proto.hpp"
 #include "zenoh_rpc/errors.hpp"
 
@@ -90,6 +91,34 @@ int main() {
             return 1;
         }
         
+        // 测试编码自动识别
+        std::cout << "\n7. Testing encoding detection..." << std::endl;
+        bool sniff_ok = sniff_encoding(json_encoded) == EncodingType::JSON &&
+                        sniff_encoding(" \n[" + json_encoded + "]") == EncodingType::JSON &&
+                        sniff_encoding(msgpack_encoded) == EncodingType::MSGPACK &&
+                        sniff_encoding(encode_msgpack(json::array({request}))) == EncodingType::MSGPACK;
+        bool mime_ok = encoding_from_mime(encoding_mime(EncodingType::JSON)) == EncodingType::JSON &&
+                       encoding_from_mime(encoding_mime(EncodingType::MSGPACK)) == EncodingType::MSGPACK &&
+                       encoding_from_mime("application/json;utf-8") == EncodingType::JSON &&
+                       !encoding_from_mime("zenoh/bytes").has_value();
+        // Zenoh 没有预定义 application/msgpack，as_string() 返回 "zenoh/bytes;application/msgpack"
+        bool zenoh_mime_ok = encoding_from_mime("zenoh/bytes;application/msgpack") == EncodingType::MSGPACK &&
+                             encoding_from_mime("zenoh/bytes;application/msgpack;v=1") == EncodingType::MSGPACK;
+        for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK, EncodingType::BINARY}) {
+            zenoh_mime_ok = zenoh_mime_ok &&
+                            encoding_from_mime(zenoh::Encoding(encoding_mime(type)).as_string()) == type;
+        }
+        bool name_ok = encoding_from_name("msgpack") == EncodingType::MSGPACK &&
+                       !encoding_from_name("xml").has_value();
+        
+        if (sniff_ok && mime_ok && zenoh_mime_ok && name_ok &&
+            decode(encode(request, EncodingType::MSGPACK), EncodingType::MSGPACK) == request) {
+            std::cout << "✓ SUCCESS: Encoding detection works correctly!" << std::endl;
+        } else {
+            std::cout << "✗ FAILURE: Encoding detection failed!" << std::endl;
+            return 1;
+        }
+        
         std::cout << "\n🎉 All Client MessagePack tests passed successfully!" << std::endl;
         std::cout << "\nMessagePack encoding is fully integrated and working." << std::endl;
         
@@ -0,0 +1,205 @@
+/**
+ * @file test_codec_registry.cpp
+ * @brief 编解码器注册表测试
+ * 
+ * 验证内置编解码器（JSON、MessagePack、二进制信封、CBOR、UBJSON、BSON）的往返编码、
+ * 按名称和 MIME 类型（包括经过 zenoh::Encoding 的字符串形式）查找、自定义编解码器的注册，以及没有专门扫描器的编码的信封扫描。
+ * 不需要网络。
+ */
+
+#include <zenoh.hxx>
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace zenoh_rpc;
+
+/**
+ * @class ReversedJsonCodec
+ * @brief 把 JSON 文本倒序存放的自定义编解码器
+ */
+class ReversedJsonCodec : public Codec {
+public:
+    ReversedJsonCodec() : Codec(EncodingType{kFirstCustomEncoding}, "reversed", "application/x-reversed-json") {}
+    
+    void encode_into(const json& message, std::string& out) const override {
+        encode_json_into(message, out);
+        std::reverse(out.begin(), out.end());
+    }
+    
+    json decode(const char* data, std::size_t size) const override {
+        std::string text(data, size);
+        std::reverse(text.begin(), text.end());
+        return decode_json(text);
+    }
+};
+
+void test_builtin_codecs() {
+    std::cout << "Testing built-in codecs..." << std::endl;
+    
+    CodecRegistry& registry = CodecRegistry::instance();
+    json messages = json::array({
+        make_request("math.add", json::array({1, -2, 3.5, "x", nullptr, true}), "42"),
+        make_request("echo", json{{"nested", {{"list", {1, 2, 3}}, {"text", "héllo"}}}}, "req-1"),
+        make_notification("tick", json::object()),
+        make_response_ok(json{{"sum", 3}}, "42"),
+        make_response_err(-32601, "Method not found", "7", json{{"hint", "x"}}),
+    });
+    
+    for (const char* name : {"json", "msgpack", "binary", "cbor", "ubjson", "bson"}) {
+        const Codec* codec = registry.find(name);
+        assert(codec && codec->name() == name);
+        assert(registry.find(codec->type()) == codec);
+        assert(&codec_for(codec->type()) == codec);
+        assert(registry.find_mime(codec->mime() + ";schema") == codec);
+        assert(encoding_from_name(name) == codec->type());
+        assert(encoding_from_mime(codec->mime()) == codec->type());
+        assert(encoding_mime(codec->type()) == codec->mime());
+        // 对端收到的是 Zenoh Encoding 的字符串形式，非预定义 MIME 类型带 "zenoh/bytes;" 前缀
+        std::string wire_mime = zenoh::Encoding(codec->mime()).as_string();
+        assert(encoding_from_mime(wire_mime) == codec->type());
+        assert(registry.find_mime(wire_mime) == codec);
+        
+        for (const auto& message : messages) {
+            std::string encoded = codec->encode(message);
+            assert(codec->decode(encoded.data(), encoded.size()) == message);
+            assert(encode(message, codec->type()) == encoded);
+            assert(decode(encoded, codec->type()) == message);
+        }
+        
+        // 批量数组（BSON 包装为文档）
+        std::string batch = codec->encode(messages);
+        assert(codec->decode(batch.data(), batch.size()) == messages);
+        
+        auto funcs = get_encoding_funcs(codec->type());
+        assert(funcs.second(funcs.first(messages[0])) == messages[0]);
+    }
+    assert(registry.names().size() == 6);
+    assert(registry.find("yaml") == nullptr && !encoding_from_name("yaml"));
+    assert(registry.find_mime("application/yaml") == nullptr);
+    
+    // 格式错误的载荷
+    for (EncodingType type : {EncodingType::CBOR, EncodingType::UBJSON, EncodingType::BSON}) {
+        bool failed = false;
+        try {
+            decode(std::string("\xff\x01", 2), type);
+        } catch (const ParseError&) {
+            failed = true;
+        }
+        assert(failed);
+    }
+    bool rejected = false;
+    try {
+        encode(json(3), EncodingType::BSON);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    std::cout << "Built-in codec tests passed!" << std::endl;
+}
+
+void test_transcoded_scan() {
+    std::cout << "Testing transcoded scan..." << std::endl;
+    
+    json request = make_request("math.add", json{{"a", 1}, {"b", {1.5, 2.5}}}, "r1");
+    for (EncodingType type : {EncodingType::CBOR, EncodingType::UBJSON, EncodingType::BSON}) {
+        std::string encoded = encode(request, type);
+        Envelope envelope = scan_envelope(encoded.data(), encoded.size(), type);
+        assert(envelope.encoding == type && envelope.storage);
+        assert(envelope.is_valid_request());
+        assert(envelope.method == "math.add" && envelope.id == "r1");
+        assert(envelope.parse_params() == request["params"]);
+        
+        json error = make_response_err(-32602, "bad", "r2", json::array({1}));
+        encoded = encode(error, type);
+        envelope = scan_envelope(encoded.data(), encoded.size(), type);
+        assert(envelope.parse_error() == error["error"]);
+        
+        json batch = json::array({request, make_notification("tick")});
+        encoded = encode(batch, type);
+        ScannedMessage message = scan_message(encoded.data(), encoded.size(), type);
+        assert(message.is_batch && message.entries.size() == 2);
+        assert(message.entries[1].is_valid_notification());
+        
+        // 条目在扫描结果移动和复制后仍可解析
+        ScannedMessage moved = std::move(message);
+        Envelope copy = moved.entries[0];
+        moved.entries.clear();
+        assert(copy.parse_params() == request["params"]);
+    }
+    
+    std::cout << "Transcoded scan tests passed!" << std::endl;
+}
+
+void test_custom_codec() {
+    std::cout << "Testing custom codec..." << std::endl;
+    
+    CodecRegistry& registry = CodecRegistry::instance();
+    auto codec = std::make_shared<ReversedJsonCodec>();
+    registry.add(codec);
+    assert(registry.find("reversed") == codec.get());
+    assert(encoding_from_mime("application/x-reversed-json") == EncodingType{kFirstCustomEncoding});
+    assert(encoding_from_mime(zenoh::Encoding(codec->mime()).as_string()) == EncodingType{kFirstCustomEncoding});
+    assert(encoding_from_mime("zenoh/bytes;application/x-reversed-json;v=2") == EncodingType{kFirstCustomEncoding});
+    
+    json request = make_request("echo", json::array({"abc"}), "1");
+    std::string encoded = encode(request, EncodingType{kFirstCustomEncoding});
+    assert(encoded.front() == '}');
+    Envelope envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType{kFirstCustomEncoding});
+    assert(envelope.is_valid_request() && envelope.parse_params() == request["params"]);
+    
+    // 名称或 MIME 类型与其他编码冲突
+    struct Clash : Codec {
+        Clash(const char* name, const char* mime) : Codec(EncodingType{kFirstCustomEncoding + 1}, name, mime) {}
+        void encode_into(const json&, std::string&) const override {}
+        json decode(const char*, std::size_t) const override { return nullptr; }
+    };
+    for (auto clash : {std::make_shared<Clash>("cbor", "application/x-other"),
+                       std::make_shared<Clash>("other", "application/cbor")}) {
+        bool rejected = false;
+        try {
+            registry.add(clash);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    
+    // 同一编码类型重新注册时替换
+    auto replacement = std::make_shared<ReversedJsonCodec>();
+    registry.add(replacement);
+    assert(registry.find("reversed") == replacement.get());
+    assert(&codec_for(EncodingType{kFirstCustomEncoding}) == replacement.get());
+    assert(registry.names().size() == 7);
+    
+    bool unknown = false;
+    try {
+        codec_for(EncodingType{200});
+    } catch (const std::invalid_argument&) {
+        unknown = true;
+    }
+    assert(unknown);
+    
+    std::cout << "Custom codec tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_builtin_codecs();
+        test_transcoded_scan();
+        test_custom_codec();
+        
+        std::cout << "\nAll codec registry tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
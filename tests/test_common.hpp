@@ -0,0 +1,48 @@
+/**
+ * @file test_common.hpp
+ * @brief 测试公共工具
+ * 
+ * 需要网络的测试使用本机 peer 模式回环会话：服务器会话监听、客户端会话直连，
+ * 不依赖路由器和多播。每个测试程序使用自己的端口，可以并行运行。
+ */
+
+#pragma once
+
+#include <string>
+#include "zenoh_rpc/session.hpp"
+
+namespace test {
+
+/**
+ * @brief 创建回环端点的 peer 模式配置
+ * @param role "listen"（服务器端）或 "connect"（客户端）
+ * @param endpoint 回环端点，例如 "tcp/127.0.0.1:7461"
+ * @return Zenoh 配置
+ */
+inline zenoh::Config peer_config(const std::string& role, const std::string& endpoint) {
+    zenoh::Config config = zenoh::Config::create_default();
+    config.insert_json5("mode", "\"peer\"");
+    config.insert_json5(role + "/endpoints", "[\"" + endpoint + "\"]");
+    config.insert_json5("scouting/multicast/enabled", "false");
+    return config;
+}
+
+/**
+ * @brief 创建监听回环端点的 peer 模式配置（服务器端）
+ * @param endpoint 监听端点
+ * @return Zenoh 配置
+ */
+inline zenoh::Config listen_config(const std::string& endpoint) {
+    return peer_config("listen", endpoint);
+}
+
+/**
+ * @brief 创建连接回环端点的 peer 模式配置（客户端）
+ * @param endpoint 连接端点
+ * @return Zenoh 配置
+ */
+inline zenoh::Config connect_config(const std::string& endpoint) {
+    return peer_config("connect", endpoint);
+}
+
+} // namespace test
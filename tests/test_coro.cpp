@@ -0,0 +1,193 @@
+/**
+ * @file test_coro.cpp
+ * @brief C++20 协程接口测试
+ * 
+ * 任务和调度器部分不需要网络：验证任务链、异常传播、调度器线程切换，
+ * 以及协程方法通过分发器回复。
+ * 服务器部分在本机回环端点上组成两跳调用链（front -> back），
+ * 验证只有一个调度线程时多个链式调用仍然并发完成。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "zenoh_rpc/coro.hpp"
+#include "test_common.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kEndpoint = "tcp/127.0.0.1:7464";
+
+coro::Task<int> add(int a, int b) {
+    co_return a + b;
+}
+
+coro::Task<int> add_three(int a, int b, int c) {
+    int ab = co_await add(a, b);
+    co_return co_await add(ab, c);
+}
+
+coro::Task<int> fail() {
+    throw std::runtime_error("task failed");
+    co_return 0;
+}
+
+coro::Task<std::thread::id> thread_after_schedule(coro::Scheduler& scheduler) {
+    co_await scheduler.schedule();
+    co_return std::this_thread::get_id();
+}
+
+void test_tasks() {
+    std::cout << "Testing tasks..." << std::endl;
+    
+    assert(coro::sync_wait(add_three(1, 2, 3)) == 6);
+    
+    bool threw = false;
+    try {
+        coro::sync_wait(fail());
+    } catch (const std::runtime_error& e) {
+        threw = std::string(e.what()) == "task failed";
+    }
+    assert(threw);
+    
+    // 创建但未等待的任务不会执行，销毁时释放协程帧
+    {
+        auto unused = add(1, 1);
+    }
+    
+    std::cout << "Task tests passed!" << std::endl;
+}
+
+void test_scheduler() {
+    std::cout << "Testing scheduler..." << std::endl;
+    
+    coro::Scheduler scheduler(1);
+    std::thread::id worker = coro::sync_wait(thread_after_schedule(scheduler));
+    assert(worker != std::this_thread::get_id());
+    assert(coro::sync_wait(thread_after_schedule(scheduler)) == worker);
+    
+    std::atomic<int> done{0};
+    for (int i = 0; i < 100; ++i) {
+        scheduler.spawn([](std::atomic<int>& counter) -> coro::Task<> {
+            counter.fetch_add(1);
+            co_return;
+        }(done));
+    }
+    for (int i = 0; i < 200 && done.load() < 100; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    assert(done.load() == 100);
+    
+    std::cout << "Scheduler tests passed!" << std::endl;
+}
+
+void test_coroutine_method_dispatch() {
+    std::cout << "Testing coroutine methods..." << std::endl;
+    
+    coro::Scheduler scheduler;
+    DispatcherBase dispatcher;
+    coro::register_method(dispatcher, "sum", scheduler, [](json params) -> coro::Task<json> {
+        co_return co_await add_three(params[0], params[1], params[2]);
+    });
+    coro::register_method(dispatcher, "fail", scheduler, [](json) -> coro::Task<json> {
+        throw InvalidParamsError("bad input");
+        co_return nullptr;
+    });
+    
+    assert(dispatcher.dispatch("sum", json::array({1, 2, 3})) == 6);
+    
+    bool threw = false;
+    try {
+        dispatcher.dispatch("fail", json::object());
+    } catch (const InvalidParamsError&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Coroutine method tests passed!" << std::endl;
+}
+
+void test_chained_calls(Session& server_session, Session& client_session) {
+    std::cout << "Testing chained coroutine calls..." << std::endl;
+    
+    // back：在执行器中休眠，模拟耗时的下游服务
+    DispatcherBase back;
+    back.register_method("slow_double", [](const json& params) -> json {
+        std::this_thread::sleep_for(200ms);
+        return params[0].get<int>() * 2;
+    });
+    ExecutorOptions executor_options;
+    executor_options.num_threads = 8;
+    Executor executor(executor_options);
+    ServerOptions back_options;
+    back_options.executor = &executor;
+    Server back_server("test/coro/back", back, server_session, back_options);
+    back_server.start();
+    
+    // front：协程方法等待 back，只有一个调度线程
+    coro::Scheduler scheduler(1);
+    Client back_client("test/coro/back", server_session);
+    DispatcherBase front;
+    coro::register_method(front, "quadruple", scheduler, [&](json params) -> coro::Task<json> {
+        json twice = co_await coro::call(back_client, scheduler, "slow_double", params);
+        json next = json::array({twice});
+        co_return co_await coro::call(back_client, scheduler, "slow_double", next);
+    });
+    Server front_server("test/coro/front", front, server_session);
+    front_server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    Client client("test/coro/front", client_session);
+    assert(client.call("quadruple", json::array({3})) == 12);
+    
+    // 8 个调用各需两跳 200ms；若每跳占用调度线程，总耗时约 3.2s
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<json>> calls;
+    for (int i = 0; i < 8; ++i) {
+        calls.push_back(client.call_async("quadruple", json::array({i})));
+    }
+    for (int i = 0; i < 8; ++i) {
+        assert(calls[i].get() == i * 4);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "  8 chained calls took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+    assert(elapsed < 1500ms);
+    
+    // 下游错误在 co_await 处抛出，作为 front 的错误回复
+    bool threw = false;
+    try {
+        client.call("quadruple", json::array({"x"}));
+    } catch (const RpcError&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    front_server.stop();
+    back_server.stop();
+    std::cout << "Chained call tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_tasks();
+        test_scheduler();
+        test_coroutine_method_dispatch();
+        
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_chained_calls(server_session, client_session);
+        
+        std::cout << "\nAll coroutine tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file test_encode_buffers.cpp
+ * @brief 可复用编码缓冲区测试
+ * 
+ * 验证 encode_*_into 与原有编码函数输出一致、复用缓冲区时不再分配内存，
+ * 以及 encode_payload 的缓冲区在 zenoh::Bytes 释放后归还到池中。
+ */
+
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+#include "zenoh_rpc/payload.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+using namespace zenoh_rpc;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+/**
+ * @brief 统计执行 fn 期间的堆分配次数
+ */
+template<typename Fn>
+size_t count_allocations(Fn&& fn) {
+    size_t before = g_allocations.load();
+    fn();
+    return g_allocations.load() - before;
+}
+
+json make_message() {
+    json params = json::array();
+    for (int i = 0; i < 100; ++i) {
+        params.push_back({{"index", i}, {"label", "item-" + std::to_string(i)}, {"ratio", i / 3.0}});
+    }
+    return make_request("process", params, "encode-test-id");
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void test_encode_into_matches_encode(const json& message) {
+    std::cout << "Testing encode_into output..." << std::endl;
+    
+    std::string out = "stale contents";
+    encode_json_into(message, out);
+    assert(out == message.dump());
+    assert(out == encode_json(message));
+    
+    encode_msgpack_into(message, out);
+    std::vector<std::uint8_t> packed = json::to_msgpack(message);
+    assert(out == std::string(packed.begin(), packed.end()));
+    assert(out == encode_msgpack(message));
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        encode_into(message, type, out);
+        assert(out == encode(message, type));
+        assert(decode(out, type) == message);
+    }
+    
+    std::cout << "encode_into output matches encode" << std::endl;
+}
+
+/**
+ * @brief 统计复用已预热缓冲区编码一次的分配次数
+ */
+size_t warm_encode_allocations(const json& message, EncodingType type) {
+    std::string buffer;
+    encode_into(message, type, buffer);  // 预热，扩展容量
+    size_t allocations = count_allocations([&] { encode_into(message, type, buffer); });
+    for (int i = 0; i < 10; ++i) {
+        assert(count_allocations([&] { encode_into(message, type, buffer); }) == allocations);
+    }
+    return allocations;
+}
+
+void test_encode_into_reuses_capacity(const json& message) {
+    std::cout << "Testing buffer reuse..." << std::endl;
+    
+    // 结构相同、输出大 1MB 的消息
+    json large = message;
+    large["params"][0]["label"] = std::string(1 << 20, 'x');
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        // 复用缓冲区时剩余的分配来自 nlohmann 内部（序列化器状态、MessagePack 键），
+        // 与输出大小无关；输出缓冲区本身不再分配
+        size_t warm = warm_encode_allocations(large, type);
+        assert(warm == warm_encode_allocations(message, type));
+        assert(count_allocations([&] { encode(large, type); }) > warm);
+        std::cout << (type == EncodingType::JSON ? "JSON" : "MessagePack")
+                  << " warm encode: " << warm << " allocations" << std::endl;
+    }
+    
+    std::cout << "Warm buffers encode without growing" << std::endl;
+}
+
+void test_encode_payload_pool(const json& message) {
+    std::cout << "Testing encode_payload buffer pool..." << std::endl;
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        zenoh::Bytes bytes = encode_payload(message, type);
+        assert(decode_payload(bytes, type) == message);
+    }
+    
+    // 释放 Bytes 后缓冲区回到池中，下一次编码直接取用
+    size_t pooled = pooled_encode_buffers();
+    assert(pooled >= 1);
+    {
+        zenoh::Bytes bytes = encode_payload(message, EncodingType::JSON);
+        assert(pooled_encode_buffers() == pooled - 1);
+    }
+    assert(pooled_encode_buffers() == pooled);
+    
+    // 超大缓冲区不保留在池中
+    json large = make_response_ok(std::string(8u << 20, 'x'), "large-id");
+    {
+        zenoh::Bytes bytes = encode_payload(large, EncodingType::MSGPACK);
+        assert(bytes.size() > (8u << 20));
+    }
+    assert(pooled_encode_buffers() == pooled - 1);
+    
+    std::cout << "Encode buffers are returned to the pool" << std::endl;
+}
+
+int main() {
+    try {
+        json message = make_message();
+        test_encode_into_matches_encode(message);
+        test_encode_into_reuses_capacity(message);
+        test_encode_payload_pool(message);
+        std::cout << "\nAll encode buffer tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
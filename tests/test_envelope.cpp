@@ -0,0 +1,182 @@
+/**
+ * @file test_envelope.cpp
+ * @brief 信封扫描测试
+ * 
+ * 验证 JSON 和 MessagePack 载荷的单遍扫描：信封字段、参数和结果的原始字节范围、
+ * 批量消息、转义、重复键以及语法错误。不需要网络。
+ */
+
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+using namespace zenoh_rpc;
+
+/**
+ * @brief 以指定编码编码后扫描
+ */
+ScannedMessage scan(const json& message, EncodingType type, std::string& storage) {
+    storage = encode(message, type);
+    return scan_message(storage.data(), storage.size(), type);
+}
+
+/**
+ * @brief 扫描应当失败
+ */
+bool scan_fails(const std::string& payload, EncodingType type) {
+    try {
+        scan_message(payload.data(), payload.size(), type);
+    } catch (const ParseError&) {
+        return true;
+    }
+    return false;
+}
+
+void test_request_fields() {
+    std::cout << "Testing request fields..." << std::endl;
+    
+    json request = make_request("math.add", json{{"a", 1}, {"nested", {{"list", {1, 2, 3}}}}}, "req-1");
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        std::string storage;
+        ScannedMessage message = scan(request, type, storage);
+        assert(!message.is_batch && message.entries.size() == 1);
+        const Envelope& envelope = message.entries.front();
+        assert(envelope.encoding == type);
+        assert(envelope.is_object && envelope.version_ok);
+        assert(envelope.method_kind == ValueKind::STRING && envelope.method == "math.add");
+        assert(envelope.id_kind == ValueKind::STRING && envelope.id == "req-1");
+        assert(envelope.params_kind == ValueKind::OBJECT);
+        assert(envelope.result_kind == ValueKind::ABSENT && envelope.error_kind == ValueKind::ABSENT);
+        assert(envelope.is_valid_request() && !envelope.is_valid_notification());
+        
+        // 参数的原始字节是载荷的一部分，单独解码得到原来的参数
+        assert(envelope.params.data() >= storage.data() &&
+               envelope.params.data() + envelope.params.size() <= storage.data() + storage.size());
+        assert(envelope.parse_params() == request["params"]);
+    }
+    
+    std::cout << "Request field tests passed!" << std::endl;
+}
+
+void test_responses_and_notifications() {
+    std::cout << "Testing responses and notifications..." << std::endl;
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        std::string storage;
+        json ok = make_response_ok(json::array({std::string(4096, 'x'), 1.5, nullptr}), "r1");
+        Envelope envelope = scan(ok, type, storage).entries.front();
+        assert(envelope.result_kind == ValueKind::ARRAY && envelope.id == "r1");
+        assert(envelope.parse_result() == ok["result"]);
+        assert(envelope.parse_error().is_null());
+        
+        json err = make_response_err(-32601, "Method not found", "r2", json{{"hint", "x"}});
+        envelope = scan(err, type, storage).entries.front();
+        assert(envelope.error_kind == ValueKind::OBJECT && envelope.result_kind == ValueKind::ABSENT);
+        assert(envelope.parse_error() == err["error"]);
+        
+        json notification = make_notification("set_led", json{{"on", true}});
+        envelope = scan(notification, type, storage).entries.front();
+        assert(envelope.is_valid_notification() && !envelope.is_valid_request());
+        
+        // 没有 params 时解析为空对象；params 不是对象或数组时无效
+        envelope = scan(json{{"jsonrpc", "2.0"}, {"method", "m"}, {"id", 7}}, type, storage).entries.front();
+        assert(envelope.id_kind == ValueKind::NUMBER && envelope.is_valid_request());
+        assert(envelope.parse_params() == json::object());
+        envelope = scan(json{{"jsonrpc", "2.0"}, {"method", "m"}, {"id", "1"}, {"params", 3}}, type, storage).entries.front();
+        assert(envelope.params_kind == ValueKind::NUMBER && !envelope.is_valid_request());
+        envelope = scan(json{{"jsonrpc", "1.0"}, {"method", "m"}, {"id", "1"}}, type, storage).entries.front();
+        assert(!envelope.version_ok && !envelope.is_valid_request());
+        envelope = scan(json{{"jsonrpc", "2.0"}, {"method", 5}, {"id", "1"}}, type, storage).entries.front();
+        assert(envelope.method_kind == ValueKind::NUMBER && !envelope.is_valid_request());
+    }
+    
+    std::cout << "Response and notification tests passed!" << std::endl;
+}
+
+void test_batches() {
+    std::cout << "Testing batches..." << std::endl;
+    
+    json batch = json::array({make_request("a", json::array({1}), "1"), 42, make_notification("b"), "text"});
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        std::string storage;
+        ScannedMessage message = scan(batch, type, storage);
+        assert(message.is_batch && message.entries.size() == 4);
+        assert(message.entries[0].is_valid_request() && message.entries[0].method == "a");
+        assert(!message.entries[1].is_object && !message.entries[3].is_object);
+        assert(message.entries[2].is_valid_notification());
+        
+        message = scan(json::array(), type, storage);
+        assert(message.is_batch && message.entries.empty());
+        
+        Envelope single = scan_envelope(storage.data(), storage.size(), type);
+        assert(!single.is_object);
+    }
+    
+    std::cout << "Batch tests passed!" << std::endl;
+}
+
+void test_json_details() {
+    std::cout << "Testing JSON details..." << std::endl;
+    
+    // 转义的键和值、空白、重复键（以最后一次为准）
+    std::string payload = " {\"json\\u0072pc\" : \"2.0\", \"method\":\"a\", \"method\":\"say\\n\\\"hi\\\"\","
+                          " \"id\":\"\\u00e9\", \"params\" : [ 1 , { \"k\" : -0.5e+3 } , true, false, null ] } \n";
+    Envelope envelope = scan_envelope(payload.data(), payload.size(), EncodingType::JSON);
+    assert(envelope.version_ok);
+    assert(envelope.method == "say\n\"hi\"");
+    assert(envelope.id == "\xc3\xa9");
+    assert(envelope.params == "[ 1 , { \"k\" : -0.5e+3 } , true, false, null ]");
+    assert(envelope.parse_params() == json::parse("[1, {\"k\": -500.0}, true, false, null]"));
+    
+    assert(scan_fails("", EncodingType::JSON));
+    assert(scan_fails("{\"id\": }", EncodingType::JSON));
+    assert(scan_fails("{\"id\": 1,}", EncodingType::JSON));
+    assert(scan_fails("{\"id\": 01}", EncodingType::JSON));
+    assert(scan_fails("{\"id\": tru}", EncodingType::JSON));
+    assert(scan_fails("{\"id\": \"a\\x\"}", EncodingType::JSON));
+    assert(scan_fails("{\"id\": \"a\nb\"}", EncodingType::JSON));
+    assert(scan_fails("{\"id\": 1} x", EncodingType::JSON));
+    assert(scan_fails("[{\"id\": 1}", EncodingType::JSON));
+    assert(scan_fails(std::string(1000, '[') + std::string(1000, ']'), EncodingType::JSON));
+    
+    std::cout << "JSON detail tests passed!" << std::endl;
+}
+
+void test_msgpack_details() {
+    std::cout << "Testing MessagePack details..." << std::endl;
+    
+    // str16 方法名、bin 值和各种宽度的整数
+    json message = {{"jsonrpc", "2.0"}, {"method", std::string(300, 'm')}, {"id", "1"},
+                    {"params", json::array({json::binary({1, 2, 3}), -1, 1u << 20, 3.25, -70000})}};
+    std::string storage = encode(message, EncodingType::MSGPACK);
+    Envelope envelope = scan_envelope(storage.data(), storage.size(), EncodingType::MSGPACK);
+    assert(envelope.is_valid_request() && envelope.method.size() == 300);
+    assert(envelope.parse_params() == message["params"]);
+    
+    // 截断的载荷和保留的类型字节
+    for (size_t size = 0; size < storage.size(); ++size) {
+        assert(scan_fails(storage.substr(0, size), EncodingType::MSGPACK));
+    }
+    assert(scan_fails(std::string("\xc1"), EncodingType::MSGPACK));
+    assert(scan_fails(storage + "\x01", EncodingType::MSGPACK));
+    
+    std::cout << "MessagePack detail tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_request_fields();
+        test_responses_and_notifications();
+        test_batches();
+        test_json_details();
+        test_msgpack_details();
+        
+        std::cout << "\nAll envelope tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
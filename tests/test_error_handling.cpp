@@ -104,11 +104,77 @@ void test_error_code_consistency() {
     std::cout << "All error codes match Python version!" << std::endl;
 }
 
+void test_rpc_result() {
+    std::cout << "\nTesting RpcResult..." << std::endl;
+    
+    RpcResult ok = RpcResult::ok(json{{"sum", 3}});
+    assert(ok.is_ok());
+    assert(ok);
+    assert(ok.value()["sum"] == 3);
+    
+    RpcResult err = RpcResult::err(-32602, "Invalid params", json{{"index", 1}});
+    assert(!err.is_ok());
+    assert(err.error().code == -32602);
+    assert(err.error().message == "Invalid params");
+    assert(err.error().data["index"] == 1);
+    
+    // value() 在错误状态下抛出与错误代码对应的异常
+    try {
+        err.value();
+        assert(false);
+    } catch (const InvalidParamsError& e) {
+        assert(e.get_code() == -32602);
+        assert(e.get_data()["index"] == 1);
+    }
+    
+    // 未知错误代码映射为 ServerError
+    try {
+        throw_rpc_error(-1, "custom");
+    } catch (const ServerError& e) {
+        assert(std::string(e.what()) == "custom");
+    }
+    
+    // make_rpc_error() 与 throw_rpc_error() 的映射相同，但不抛出
+    std::exception_ptr stale = make_rpc_error(-32003, "stale", json{{"version", 2}});
+    try {
+        std::rethrow_exception(stale);
+    } catch (const StaleMethodIdError& e) {
+        assert(e.get_data()["version"] == 2);
+    }
+    assert(!ok.exception());
+    try {
+        std::rethrow_exception(err.exception());
+    } catch (const InvalidParamsError& e) {
+        assert(std::string(e.what()) == "Invalid params");
+    }
+    
+    // 由异常创建的结果保留原始异常
+    RpcResult from_rpc = RpcResult::from_exception(std::make_exception_ptr(TimeoutError("late", json{{"ms", 5}})));
+    assert(from_rpc.error().code == -32002 && from_rpc.error().message == "late" && from_rpc.error().data["ms"] == 5);
+    RpcResult from_std = RpcResult::from_exception(std::make_exception_ptr(std::runtime_error("boom")));
+    assert(from_std.error().code == -32603 && from_std.error().message == "Internal error: boom");
+    try {
+        from_std.value();
+        assert(false);
+    } catch (const std::runtime_error& e) {
+        assert(std::string(e.what()) == "boom");
+    }
+    
+    // 移出成功值和错误信息
+    json moved = RpcResult::ok(json::array({1, 2})).value();
+    assert(moved == json::array({1, 2}));
+    RpcErrorInfo info = RpcResult::err(-32601, "missing", json{{"name", "x"}}).error();
+    assert(info.code == -32601 && info.data["name"] == "x");
+    
+    std::cout << "All RpcResult tests passed!" << std::endl;
+}
+
 int main() {
     try {
         test_error_classes();
         test_error_response_generation();
         test_error_code_consistency();
+        test_rpc_result();
         
         std::cout << "\n✅ All error handling tests passed successfully!" << std::endl;
         std::cout << "\n🎯 Error handling system improvements completed:" << std::endl;
@@ -0,0 +1,153 @@
+/**
+ * @file test_executor.cpp
+ * @brief 服务器工作线程池测试
+ * 
+ * 验证有界队列、执行器的任务执行、拒绝策略和指标统计。
+ */
+
+#include "zenoh_rpc/executor.hpp"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace zenoh_rpc;
+
+void test_bounded_queue() {
+    std::cout << "Testing bounded queue..." << std::endl;
+    
+    BoundedQueue<int> queue(2);
+    assert(queue.try_push(1));
+    assert(queue.try_push(2));
+    assert(!queue.try_push(3));  // 队列已满
+    assert(queue.size() == 2);
+    
+    assert(*queue.pop() == 1);   // 先进先出
+    assert(queue.try_push(3));
+    assert(*queue.pop() == 2);
+    assert(*queue.pop() == 3);
+    
+    queue.close();
+    assert(!queue.try_push(4));  // 关闭后拒绝
+    assert(!queue.pop().has_value());
+    
+    std::cout << "Bounded queue tests passed!" << std::endl;
+}
+
+void test_executor_runs_all_tasks() {
+    std::cout << "\nTesting executor task execution..." << std::endl;
+    
+    std::atomic<int> counter{0};
+    ExecutorOptions options;
+    options.num_threads = 4;
+    options.queue_capacity = 8;
+    options.overflow = OverflowPolicy::BLOCK;
+    
+    Executor executor(options);
+    assert(executor.num_threads() == 4);
+    for (int i = 0; i < 1000; ++i) {
+        assert(executor.submit([&counter] { counter++; }));
+    }
+    executor.shutdown();
+    
+    ExecutorMetrics metrics = executor.metrics();
+    assert(counter == 1000);
+    assert(metrics.submitted == 1000);
+    assert(metrics.completed == 1000);
+    assert(metrics.rejected == 0);
+    assert(metrics.queue_depth == 0);
+    assert(metrics.max_queue_depth <= 8);
+    std::cout << "Max queue depth: " << metrics.max_queue_depth
+              << ", average wait: " << metrics.average_wait().count() << "ns" << std::endl;
+    
+    // 关闭后拒绝新任务
+    assert(!executor.submit([] {}));
+    
+    std::cout << "Executor execution tests passed!" << std::endl;
+}
+
+void test_executor_rejects_when_full() {
+    std::cout << "\nTesting executor overflow rejection..." << std::endl;
+    
+    std::atomic<bool> release{false};
+    ExecutorOptions options;
+    options.num_threads = 1;
+    options.queue_capacity = 1;
+    options.overflow = OverflowPolicy::REJECT;
+    
+    Executor executor(options);
+    // 第一个任务占住唯一的工作线程
+    std::atomic<bool> started{false};
+    assert(executor.submit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    }));
+    while (!started) {
+        std::this_thread::yield();
+    }
+    
+    assert(executor.submit([] {}));   // 填满队列
+    assert(!executor.submit([] {}));  // 队列已满，拒绝
+    
+    release = true;
+    executor.shutdown();
+    
+    ExecutorMetrics metrics = executor.metrics();
+    assert(metrics.submitted == 2);
+    assert(metrics.completed == 2);
+    assert(metrics.rejected == 1);
+    assert(metrics.max_wait.count() > 0);
+    
+    std::cout << "Executor overflow tests passed!" << std::endl;
+}
+
+void test_try_submit_never_blocks() {
+    std::cout << "\nTesting non-blocking submit..." << std::endl;
+    
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    ExecutorOptions options;
+    options.num_threads = 1;
+    options.queue_capacity = 1;
+    options.overflow = OverflowPolicy::BLOCK;
+    
+    Executor executor(options);
+    assert(executor.try_submit([&] {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    }));
+    while (!started) {
+        std::this_thread::yield();
+    }
+    
+    assert(executor.try_submit([] {}));   // 填满队列
+    assert(!executor.try_submit([] {}));  // BLOCK 策略下也立即返回
+    
+    release = true;
+    executor.shutdown();
+    
+    ExecutorMetrics metrics = executor.metrics();
+    assert(metrics.submitted == 2);
+    assert(metrics.completed == 2);
+    assert(metrics.rejected == 0);
+    
+    std::cout << "Non-blocking submit tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_bounded_queue();
+        test_executor_runs_all_tasks();
+        test_executor_rejects_when_full();
+        test_try_submit_never_blocks();
+        std::cout << "\nAll executor tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_id_generator.cpp
+ * @brief 请求 ID 生成测试
+ * 
+ * 验证 UUID 格式、多线程下的唯一性以及紧凑模式的格式和单调性。
+ */
+
+#include "zenoh_rpc/id_generator.hpp"
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+
+bool is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+}
+
+void test_uuid_format() {
+    std::cout << "Testing UUID format..." << std::endl;
+    
+    for (int i = 0; i < 1000; ++i) {
+        std::string id = gen_uuid();
+        assert(id.size() == kUuidLength);
+        for (size_t pos = 0; pos < id.size(); ++pos) {
+            if (pos == 8 || pos == 13 || pos == 18 || pos == 23) {
+                assert(id[pos] == '-');
+            } else {
+                assert(is_hex(id[pos]));
+            }
+        }
+        assert(id[14] == '4');  // 版本号
+        assert(id[19] == '8' || id[19] == '9' || id[19] == 'a' || id[19] == 'b');  // 变体标识
+    }
+    
+    std::cout << "Example UUID: " << gen_uuid() << std::endl;
+    std::cout << "UUID format tests passed!" << std::endl;
+}
+
+void test_uuid_uniqueness_across_threads() {
+    std::cout << "\nTesting UUID uniqueness across threads..." << std::endl;
+    
+    const int kThreads = 8;
+    const int kPerThread = 10000;
+    std::mutex mutex;
+    std::set<std::string> ids;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            std::vector<std::string> local;
+            local.reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                local.push_back(gen_uuid());
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(local.begin(), local.end());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    assert(ids.size() == static_cast<size_t>(kThreads * kPerThread));
+    std::cout << "Generated " << ids.size() << " unique UUIDs" << std::endl;
+    std::cout << "UUID uniqueness tests passed!" << std::endl;
+}
+
+void test_compact_mode() {
+    std::cout << "\nTesting compact mode..." << std::endl;
+    
+    IdGenerator generator(IdMode::COMPACT);
+    assert(generator.mode() == IdMode::COMPACT);
+    assert(generator.prefix().size() == 8);
+    
+    std::string first = generator.next();
+    std::string second = generator.next();
+    assert(first == generator.prefix() + ".0");
+    assert(second == generator.prefix() + ".1");
+    for (int i = 2; i < 255; ++i) {
+        generator.next();
+    }
+    assert(generator.next() == generator.prefix() + ".ff");
+    assert(generator.next().size() < 16);  // 短字符串优化范围内
+    
+    // 不同生成器使用不同前缀
+    IdGenerator other(IdMode::COMPACT);
+    assert(other.prefix() != generator.prefix());
+    
+    // 运行时切换回 UUID 模式
+    generator.set_mode(IdMode::UUID);
+    assert(generator.next().size() == kUuidLength);
+    
+    // 数字模式与紧凑模式共用计数器
+    generator.set_mode(IdMode::NUMERIC);
+    assert(generator.next() == "257");
+    
+    std::cout << "Example compact ID: " << other.next() << std::endl;
+    std::cout << "Compact mode tests passed!" << std::endl;
+}
+
+void test_compact_uniqueness_across_threads() {
+    std::cout << "\nTesting compact ID uniqueness across threads..." << std::endl;
+    
+    IdGenerator generator(IdMode::COMPACT);
+    const int kThreads = 8;
+    const int kPerThread = 10000;
+    std::mutex mutex;
+    std::set<std::string> ids;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            std::vector<std::string> local;
+            for (int i = 0; i < kPerThread; ++i) {
+                local.push_back(generator.next());
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(local.begin(), local.end());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    assert(ids.size() == static_cast<size_t>(kThreads * kPerThread));
+    std::cout << "Compact ID uniqueness tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_uuid_format();
+        test_uuid_uniqueness_across_threads();
+        test_compact_mode();
+        test_compact_uniqueness_across_threads();
+        std::cout << "\nAll ID generator tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
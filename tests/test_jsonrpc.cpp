@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cassert>
 #include <zenoh_rpc/jsonrpc_proto.hpp>
 #include <zenoh_rpc/errors.hpp>
 
@@ -25,6 +26,36 @@ int main() {
         auto decoded = zenoh_rpc::decode_json(encoded);
         std::cout << "Decoded JSON: " << decoded.dump(2) << std::endl;
         
+        // Test notification creation
+        auto notification = zenoh_rpc::make_notification("set_led", nlohmann::json{{"on", true}});
+        std::cout << "Created JSON-RPC notification: " << notification.dump(2) << std::endl;
+        assert(!notification.contains("id"));
+        assert(zenoh_rpc::is_notification(notification));
+        assert(zenoh_rpc::validate_notification(notification));
+        assert(!zenoh_rpc::validate_request(notification));
+        assert(!zenoh_rpc::is_notification(request));
+        assert(!zenoh_rpc::validate_notification(request));
+        
+        // Test move overloads: moved params/results keep their buffers
+        nlohmann::json big_params = {{"blob", std::string(1 << 20, 'p')}};
+        const char* params_buffer = big_params["blob"].get_ref<const std::string&>().data();
+        auto moved_request = zenoh_rpc::make_request("upload", std::move(big_params), "2");
+        assert(moved_request["params"]["blob"].get_ref<const std::string&>().data() == params_buffer);
+        assert(moved_request["id"] == "2" && zenoh_rpc::validate_request(moved_request));
+        
+        nlohmann::json big_result = nlohmann::json::array({std::string(1 << 20, 'r')});
+        const char* result_buffer = big_result[0].get_ref<const std::string&>().data();
+        auto moved_response = zenoh_rpc::make_response_ok(std::move(big_result), "2");
+        assert(moved_response["result"][0].get_ref<const std::string&>().data() == result_buffer);
+        assert(zenoh_rpc::validate_response(moved_response));
+        
+        // const& overloads still copy and leave the argument untouched
+        nlohmann::json kept = {{"k", "v"}};
+        auto copied_request = zenoh_rpc::make_request("m", kept, "3");
+        assert(kept == nlohmann::json({{"k", "v"}}) && copied_request["params"] == kept);
+        auto moved_notification = zenoh_rpc::make_notification("m", std::move(kept));
+        assert(moved_notification["params"]["k"] == "v");
+        
         // Test error classes
         try {
             throw zenoh_rpc::MethodNotFoundError("Test method not found");
@@ -0,0 +1,217 @@
+/**
+ * @file test_message_parts.cpp
+ * @brief 不构造 JSON 树的消息编码测试
+ * 
+ * 验证从 MessageParts 直接编码的结果与编码 make_request() 等函数构造的消息对象逐字节相同
+ * （JSON、MessagePack、二进制信封），其他编解码器经由 to_json() 编码，
+ * 以及复用输出缓冲区时直接编码请求和响应不分配堆内存。不需要网络。
+ */
+
+#include "zenoh_rpc/binary_envelope.hpp"
+#include "zenoh_rpc/codec.hpp"
+#include "zenoh_rpc/envelope.hpp"
+#include "zenoh_rpc/message_parts.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace zenoh_rpc;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+/**
+ * @brief 统计执行 fn 期间的堆分配次数
+ */
+template<typename Fn>
+size_t count_allocations(Fn&& fn) {
+    size_t before = g_allocations.load();
+    fn();
+    return g_allocations.load() - before;
+}
+
+/**
+ * @struct Case
+ * @brief 消息的组成部分及等价的消息对象
+ */
+struct Case {
+    MessageParts parts;
+    json message;
+};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void test_same_bytes() {
+    std::cout << "Testing byte-identical encoding..." << std::endl;
+    
+    json params = {{"a", 1}, {"b", {1.5, -2, "x"}}};
+    json positional = json::array({1, 2});
+    json result = {{"sum", 3}, {"text", "héllo"}};
+    json null_result = nullptr;
+    json data = {{"retry_ms", 50}};
+    json empty_data = json::object();
+    std::string long_method(300, 'm');
+    std::string long_message(70000, 'e');
+    std::string uuid = gen_uuid();
+    
+    MessageParts by_id = MessageParts::request("math.add", positional, "7");
+    by_id.method_id = 65537;
+    json by_id_message = make_request("math.add", positional, "7");
+    by_id_message["method"] = 65537;
+    MessageParts no_params = MessageParts::request("ping", positional, "1");
+    no_params.params = nullptr;
+    
+    std::vector<Case> cases = {
+        {MessageParts::request("math.add", params, "42"), make_request("math.add", params, "42")},
+        {MessageParts::request("math.add", positional, uuid), make_request("math.add", positional, uuid)},
+        {MessageParts::request("方法\"名\"\n", positional, "a\\b"), make_request("方法\"名\"\n", positional, "a\\b")},
+        {MessageParts::request(long_method, params, "18446744073709551615"),
+         make_request(long_method, params, "18446744073709551615")},
+        {by_id, by_id_message},
+        {no_params, {{"jsonrpc", "2.0"}, {"method", "ping"}, {"id", "1"}}},
+        {MessageParts::notification("tick", params), make_notification("tick", params)},
+        {MessageParts::response_ok(result, "42"), make_response_ok(result, "42")},
+        {MessageParts::response_ok(null_result, "007"), make_response_ok(nullptr, "007")},
+        {MessageParts::response_err(-32601, "Method not found", "9"), make_response_err(-32601, "Method not found", "9")},
+        {MessageParts::response_err(-32000, "Server busy", "null", &data),
+         make_response_err(-32000, "Server busy", "null", data)},
+        {MessageParts::response_err(1, "", "1", &empty_data), make_response_err(1, "", "1", empty_data)},
+        {MessageParts::response_err(-32603, long_message, "1"), make_response_err(-32603, long_message, "1")},
+    };
+    
+    // 整数覆盖 MessagePack 的各种整数格式
+    for (int code : {-5, -32, -33, -128, -129, -32768, -32769, 0, 127, 128, 255, 256, 65535, 65536,
+                     std::numeric_limits<int>::min(), std::numeric_limits<int>::max()}) {
+        cases.push_back({MessageParts::response_err(code, "e", "1"), make_response_err(code, "e", "1")});
+    }
+    for (uint32_t method_id : {0u, 127u, 128u, 255u, 256u, 65535u, 65536u, 4294967295u}) {
+        MessageParts parts = MessageParts::request("m", positional, "1");
+        parts.method_id = method_id;
+        json message = make_request("m", positional, "1");
+        message["method"] = method_id;
+        cases.push_back({parts, message});
+    }
+    
+    for (const auto& c : cases) {
+        assert(c.parts.to_json() == c.message);
+        for (const char* name : {"json", "msgpack", "binary", "cbor", "ubjson", "bson"}) {
+            const Codec& codec = *CodecRegistry::instance().find(name);
+            std::string direct = encode_message(c.parts, codec.type());
+            assert(direct == encode(c.message, codec.type()));
+            
+            std::string through_codec = "stale contents";
+            codec.encode_message_into(c.parts, through_codec);
+            assert(through_codec == direct);
+        }
+    }
+    
+    // 编码结果可以直接扫描
+    std::string encoded = encode_message(by_id, EncodingType::BINARY);
+    Envelope envelope = scan_envelope(encoded.data(), encoded.size(), EncodingType::BINARY);
+    assert(envelope.method_kind == ValueKind::NUMBER && envelope.method_id == 65537);
+    assert(envelope.is_valid_request() && envelope.parse_params() == positional);
+    
+    // 非法 UTF-8 与编码消息对象时一样被拒绝
+    bool rejected = false;
+    try {
+        encode_message(MessageParts::request(std::string("\xff", 1), params, "1"), EncodingType::JSON);
+    } catch (const json::exception&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    // 序列化值时失败（params 中的非法 UTF-8）不影响同一线程上之后的编码
+    json bad_params = {{"text", std::string("ok\xff", 3)}};
+    std::string reused = "stale contents";
+    rejected = false;
+    try {
+        encode_message_into(MessageParts::request("math.add", bad_params, "1"), EncodingType::JSON, reused);
+    } catch (const json::exception&) {
+        rejected = true;
+    }
+    assert(rejected);
+    std::string fresh;
+    encode_message_into(MessageParts::request("math.add", params, "42"), EncodingType::JSON, fresh);
+    assert(fresh == encode(make_request("math.add", params, "42"), EncodingType::JSON));
+    encode_message_into(MessageParts::response_ok(result, "42"), EncodingType::JSON, reused);
+    assert(reused == encode(make_response_ok(result, "42"), EncodingType::JSON));
+    
+    std::cout << "Byte-identical encoding tests passed!" << std::endl;
+}
+
+void test_allocations() {
+    std::cout << "Testing allocations..." << std::endl;
+    
+    json params = {{"values", {1, 2, 3, 4}}, {"name", "sensor-17"}};
+    json result = {{"sum", 10}};
+    std::string id = gen_uuid();
+    std::string out;
+    out.reserve(1024);
+    
+    // 序列化器每次构造时分配缩进字符串；json::to_msgpack() 每次调用分配一个输出适配器，
+    // 并为对象的每个键构造一个临时 json。这部分分配与单独编码参数和结果时相同，不属于信封
+    size_t json_values = count_allocations([&] {
+        encode_json_into(params, out);
+        encode_json_into(result, out);
+    });
+    size_t msgpack_values = count_allocations([&] {
+        encode_msgpack_into(params, out);
+        encode_msgpack_into(result, out);
+    });
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK, EncodingType::BINARY}) {
+        encode_message_into(MessageParts::request("svc.process", params, id), type, out);
+        size_t direct = count_allocations([&] {
+            encode_message_into(MessageParts::request("svc.process", params, id), type, out);
+            encode_message_into(MessageParts::response_ok(result, id), type, out);
+            encode_message_into(MessageParts::response_err(-32602, "Invalid params", id), type, out);
+        });
+        assert(direct == (type == EncodingType::JSON ? json_values : msgpack_values));
+        
+        // 构造消息对象的路径每条消息都要分配
+        size_t tree = count_allocations([&] {
+            encode_into(make_request("svc.process", params, id), type, out);
+            encode_into(make_response_ok(result, id), type, out);
+        });
+        assert(tree > direct);
+        std::cout << codec_for(type).name() << ": " << tree << " allocations with message objects, "
+                  << direct << " without" << std::endl;
+    }
+    
+    std::cout << "Allocation tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_same_bytes();
+        test_allocations();
+        
+        std::cout << "\nAll message parts tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_method_ids.cpp
+ * @brief 方法ID测试
+ * 
+ * 使用本机回环端点验证保留方法 "rpc.methods"、二进制编码客户端以方法ID发送调用，
+ * 以及服务器方法表变化后客户端按方法名重发、重新获取方法ID。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/method_ids";
+const std::string kEndpoint = "tcp/127.0.0.1:7466";
+
+/**
+ * @class CountingDispatcher
+ * @brief 记录调用次数的分发器
+ */
+class CountingDispatcher : public DispatcherBase {
+public:
+    CountingDispatcher() {
+        register_method("add", [this](const json& params) -> json {
+            calls++;
+            return params[0].get<int>() + params[1].get<int>();
+        });
+        register_method("echo", [](const json& params) -> json { return params; });
+    }
+    
+    std::atomic<int> calls{0};
+};
+
+void test_method_id_calls(Session& server_session, Session& client_session) {
+    std::cout << "Testing method id calls..." << std::endl;
+    
+    CountingDispatcher dispatcher;
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    // 任何编码都可以查询方法ID映射
+    Client json_client(kKeyExpr, client_session);
+    json ids = json_client.call("rpc.methods");
+    assert(ids == dispatcher.method_ids());
+    assert(ids["methods"].size() == 2);
+    assert(json_client.refresh_method_ids() == 0);  // 非二进制编码不使用方法ID
+    
+    Client client(kKeyExpr, client_session, "binary");
+    assert(client.refresh_method_ids() == 2);
+    for (int i = 0; i < 10; ++i) {
+        assert(client.call("add", json::array({i, 1})) == i + 1);
+    }
+    assert(dispatcher.calls == 10);
+    
+    // 注册新方法后旧的方法ID失效，调用按方法名重发，只执行一次
+    dispatcher.register_method("late", [](const json&) -> json { return "late"; });
+    assert(client.call("add", json::array({2, 3})) == 5);
+    assert(dispatcher.calls == 11);
+    assert(client.call("late") == "late");
+    assert(client.refresh_method_ids() == 3);
+    assert(client.call("echo", json::array({"x"})) == json::array({"x"}));
+    
+    // 不存在的方法仍然返回 -32601
+    bool not_found = false;
+    try {
+        client.call("missing");
+    } catch (const MethodNotFoundError&) {
+        not_found = true;
+    }
+    assert(not_found);
+    
+    // 关闭方法ID后按方法名发送
+    client.set_method_ids(false);
+    assert(client.refresh_method_ids() == 0);
+    assert(client.call("add", json::array({1, 1})) == 2);
+    
+    // 后台获取：第一次调用按方法名发送，之后使用方法ID
+    Client lazy(kKeyExpr, client_session, "binary");
+    for (int i = 0; i < 20; ++i) {
+        assert(lazy.call("add", json::array({i, i})) == 2 * i);
+    }
+    
+    server.stop();
+    std::cout << "Method id call tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_method_id_calls(server_session, client_session);
+        
+        std::cout << "\nAll method id tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file test_method_table.cpp
+ * @brief 方法表测试
+ * 
+ * 验证完美哈希索引、只移动的小型可调用对象、分发器发布前后的行为，
+ * 分发过程中并发注册和注销方法，方法ID的分配和失效，以及派生类读取注册表。不需要网络。
+ */
+
+#include "zenoh_rpc/jsonrpc_server.hpp"
+#include "zenoh_rpc/errors.hpp"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+
+void test_perfect_hash_index() {
+    std::cout << "Testing perfect hash index..." << std::endl;
+    
+    PerfectHashIndex empty;
+    assert(empty.size() == 0);
+    assert(empty.find("anything") == PerfectHashIndex::npos);
+    
+    for (size_t n : {1, 2, 7, 100, 5000}) {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back("service.method_" + std::to_string(i));
+        }
+        PerfectHashIndex index(keys);
+        assert(index.size() == n);
+        assert(index.slot_count() >= n);
+        for (size_t i = 0; i < n; ++i) {
+            assert(index.find(keys[i]) == i);
+            assert(index.key(i) == keys[i]);
+        }
+        assert(index.find("service.method_") == PerfectHashIndex::npos);
+        assert(index.find("service.method_" + std::to_string(n)) == PerfectHashIndex::npos);
+        assert(index.find("") == PerfectHashIndex::npos);
+    }
+    
+    bool threw = false;
+    try {
+        PerfectHashIndex duplicate({"a", "b", "a"});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Perfect hash index tests passed!" << std::endl;
+}
+
+void test_unique_function() {
+    std::cout << "Testing unique function..." << std::endl;
+    
+    UniqueFunction<int(int)> small = [](int x) { return x + 1; };
+    assert(small(1) == 2 && small.is_inline());
+    
+    // 只移动的捕获
+    auto owned = std::make_unique<int>(10);
+    UniqueFunction<int(int)> move_only = [owned = std::move(owned)](int x) { return x + *owned; };
+    assert(move_only(1) == 11);
+    
+    // 超过内联缓冲区的捕获在堆上保存
+    std::array<char, 128> large{};
+    large[0] = 5;
+    UniqueFunction<int(int)> heap = [large](int x) { return x + large[0]; };
+    assert(!heap.is_inline() && heap(1) == 6);
+    
+    UniqueFunction<int(int)> moved = std::move(heap);
+    assert(!heap && moved(2) == 7);
+    
+    // 空的 std::function 和函数指针得到空对象
+    std::function<int(int)> empty_function;
+    UniqueFunction<int(int)> from_empty = empty_function;
+    assert(!from_empty);
+    
+    bool threw = false;
+    try {
+        from_empty(1);
+    } catch (const std::bad_function_call&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Unique function tests passed!" << std::endl;
+}
+
+void test_published_dispatcher() {
+    std::cout << "Testing published dispatcher..." << std::endl;
+    
+    DispatcherBase dispatcher;
+    for (int i = 0; i < 100; ++i) {
+        dispatcher.register_method("m" + std::to_string(i), [i](const json&) -> json { return i; });
+    }
+    dispatcher.register_async_method("async", [](const json& params, ReplyHandle reply) {
+        reply.resolve(params);
+    });
+    // 同名注册替换原有的处理函数
+    dispatcher.register_method("m0", [](const json&) -> json { return "replaced"; });
+    
+    assert(!dispatcher.is_published());
+    assert(dispatcher.method_count() == 101);
+    assert(dispatcher.dispatch("m0", json::object()) == "replaced");
+    
+    dispatcher.publish();
+    dispatcher.publish();
+    assert(dispatcher.is_published());
+    assert(dispatcher.has_method("m42") && !dispatcher.has_method("m100"));
+    for (int i = 1; i < 100; ++i) {
+        assert(dispatcher.dispatch("m" + std::to_string(i), json::object()) == i);
+    }
+    assert(dispatcher.dispatch("m0", json::object()) == "replaced");
+    assert(dispatcher.dispatch("async", json::array({1})) == json::array({1}));
+    
+    bool not_found = false;
+    try {
+        dispatcher.dispatch("missing", json::object());
+    } catch (const MethodNotFoundError&) {
+        not_found = true;
+    }
+    assert(not_found);
+    
+    // 发布后仍可注册、替换和注销
+    dispatcher.register_method("late", [](const json&) -> json { return "late"; });
+    assert(dispatcher.dispatch("late", json::object()) == "late");
+    assert(dispatcher.method_count() == 102);
+    dispatcher.register_method("late", [](const json&) -> json { return "later"; });
+    assert(dispatcher.dispatch("late", json::object()) == "later");
+    
+    assert(dispatcher.unregister_method("late"));
+    assert(!dispatcher.unregister_method("late"));
+    assert(!dispatcher.has_method("late"));
+    assert(dispatcher.method_count() == 101);
+    assert(dispatcher.dispatch("m42", json::object()) == 42);
+    
+    std::cout << "Published dispatcher tests passed!" << std::endl;
+}
+
+void test_live_registration() {
+    std::cout << "Testing live registration..." << std::endl;
+    
+    DispatcherBase dispatcher;
+    dispatcher.register_method("stable", [](const json&) -> json { return 1; });
+    dispatcher.publish();
+    
+    // 读者持续分发，写者反复注册和注销 "flag"
+    std::atomic<bool> stop{false};
+    std::atomic<int> stable_calls{0};
+    std::atomic<int> flag_calls{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                assert(dispatcher.dispatch("stable", json::object()) == 1);
+                stable_calls.fetch_add(1);
+                try {
+                    assert(dispatcher.dispatch("flag", json::object()) == "on");
+                    flag_calls.fetch_add(1);
+                } catch (const MethodNotFoundError&) {
+                }
+            }
+        });
+    }
+    
+    for (int i = 0; i < 200; ++i) {
+        dispatcher.register_method("flag", [](const json&) -> json { return "on"; });
+        assert(dispatcher.has_method("flag"));
+        std::this_thread::yield();
+        assert(dispatcher.unregister_method("flag"));
+        assert(!dispatcher.has_method("flag"));
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    assert(stable_calls.load() > 0);
+    std::cout << "  stable calls: " << stable_calls.load() << ", flag calls: " << flag_calls.load() << std::endl;
+    
+    // 注销不影响正在执行的调用
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    auto token = std::make_shared<int>(7);
+    dispatcher.register_method("slow", [&entered, &release, token](const json&) -> json {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        return *token;
+    });
+    token.reset();
+    json slow_result;
+    std::thread caller([&] { slow_result = dispatcher.dispatch("slow", json::object()); });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    assert(dispatcher.unregister_method("slow"));
+    release = true;
+    caller.join();
+    assert(slow_result == 7);
+    
+    std::cout << "Live registration tests passed!" << std::endl;
+}
+
+void test_method_ids() {
+    std::cout << "Testing method ids..." << std::endl;
+    
+    DispatcherBase dispatcher;
+    assert(dispatcher.method_ids() == json({{"version", 0}, {"methods", json::object()}}));
+    for (int i = 0; i < 20; ++i) {
+        dispatcher.register_method("m" + std::to_string(i), [i](const json&) -> json { return i; });
+    }
+    dispatcher.publish();
+    
+    json ids = dispatcher.method_ids();
+    assert(ids["version"].get<uint32_t>() != 0);
+    assert(ids["methods"].size() == 20);
+    for (int i = 0; i < 20; ++i) {
+        uint32_t id = ids["methods"]["m" + std::to_string(i)].get<uint32_t>();
+        assert(dispatcher.has_method(id));
+        json result;
+        dispatcher.dispatch_async(id, json::object(), [&result](std::exception_ptr error, json value) {
+            assert(!error);
+            result = std::move(value);
+        });
+        assert(result == i);
+    }
+    
+    // 重新发布后旧的方法ID全部失效
+    uint32_t old_id = ids["methods"]["m3"].get<uint32_t>();
+    dispatcher.register_method("extra", [](const json&) -> json { return "extra"; });
+    json fresh = dispatcher.method_ids();
+    assert(fresh["version"] != ids["version"] && fresh["methods"].size() == 21);
+    assert(!dispatcher.has_method(old_id));
+    bool stale = false;
+    dispatcher.dispatch_async(old_id, json::object(), [&stale](std::exception_ptr error, json) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const StaleMethodIdError& e) {
+            stale = e.get_code() == -32003;
+        }
+    });
+    assert(stale);
+    assert(dispatcher.has_method(fresh["methods"]["m3"].get<uint32_t>()));
+    
+    std::cout << "Method id tests passed!" << std::endl;
+}
+
+/**
+ * @class ListingDispatcher
+ * @brief 通过受保护接口读取注册表的派生类
+ */
+class ListingDispatcher : public DispatcherBase {
+public:
+    ListingDispatcher() {
+        register_method("b", [](const json&) -> json { return 2; });
+        register_method("a", [](const json&) -> json { return 1; });
+    }
+    
+    std::vector<std::string> names() const { return method_names(); }
+};
+
+void test_subclass_access() {
+    std::cout << "Testing subclass access to the registry..." << std::endl;
+    
+    ListingDispatcher dispatcher;
+    assert(dispatcher.names() == std::vector<std::string>({"a", "b"}));
+    dispatcher.publish();
+    dispatcher.unregister_method("a");
+    assert(dispatcher.names() == std::vector<std::string>({"b"}));
+    
+    std::cout << "Subclass access tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_perfect_hash_index();
+        test_unique_function();
+        test_published_dispatcher();
+        test_live_registration();
+        test_method_ids();
+        test_subclass_access();
+        
+        std::cout << "\nAll method table tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
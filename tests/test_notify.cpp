@@ -0,0 +1,132 @@
+/**
+ * @file test_notify.cpp
+ * @brief 通知测试
+ * 
+ * 使用本机回环端点验证 Client::notify() 的完整路径：
+ * - 通知经发布者到达服务器的订阅者，方法以发送的参数执行
+ * - 通知不是查询：服务器不回复，方法出错也不产生错误响应
+ * - JSON 和 MessagePack 客户端都可以发送通知
+ * - 会话缓存的发布者在 close() 之后仍由持有者保持有效
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/notify";
+const std::string kEndpoint = "tcp/127.0.0.1:7472";
+
+/**
+ * @class RecordingDispatcher
+ * @brief 记录收到的通知参数
+ */
+class RecordingDispatcher : public DispatcherBase {
+public:
+    RecordingDispatcher() {
+        register_method("record", [this](const json& params) -> json {
+            std::lock_guard<std::mutex> lock(mutex_);
+            received_.push_back(params);
+            return nullptr;
+        });
+        register_method("fail", [this](const json&) -> json {
+            failures_++;
+            throw std::runtime_error("handler failed");
+        });
+    }
+    
+    std::vector<json> received() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+    
+    int failures() const { return failures_.load(); }
+
+private:
+    std::mutex mutex_;
+    std::vector<json> received_;
+    std::atomic<int> failures_{0};
+};
+
+/**
+ * @brief 等待服务器执行的通知数达到 count
+ */
+void wait_for_notifications(const Server& server, uint64_t count) {
+    for (int i = 0; i < 100 && server.stats().notifications < count; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    assert(server.stats().notifications >= count);
+}
+
+void test_notify_executes_without_reply(Session& server_session, Session& client_session) {
+    std::cout << "Testing notify()..." << std::endl;
+    
+    RecordingDispatcher dispatcher;
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    Client json_client(kKeyExpr, client_session);
+    Client msgpack_client(kKeyExpr, client_session, "msgpack");
+    json_client.notify("record", json::array({1, "a"}));
+    msgpack_client.notify("record", json{{"led", true}});
+    wait_for_notifications(server, 2);
+    
+    std::vector<json> received = dispatcher.received();
+    assert(received.size() == 2);
+    assert(std::count(received.begin(), received.end(), json::array({1, "a"})) == 1);
+    assert(std::count(received.begin(), received.end(), json{{"led", true}}) == 1);
+    
+    // 方法出错时没有回复，也不计入错误响应
+    json_client.notify("fail");
+    wait_for_notifications(server, 3);
+    assert(dispatcher.failures() == 1);
+    
+    ServerStats stats = server.stats();
+    assert(stats.queries == 0);
+    assert(stats.errors == 0);
+    assert(json_client.pending_calls() == 0);
+    
+    server.stop();
+    std::cout << "notify() tests passed!" << std::endl;
+}
+
+void test_publisher_outlives_close() {
+    std::cout << "Testing cached publisher across close()..." << std::endl;
+    
+    Session session(test::connect_config(kEndpoint));
+    auto publisher = session.get_publisher(kKeyExpr);
+    assert(session.get_publisher(kKeyExpr) == publisher);
+    
+    // 缓存清空后，持有者的发布者仍然是有效对象，最后释放时撤销声明
+    session.close();
+    assert(publisher.use_count() == 1);
+    publisher.reset();
+    
+    std::cout << "Publisher lifetime tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_notify_executes_without_reply(server_session, client_session);
+        test_publisher_outlives_close();
+        
+        std::cout << "\nAll notify tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_pending_calls.cpp
+ * @brief 客户端在途调用测试
+ * 
+ * 使用本机回环端点验证客户端的在途调用表：
+ * - pending_calls() 随异步调用增加，回复到达后回到 0
+ * - 没有服务器应答的调用以 TimeoutError（-32002）完成
+ * - 客户端析构时仍在途的调用立即以 ConnectionError（-32001）完成
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/pending_calls";
+const std::string kEndpoint = "tcp/127.0.0.1:7471";
+
+/**
+ * @class SleepDispatcher
+ * @brief 按参数延迟回复的分发器
+ */
+class SleepDispatcher : public DispatcherBase {
+public:
+    SleepDispatcher() {
+        register_method("sleep", [](const json& params) -> json {
+            std::this_thread::sleep_for(std::chrono::milliseconds(params[0].get<int>()));
+            return params[0];
+        });
+    }
+};
+
+void test_pending_count(Session& session) {
+    std::cout << "Testing pending_calls()..." << std::endl;
+    
+    Client client(kKeyExpr, session);
+    assert(client.pending_calls() == 0);
+    
+    std::vector<std::future<json>> calls;
+    for (int i = 0; i < 3; ++i) {
+        calls.push_back(client.call_async("sleep", json::array({300})));
+    }
+    assert(client.pending_calls() == 3);
+    
+    for (auto& call : calls) {
+        assert(call.get() == 300);
+    }
+    for (int i = 0; i < 50 && client.pending_calls() > 0; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    assert(client.pending_calls() == 0);
+    
+    std::cout << "pending_calls() tests passed!" << std::endl;
+}
+
+void test_timeout_without_server(Session& session) {
+    std::cout << "Testing call without server..." << std::endl;
+    
+    Client client("test/pending_calls/nobody", session, "json", 300ms);
+    auto result = client.try_call("sleep", json::array({0}));
+    assert(!result && result.error().code == -32002);
+    
+    bool threw = false;
+    try {
+        client.call("sleep", json::array({0}));
+    } catch (const TimeoutError&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(client.pending_calls() == 0);
+    
+    std::cout << "Timeout tests passed!" << std::endl;
+}
+
+void test_destroy_with_calls_in_flight(Session& session) {
+    std::cout << "Testing client destruction with calls in flight..." << std::endl;
+    
+    auto client = std::make_unique<Client>(kKeyExpr, session, "json", 5000ms);
+    std::vector<std::future<json>> calls;
+    for (int i = 0; i < 2; ++i) {
+        calls.push_back(client->call_async("sleep", json::array({1000})));
+    }
+    assert(client->pending_calls() == 2);
+    
+    // 析构时在途调用立即完成，不等待服务器回复
+    auto begin = std::chrono::steady_clock::now();
+    client.reset();
+    for (auto& call : calls) {
+        assert(call.wait_for(0ms) == std::future_status::ready);
+        bool threw = false;
+        try {
+            call.get();
+        } catch (const ConnectionError&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    assert(std::chrono::steady_clock::now() - begin < 500ms);
+    
+    std::cout << "Destruction tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        SleepDispatcher dispatcher;
+        Server server(kKeyExpr, dispatcher, server_session);
+        server.start();
+        std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+        
+        test_pending_count(client_session);
+        test_timeout_without_server(client_session);
+        test_destroy_with_calls_in_flight(client_session);
+        
+        // 服务器仍在处理被放弃的调用，回复到达时客户端已经不在
+        server.stop(2s);
+        std::cout << "\nAll pending call tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_server_host.cpp
+ * @brief 多服务托管测试
+ * 
+ * 在一个服务器会话上托管多个分发器（包括通配符键表达式），
+ * 验证请求路由、拒绝相交的键表达式、运行中添加和移除服务以及汇总指标。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kEndpoint = "tcp/127.0.0.1:7462";
+
+/**
+ * @class NamedDispatcher
+ * @brief 返回自身名称的分发器
+ */
+class NamedDispatcher : public DispatcherBase {
+public:
+    explicit NamedDispatcher(const std::string& name) {
+        register_method("whoami", [name](const json&) -> json {
+            return name;
+        });
+        register_method("add", [](const json& params) -> json {
+            return params[0].get<int>() + params[1].get<int>();
+        });
+    }
+};
+
+void wait_for_propagation() {
+    std::this_thread::sleep_for(500ms);
+}
+
+bool times_out(Client& client) {
+    try {
+        client.call("whoami", json::object(), 300ms);
+    } catch (const TimeoutError&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    try {
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        
+        NamedDispatcher math("math");
+        NamedDispatcher echo("echo");
+        NamedDispatcher late("late");
+        
+        ExecutorOptions executor_options;
+        executor_options.num_threads = 2;
+        Executor executor(executor_options);
+        ServerOptions options;
+        options.executor = &executor;
+        
+        ServerHost host(server_session, options);
+        host.add_service("test/host/math", math);
+        host.add_service("test/host/echo/**", echo);
+        
+        bool threw = false;
+        try {
+            host.add_service("test/host/math", late);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+        
+        // 与已托管的键表达式相交的服务被拒绝
+        for (const char* overlapping : {"test/host/echo/a", "test/host/*", "test/host/**", "test/*/math"}) {
+            threw = false;
+            try {
+                host.add_service(overlapping, late);
+            } catch (const std::invalid_argument&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+        assert(host.services().size() == 2);
+        
+        // 路由到各自的分发器，通配符服务应答一组键
+        std::cout << "Testing routing..." << std::endl;
+        host.start();
+        assert(host.is_running());
+        wait_for_propagation();
+        
+        Client math_client("test/host/math", client_session);
+        Client echo_a("test/host/echo/a", client_session);
+        Client echo_b("test/host/echo/b/c", client_session);
+        assert(math_client.call("whoami") == "math");
+        assert(math_client.call("add", json::array({2, 3})) == 5);
+        assert(echo_a.call("whoami") == "echo");
+        assert(echo_b.call("whoami") == "echo");
+        std::cout << "Routing tests passed!" << std::endl;
+        
+        // 运行中添加服务
+        std::cout << "Testing add/remove while running..." << std::endl;
+        host.add_service("test/host/late", late);
+        wait_for_propagation();
+        Client late_client("test/host/late", client_session);
+        assert(late_client.call("whoami") == "late");
+        assert(host.services().size() == 3);
+        
+        // 移除服务后不再应答，其他服务不受影响
+        assert(host.remove_service("test/host/late", 1s));
+        assert(!host.remove_service("test/host/late"));
+        assert(times_out(late_client));
+        assert(math_client.call("whoami") == "math");
+        std::cout << "Add/remove tests passed!" << std::endl;
+        
+        // 汇总指标
+        std::cout << "Testing metrics..." << std::endl;
+        bool method_missing = false;
+        try {
+            echo_a.call("missing");
+        } catch (const MethodNotFoundError&) {
+            method_missing = true;
+        }
+        assert(method_missing);
+        
+        ServerHostMetrics metrics = host.metrics();
+        assert(metrics.services.size() == 2);
+        assert(metrics.services["test/host/math"].queries == 3);
+        assert(metrics.services["test/host/echo/**"].queries == 3);
+        assert(metrics.services["test/host/echo/**"].errors == 1);
+        assert(metrics.total.queries == 6);
+        assert(metrics.total.errors == 1);
+        assert(metrics.executor.completed >= 6);
+        assert(&host.executor() == &executor);
+        std::cout << "Metrics tests passed!" << std::endl;
+        
+        // 停止全部服务
+        assert(host.stop(2s));
+        assert(!host.is_running());
+        host.wait();
+        assert(times_out(math_client));
+        
+        std::cout << "\nAll server host tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
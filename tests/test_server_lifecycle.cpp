@@ -0,0 +1,220 @@
+/**
+ * @file test_server_lifecycle.cpp
+ * @brief Server 启动、停止和排空测试
+ * 
+ * 服务器会话监听本机回环端点，客户端会话直连（不依赖路由器和多播），
+ * 验证 stop() 会等待在途请求完成、期限到达时返回 false、
+ * wait() 在 stop() 后返回，停止后可以再次启动，
+ * 以及批量请求的并行块在服务器的执行器中执行。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/server_lifecycle";
+const std::string kEndpoint = "tcp/127.0.0.1:7461";
+
+/**
+ * @class LifecycleDispatcher
+ * @brief 带有快速和慢速方法的分发器
+ */
+class LifecycleDispatcher : public DispatcherBase {
+public:
+    LifecycleDispatcher() {
+        register_method("ping", [](const json&) -> json {
+            return "pong";
+        });
+        register_method("sleep", [](const json& params) -> json {
+            std::this_thread::sleep_for(std::chrono::milliseconds(params[0].get<int>()));
+            return params[0];
+        });
+    }
+};
+
+void wait_until_in_flight(const Server& server, size_t count) {
+    for (int i = 0; i < 200 && server.in_flight() < count; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    assert(server.in_flight() >= count);
+}
+
+void test_start_and_call(Server& server, Client& client) {
+    std::cout << "Testing start..." << std::endl;
+    
+    assert(!server.is_running());
+    server.start();
+    assert(server.is_running());
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    assert(client.call("ping") == "pong");
+    
+    bool threw = false;
+    try {
+        server.start();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Start tests passed!" << std::endl;
+}
+
+void test_stop_drains_in_flight(Server& server, Client& client) {
+    std::cout << "Testing graceful drain..." << std::endl;
+    
+    auto slow = client.call_async("sleep", json::array({300}));
+    wait_until_in_flight(server, 1);
+    
+    assert(server.stop(2s));
+    assert(!server.is_running());
+    assert(server.in_flight() == 0);
+    assert(slow.get() == 300);
+    
+    // 撤销声明后不再有应答
+    bool timed_out = false;
+    try {
+        client.call("ping", json::object(), 300ms);
+    } catch (const TimeoutError&) {
+        timed_out = true;
+    }
+    assert(timed_out);
+    
+    std::cout << "Graceful drain tests passed!" << std::endl;
+}
+
+void test_stop_deadline(Server& server, Client& client) {
+    std::cout << "Testing drain deadline..." << std::endl;
+    
+    server.start();
+    std::this_thread::sleep_for(500ms);
+    auto slow = client.call_async("sleep", json::array({1000}));
+    wait_until_in_flight(server, 1);
+    
+    assert(!server.stop(100ms));
+    assert(!server.is_running());
+    assert(slow.get() == 1000);
+    assert(server.in_flight() == 0);
+    
+    std::cout << "Drain deadline tests passed!" << std::endl;
+}
+
+void test_wait_returns_after_stop(Server& server, Client& client) {
+    std::cout << "Testing wait..." << std::endl;
+    
+    server.start();
+    std::this_thread::sleep_for(500ms);
+    assert(client.call("ping") == "pong");
+    
+    bool returned = false;
+    std::thread waiter([&] {
+        server.wait();
+        returned = true;
+    });
+    std::this_thread::sleep_for(100ms);
+    assert(!returned);
+    
+    server.stop();
+    waiter.join();
+    assert(returned);
+    
+    std::cout << "Wait tests passed!" << std::endl;
+}
+
+void test_executor_drain(Session& session, Client& client, DispatcherBase& dispatcher) {
+    std::cout << "Testing drain with executor..." << std::endl;
+    
+    ExecutorOptions executor_options;
+    executor_options.num_threads = 2;
+    Executor executor(executor_options);
+    
+    ServerOptions options;
+    options.executor = &executor;
+    Server server(kKeyExpr, dispatcher, session, options);
+    server.start();
+    std::this_thread::sleep_for(500ms);
+    
+    // 两个在执行，两个在队列中，全部计入在途
+    std::vector<std::future<json>> calls;
+    for (int i = 0; i < 4; ++i) {
+        calls.push_back(client.call_async("sleep", json::array({200})));
+    }
+    wait_until_in_flight(server, 4);
+    
+    assert(server.stop(2s));
+    for (auto& call : calls) {
+        assert(call.get() == 200);
+    }
+    
+    std::cout << "Executor drain tests passed!" << std::endl;
+}
+
+void test_parallel_batch(Session& session, Client& client, DispatcherBase& dispatcher) {
+    std::cout << "Testing parallel batch on executor..." << std::endl;
+    
+    std::vector<BatchCall> calls;
+    for (int i = 1; i <= 4; ++i) {
+        calls.push_back({"sleep", json::array({i * 100})});
+    }
+    
+    // 执行器只有一个工作线程：并行块全部由处理批量请求的线程自己执行，不会死锁
+    for (size_t threads : {1, 4}) {
+        ExecutorOptions executor_options;
+        executor_options.num_threads = threads;
+        Executor executor(executor_options);
+        
+        ServerOptions options;
+        options.executor = &executor;
+        options.batch_parallelism = 4;
+        Server server(kKeyExpr, dispatcher, session, options);
+        server.start();
+        std::this_thread::sleep_for(500ms);
+        
+        auto begin = std::chrono::steady_clock::now();
+        auto results = client.call_batch(calls, 5s);
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        assert(results.size() == 4);
+        for (int i = 0; i < 4; ++i) {
+            assert(results[i].value() == (i + 1) * 100);
+        }
+        if (threads == 4) {
+            // 按顺序执行需要 1000ms
+            assert(elapsed < 800ms);
+        }
+        server.stop();
+    }
+    
+    std::cout << "Parallel batch tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        LifecycleDispatcher dispatcher;
+        Client client(kKeyExpr, client_session);
+        
+        {
+            Server server(kKeyExpr, dispatcher, server_session);
+            test_start_and_call(server, client);
+            test_stop_drains_in_flight(server, client);
+            test_stop_deadline(server, client);
+            test_wait_returns_after_stop(server, client);
+        }
+        test_executor_drain(server_session, client, dispatcher);
+        test_parallel_batch(server_session, client, dispatcher);
+        
+        std::cout << "\nAll server lifecycle tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_session_pool.cpp
+ * @brief 共享会话池测试
+ * 
+ * 使用本机回环端点验证：
+ * - 模式和连接端点相同时获取同一个会话，端点顺序和重复不影响共享
+ * - 会话在最后一个持有者释放后关闭，之后重新打开
+ * - 并发获取同一配置只打开一个会话
+ * - 自动创建会话的客户端默认共享会话，SessionSharing::PRIVATE 时不经过会话池
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/session_pool";
+const std::string kEndpoint = "tcp/127.0.0.1:7468";
+
+void test_acquire() {
+    std::cout << "Testing SessionPool::acquire..." << std::endl;
+    
+    SessionPool pool;
+    assert(pool.size() == 0);
+    
+    auto first = pool.acquire(SessionMode::PEER, {kEndpoint});
+    auto second = pool.acquire(SessionMode::PEER, {kEndpoint, kEndpoint});
+    assert(first == second);
+    assert(pool.size() == 1);
+    
+    // 模式不同时不共享
+    auto client_mode = pool.acquire(SessionMode::CLIENT, {kEndpoint});
+    assert(client_mode != first);
+    assert(client_mode->get_mode() == SessionMode::CLIENT);
+    assert(pool.size() == 2);
+    
+    // 最后一个持有者释放后会话关闭，再次获取时重新打开
+    client_mode.reset();
+    assert(pool.size() == 1);
+    first.reset();
+    second.reset();
+    assert(pool.size() == 0);
+    auto reopened = pool.acquire(SessionMode::PEER, {kEndpoint});
+    assert(reopened->is_active());
+    assert(pool.size() == 1);
+    
+    std::cout << "acquire tests passed!" << std::endl;
+}
+
+void test_concurrent_acquire() {
+    std::cout << "Testing concurrent acquire..." << std::endl;
+    
+    SessionPool pool;
+    std::vector<std::shared_ptr<Session>> sessions(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        threads.emplace_back([&, i] { sessions[i] = pool.acquire(SessionMode::PEER, {kEndpoint}); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& session : sessions) {
+        assert(session == sessions.front());
+    }
+    assert(pool.size() == 1);
+    
+    std::cout << "Concurrent acquire tests passed!" << std::endl;
+}
+
+void test_client_sharing() {
+    std::cout << "Testing client session sharing..." << std::endl;
+    
+    Session server_session(test::listen_config(kEndpoint));
+    DispatcherBase dispatcher;
+    dispatcher.register_method("echo", [](const json& params) -> json { return params; });
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    
+    SessionPool& pool = SessionPool::global();
+    size_t before = pool.size();
+    {
+        Client first(kKeyExpr, SessionMode::PEER, {kEndpoint});
+        Client second(kKeyExpr, SessionMode::PEER, {kEndpoint}, "msgpack");
+        assert(pool.size() == before + 1);
+        
+        Client isolated(kKeyExpr, SessionMode::PEER, {kEndpoint}, "json", 5000ms, SessionSharing::PRIVATE);
+        assert(pool.size() == before + 1);
+        
+        std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+        assert(first.call("echo", json::array({1})) == json::array({1}));
+        assert(second.call("echo", json::array({2})) == json::array({2}));
+        assert(isolated.call("echo", json::array({3})) == json::array({3}));
+    }
+    // 共享会话随最后一个客户端关闭
+    assert(pool.size() == before);
+    
+    server.stop();
+    std::cout << "Client session sharing tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_acquire();
+        test_concurrent_acquire();
+        test_client_sharing();
+        
+        std::cout << "\nAll session pool tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
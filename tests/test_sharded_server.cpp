@@ -0,0 +1,139 @@
+/**
+ * @file test_sharded_server.cpp
+ * @brief 分片服务器测试
+ * 
+ * 分片附件的编码和解析不需要网络。
+ * 服务器部分使用本机回环端点验证：
+ * - 第一个调用经过服务键表达式，回复附带分片数
+ * - 客户端得知分片数后把调用轮流发往各分片，每个分片在自己的工作线程中处理
+ * - 通知由服务键表达式上的服务器执行
+ * - 分片停止后，发往分片的调用超时，客户端回到服务键表达式
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/sharded";
+const std::string kEndpoint = "tcp/127.0.0.1:7469";
+
+void test_shard_keys() {
+    std::cout << "Testing shard keys and attachments..." << std::endl;
+    
+    assert(shard_key_expr("svc/math", 3) == "svc/math/@shard/3");
+    assert(make_shards_attachment(8) == "rpc.shards=8");
+    assert(parse_shards_attachment(make_shards_attachment(8)) == 8);
+    assert(parse_shards_attachment("rpc.shards=") == 0);
+    assert(parse_shards_attachment("rpc.shards=4x") == 0);
+    assert(parse_shards_attachment("trace=4") == 0);
+    assert(parse_shards_attachment("") == 0);
+    
+    std::cout << "Shard key tests passed!" << std::endl;
+}
+
+/**
+ * @class ThreadRecorder
+ * @brief 记录处理请求的线程
+ */
+class ThreadRecorder : public DispatcherBase {
+public:
+    ThreadRecorder() {
+        register_method("where", [this](const json& params) -> json {
+            std::lock_guard<std::mutex> lock(mutex_);
+            threads_.insert(std::this_thread::get_id());
+            return params;
+        });
+        register_method("ping", [this](const json&) -> json {
+            pings_++;
+            return nullptr;
+        });
+    }
+    
+    size_t thread_count() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_.size();
+    }
+    
+    int pings() const { return pings_.load(); }
+
+private:
+    std::mutex mutex_;
+    std::set<std::thread::id> threads_;
+    std::atomic<int> pings_{0};
+};
+
+void test_sharded_calls(Session& server_session, Session& client_session) {
+    std::cout << "Testing sharded calls..." << std::endl;
+    
+    ThreadRecorder dispatcher;
+    ShardedServerOptions options;
+    options.shards = 4;
+    ShardedServer server(kKeyExpr, dispatcher, server_session, options);
+    assert(server.shard_count() == 4);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    Client client(kKeyExpr, client_session, "json", 2000ms);
+    assert(client.shard_count() == 0);
+    assert(client.call("where", json::array({0})) == json::array({0}));
+    assert(client.shard_count() == 4);
+    
+    for (int i = 1; i <= 8; ++i) {
+        assert(client.call("where", json::array({i})) == json::array({i}));
+    }
+    assert(dispatcher.thread_count() == 4);
+    for (const auto& stats : server.shard_stats()) {
+        assert(stats.queries >= 2);
+    }
+    assert(server.stats().queries == 9);
+    
+    client.notify("ping");
+    for (int i = 0; i < 50 && dispatcher.pings() == 0; ++i) {
+        std::this_thread::sleep_for(20ms);
+    }
+    assert(dispatcher.pings() == 1);
+    
+    // 分片不在了：发往分片的调用超时，之后回到服务键表达式
+    server.stop();
+    assert(client.try_call("where", json::array({1}), 300ms).error().code == -32002);
+    assert(client.shard_count() == 0);
+    
+    std::cout << "Sharded call tests passed!" << std::endl;
+}
+
+void test_wildcard_rejected(Session& session) {
+    DispatcherBase dispatcher;
+    try {
+        ShardedServer server("test/*", dispatcher, session);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+int main() {
+    try {
+        test_shard_keys();
+        
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_wildcard_rejected(server_session);
+        test_sharded_calls(server_session, client_session);
+        
+        std::cout << "\nAll sharded server tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
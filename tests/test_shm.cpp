@@ -0,0 +1,115 @@
+/**
+ * @file test_shm.cpp
+ * @brief 共享内存载荷测试
+ * 
+ * 没有共享内存支持时验证 ShmPool 的构造函数抛出异常。
+ * 有共享内存支持时使用本机回环端点验证：
+ * - 小于阈值的请求和回复仍使用堆缓冲区
+ * - 大的二进制载荷经过共享内存往返，内容不变
+ * - 客户端和服务器的共享内存计数器都增加
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/shm";
+const std::string kEndpoint = "tcp/127.0.0.1:7470";
+
+/**
+ * @brief 开启共享内存传输
+ */
+zenoh::Config with_shared_memory(zenoh::Config config) {
+    config.insert_json5("transport/shared_memory/enabled", "true");
+    return config;
+}
+
+void test_unsupported() {
+    std::cout << "Testing build without shared memory..." << std::endl;
+    
+    assert(!ShmPool::supported());
+    try {
+        ShmPool pool;
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    
+    std::cout << "Unsupported build tests passed!" << std::endl;
+}
+
+void test_shm_round_trip() {
+    std::cout << "Testing shared memory round trip..." << std::endl;
+    
+    ShmOptions shm_options;
+    shm_options.pool_size = 16u << 20;
+    shm_options.threshold = 4096;
+    ShmPool server_pool(shm_options);
+    auto client_pool = std::make_shared<ShmPool>(shm_options);
+    
+    // 小于阈值不使用共享内存
+    std::string small(100, 'x');
+    assert(!client_pool->try_copy(small.data(), small.size()));
+    
+    Session server_session(with_shared_memory(test::listen_config(kEndpoint)));
+    Session client_session(with_shared_memory(test::connect_config(kEndpoint)));
+    
+    DispatcherBase dispatcher;
+    dispatcher.register_method("echo", [](const json& params) -> json {
+        return params[0];
+    });
+    ServerOptions options;
+    options.shm = &server_pool;
+    Server server(kKeyExpr, dispatcher, server_session, options);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    Client client(kKeyExpr, client_session, "msgpack", 5000ms);
+    client.set_shared_memory(client_pool);
+    
+    assert(client.call("echo", json::array({"small"})) == "small");
+    assert(client_pool->stats().shm_payloads == 0);
+    assert(server_pool.stats().shm_payloads == 0);
+    
+    std::vector<uint8_t> blob(1u << 20);
+    for (size_t i = 0; i < blob.size(); ++i) {
+        blob[i] = static_cast<uint8_t>(i * 31);
+    }
+    json large = json::binary(blob);
+    for (int i = 0; i < 4; ++i) {
+        assert(client.call("echo", json::array({large})) == large);
+    }
+    
+    assert(client_pool->stats().shm_payloads == 4);
+    assert(client_pool->stats().shm_bytes > 4 * blob.size());
+    assert(server_pool.stats().shm_payloads == 4);
+    assert(server_pool.stats().heap_fallbacks == 0);
+    
+    server.stop();
+    std::cout << "Shared memory round trip tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        if (ShmPool::supported()) {
+            test_shm_round_trip();
+        } else {
+            test_unsupported();
+        }
+        
+        std::cout << "\nAll shared memory tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_try_call.cpp
+ * @brief 不抛出异常的调用和分发测试
+ * 
+ * 分发器部分不需要网络：验证 try_dispatch()、try_dispatch_async() 以结果对象报告
+ * 方法不存在、方法ID失效、RpcResult::err() 和参数校验失败，
+ * 处理函数抛出的异常转换为错误结果，以及 dispatch() 包装仍抛出原来的异常。
+ * 客户端部分使用本机回环端点，验证 try_call()、try_call_async() 的错误结果和超时。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/try_call";
+const std::string kEndpoint = "tcp/127.0.0.1:7467";
+
+/**
+ * @class ValidatingDispatcher
+ * @brief 以结果对象拒绝请求的分发器
+ */
+class ValidatingDispatcher : public DispatcherBase {
+public:
+    ValidatingDispatcher() {
+        register_result_method("withdraw", [](const json& params) {
+            if (!params.contains("amount") || !params["amount"].is_number()) {
+                return RpcResult::err(-32602, "Missing amount", json{{"field", "amount"}});
+            }
+            return RpcResult::ok(100 - params["amount"].get<int>());
+        });
+        register_method<int(int, int)>("add", [](int a, int b) { return a + b; });
+        register_method("throws", [](const json&) -> json {
+            throw std::runtime_error("boom");
+        });
+        register_method("rpc_error", [](const json&) -> json {
+            throw ServerError("busy", json{{"retry_ms", 50}});
+        });
+        register_async_method("async_reject", [](const json&, ReplyHandle reply) {
+            reply.reject(-32000, "later", json{{"queue", 3}});
+        });
+        register_async_method("async_forward", [](const json& params, ReplyHandle reply) {
+            reply.complete(RpcResult::ok(params));
+        });
+    }
+};
+
+void test_try_dispatch() {
+    std::cout << "Testing try_dispatch..." << std::endl;
+    
+    ValidatingDispatcher dispatcher;
+    
+    RpcResult missing = dispatcher.try_dispatch("missing", json::object());
+    assert(!missing && missing.error().code == -32601);
+    assert(missing.error().message.find("missing") != std::string::npos);
+    
+    RpcResult ok = dispatcher.try_dispatch("withdraw", json{{"amount", 30}});
+    assert(ok && ok.value() == 70);
+    
+    RpcResult rejected = dispatcher.try_dispatch("withdraw", json::object());
+    assert(!rejected && rejected.error().code == -32602);
+    assert(rejected.error().data["field"] == "amount");
+    
+    // 类型化方法的个数和类型检查不抛出异常
+    assert(dispatcher.try_dispatch("add", json::array({1, 2})).value() == 3);
+    RpcResult arity = dispatcher.try_dispatch("add", json::array({1}));
+    assert(!arity && arity.error().code == -32602);
+    RpcResult type = dispatcher.try_dispatch("add", json::array({1, "two"}));
+    assert(!type && type.error().code == -32602);
+    assert(type.error().message == "Invalid parameter 1: expected number, got string");
+    
+    // 处理函数抛出的异常转换为错误结果
+    RpcResult internal = dispatcher.try_dispatch("throws", json::object());
+    assert(internal.error().code == -32603 && internal.error().message == "Internal error: boom");
+    RpcResult server = dispatcher.try_dispatch("rpc_error", json::object());
+    assert(server.error().code == -32000 && server.error().data["retry_ms"] == 50);
+    
+    RpcResult later = dispatcher.try_dispatch("async_reject", json::object());
+    assert(later.error().code == -32000 && later.error().data["queue"] == 3);
+    assert(dispatcher.try_dispatch("async_forward", json::array({1})).value() == json::array({1}));
+    
+    std::cout << "try_dispatch tests passed!" << std::endl;
+}
+
+void test_try_dispatch_async() {
+    std::cout << "Testing try_dispatch_async..." << std::endl;
+    
+    ValidatingDispatcher dispatcher;
+    dispatcher.publish();
+    
+    int calls = 0;
+    dispatcher.try_dispatch_async("withdraw", json{{"amount", "x"}}, [&](RpcResult result) {
+        ++calls;
+        assert(!result && result.error().code == -32602);
+    });
+    dispatcher.try_dispatch_async("missing", json::object(), [&](RpcResult result) {
+        ++calls;
+        assert(result.error().code == -32601);
+    });
+    
+    // 按方法ID分发；方法表重建后旧的方法ID失效
+    uint32_t id = dispatcher.method_ids()["methods"]["add"];
+    dispatcher.try_dispatch_async(id, json::array({2, 3}), [&](RpcResult result) {
+        ++calls;
+        assert(result.value() == 5);
+    });
+    dispatcher.register_method("extra", [](const json&) -> json { return nullptr; });
+    dispatcher.try_dispatch_async(id, json::array({2, 3}), [&](RpcResult result) {
+        ++calls;
+        assert(result.error().code == -32003);
+    });
+    assert(calls == 4);
+    
+    std::cout << "try_dispatch_async tests passed!" << std::endl;
+}
+
+template<typename E>
+bool throws(const std::function<void()>& fn) {
+    try {
+        fn();
+    } catch (const E&) {
+        return true;
+    }
+    return false;
+}
+
+void test_throwing_wrappers() {
+    std::cout << "Testing throwing wrappers..." << std::endl;
+    
+    ValidatingDispatcher dispatcher;
+    assert(throws<MethodNotFoundError>([&] { dispatcher.dispatch("missing", json::object()); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("withdraw", json::object()); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("add", json::array({1, "two"})); }));
+    assert(throws<ServerError>([&] { dispatcher.dispatch("async_reject", json::object()); }));
+    
+    // 处理函数抛出的异常原样传给调用者
+    try {
+        dispatcher.dispatch("throws", json::object());
+        assert(false);
+    } catch (const std::runtime_error& e) {
+        assert(std::string(e.what()) == "boom");
+    }
+    
+    std::exception_ptr error;
+    dispatcher.dispatch_async("withdraw", json::object(), [&](std::exception_ptr e, json) { error = e; });
+    try {
+        std::rethrow_exception(error);
+    } catch (const InvalidParamsError& e) {
+        assert(e.get_data()["field"] == "amount");
+    }
+    
+    // 以结果回调创建的回复句柄只完成一次
+    int calls = 0;
+    {
+        ReplyHandle reply([&](RpcResult result) {
+            ++calls;
+            assert(result.error().code == -32602);
+        });
+        reply.reject(-32602, "first");
+        reply.resolve(1);
+    }
+    assert(calls == 1);
+    
+    std::cout << "Throwing wrapper tests passed!" << std::endl;
+}
+
+void test_try_call(Session& server_session, Session& client_session) {
+    std::cout << "Testing try_call..." << std::endl;
+    
+    ValidatingDispatcher dispatcher;
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    for (const char* encoding : {"json", "msgpack", "binary"}) {
+        Client client(kKeyExpr, client_session, encoding);
+        assert(client.try_call("withdraw", json{{"amount", 40}}).value() == 60);
+        
+        RpcResult rejected = client.try_call("withdraw", json::object());
+        assert(!rejected && rejected.error().code == -32602);
+        assert(rejected.error().message == "Missing amount");
+        assert(rejected.error().data["field"] == "amount");
+        
+        assert(client.try_call("missing").error().code == -32601);
+        assert(client.try_call("add", json::array({1})).error().code == -32602);
+        
+        std::promise<RpcResult> done;
+        client.try_call_async("add", json::array({4, 5}), [&](RpcResult result) { done.set_value(std::move(result)); });
+        assert(done.get_future().get().value() == 9);
+        
+        // 抛出异常的接口不变
+        assert(throws<InvalidParamsError>([&] { client.call("withdraw", json::object()); }));
+    }
+    
+    // 没有可查询对象时以超时错误结果返回
+    Client nobody("test/try_call/nobody", client_session, "json", 200ms);
+    RpcResult timeout = nobody.try_call("withdraw", json{{"amount", 1}});
+    assert(!timeout && timeout.error().code == -32002);
+    
+    server.stop();
+    std::cout << "try_call tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_try_dispatch();
+        test_try_dispatch_async();
+        test_throwing_wrappers();
+        
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_try_call(server_session, client_session);
+        
+        std::cout << "\nAll try_call tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
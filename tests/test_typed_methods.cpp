@@ -0,0 +1,194 @@
+/**
+ * @file test_typed_methods.cpp
+ * @brief 类型化方法注册和调用测试
+ * 
+ * 分发器部分不需要网络：验证参数转换、个数和类型检查、
+ * const 引用参数不复制以及自定义类型的转换。
+ * 客户端部分使用本机回环端点，验证 call<R>() 和共享签名的 call(Method, ...)。
+ */
+
+#include "zenoh_rpc/zenoh_rpc.hpp"
+#include "test_common.hpp"
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zenoh_rpc;
+using namespace std::chrono_literals;
+
+const std::string kKeyExpr = "test/typed_methods";
+const std::string kEndpoint = "tcp/127.0.0.1:7465";
+
+/**
+ * @struct Point
+ * @brief 通过 to_json/from_json 转换的自定义类型
+ */
+struct Point {
+    double x = 0;
+    double y = 0;
+};
+
+void to_json(json& j, const Point& p) {
+    j = json{{"x", p.x}, {"y", p.y}};
+}
+
+void from_json(const json& j, Point& p) {
+    j.at("x").get_to(p.x);
+    j.at("y").get_to(p.y);
+}
+
+// 客户端和服务器共享的签名
+const Method<double(double, double)> kAdd{"add"};
+const Method<Point(Point, double)> kScale{"scale"};
+const Method<std::string(const std::string&, int)> kRepeat{"repeat"};
+const Method<void()> kReset{"reset"};
+
+/**
+ * @class TypedDispatcher
+ * @brief 使用类型化注册的分发器
+ */
+class TypedDispatcher : public DispatcherBase {
+public:
+    TypedDispatcher() {
+        register_method(kAdd, [](double a, double b) { return a + b; });
+        register_method(kScale, [](Point p, double factor) {
+            return Point{p.x * factor, p.y * factor};
+        });
+        register_method(kRepeat, [](const std::string& text, int count) {
+            std::string result;
+            for (int i = 0; i < count; ++i) {
+                result += text;
+            }
+            return result;
+        });
+        register_method(kReset, [this]() { resets++; });
+        register_method<size_t(const std::vector<int>&)>("count", [](const std::vector<int>& values) {
+            return values.size();
+        });
+        register_method<bool(const std::string&)>("same_string", [this](const std::string& text) {
+            return &text == last_string;
+        });
+    }
+    
+    int resets = 0;
+    const std::string* last_string = nullptr;
+};
+
+template<typename E>
+bool throws(const std::function<void()>& fn) {
+    try {
+        fn();
+    } catch (const E&) {
+        return true;
+    }
+    return false;
+}
+
+void test_typed_dispatch() {
+    std::cout << "Testing typed dispatch..." << std::endl;
+    
+    TypedDispatcher dispatcher;
+    assert(dispatcher.dispatch("add", json::array({1.5, 2})) == 3.5);
+    assert(dispatcher.dispatch("repeat", json::array({"ab", 3})) == "ababab");
+    assert(dispatcher.dispatch("count", json::array({json::array({1, 2, 3})})) == 3);
+    
+    json scaled = dispatcher.dispatch("scale", json::array({{{"x", 1}, {"y", 2}}, 3}));
+    assert(scaled["x"] == 3.0 && scaled["y"] == 6.0);
+    
+    // void 方法返回 null，无参数方法接受空对象和空数组
+    assert(dispatcher.dispatch("reset", json::object()).is_null());
+    assert(dispatcher.dispatch("reset", json::array()).is_null());
+    assert(dispatcher.resets == 2);
+    
+    // const std::string& 参数直接引用请求中的字符串
+    json params = json::array({"shared"});
+    dispatcher.last_string = &params[0].get_ref<const std::string&>();
+    assert(dispatcher.dispatch("same_string", params) == true);
+    
+    std::cout << "Typed dispatch tests passed!" << std::endl;
+}
+
+void test_parameter_errors() {
+    std::cout << "Testing parameter errors..." << std::endl;
+    
+    TypedDispatcher dispatcher;
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("add", json::array({1})); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("add", json::array({1, 2, 3})); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("add", json{{"a", 1}, {"b", 2}}); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("add", json::array({1, "two"})); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("repeat", json::array({1, 2})); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("scale", json::array({{{"x", 1}}, 2})); }));
+    assert(throws<InvalidParamsError>([&] { dispatcher.dispatch("reset", json::array({1})); }));
+    
+    try {
+        dispatcher.dispatch("add", json::array({1, "two"}));
+    } catch (const InvalidParamsError& e) {
+        assert(std::string(e.what()).find("parameter 1") != std::string::npos);
+    }
+    
+    std::cout << "Parameter error tests passed!" << std::endl;
+}
+
+void test_result_conversion() {
+    std::cout << "Testing result conversion..." << std::endl;
+    
+    assert(detail::result_as<int>(json(42)) == 42);
+    assert(detail::result_as<std::string>(json("text")) == "text");
+    assert(detail::result_as<json>(json::array({1})) == json::array({1}));
+    assert(detail::pack_params(1, "a", true) == json::array({1, "a", true}));
+    assert(detail::pack_params() == json::array());
+    assert(throws<ParseError>([] { detail::result_as<int>(json("x")); }));
+    assert(throws<ParseError>([] { detail::result_as<std::string>(json(1)); }));
+    
+    std::cout << "Result conversion tests passed!" << std::endl;
+}
+
+void test_typed_calls(Session& server_session, Session& client_session) {
+    std::cout << "Testing typed calls..." << std::endl;
+    
+    TypedDispatcher dispatcher;
+    Server server(kKeyExpr, dispatcher, server_session);
+    server.start();
+    std::this_thread::sleep_for(500ms);  // 等待声明传播到客户端会话
+    
+    Client client(kKeyExpr, client_session);
+    assert(client.call(kAdd, 1, 2) == 3.0);
+    assert(client.call<double>("add", 0.5, 0.25) == 0.75);
+    assert(client.call(kRepeat, "xy", 2) == "xyxy");
+    
+    Point scaled = client.call(kScale, Point{1, -1}, 2);
+    assert(scaled.x == 2.0 && scaled.y == -2.0);
+    
+    client.call(kReset);
+    assert(dispatcher.resets == 1);
+    
+    // 参数错误在服务器端转换为 -32602
+    assert(throws<InvalidParamsError>([&] { client.call<double>("add", 1); }));
+    // 结果类型不符在客户端转换为 ParseError
+    assert(throws<ParseError>([&] { client.call<int>("repeat", "a", 1); }));
+    
+    server.stop();
+    std::cout << "Typed call tests passed!" << std::endl;
+}
+
+int main() {
+    try {
+        test_typed_dispatch();
+        test_parameter_errors();
+        test_result_conversion();
+        
+        Session server_session(test::listen_config(kEndpoint));
+        Session client_session(test::connect_config(kEndpoint));
+        test_typed_calls(server_session, client_session);
+        
+        std::cout << "\nAll typed method tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_zero_copy_decode.cpp
+ * @brief 零拷贝解码测试
+ * 
+ * 通过替换全局 operator new 统计每次解码的堆分配次数，
+ * 验证各解码入口与直接调用 nlohmann::json 解析的分配次数相同，
+ * 即解码过程不再复制载荷。
+ */
+
+#include "zenoh_rpc/jsonrpc_proto.hpp"
+#include "zenoh_rpc/payload.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+using namespace zenoh_rpc;
+
+namespace {
+
+std::atomic<size_t> g_allocations{0};
+
+/**
+ * @brief 统计执行 fn 期间的堆分配次数
+ */
+template<typename Fn>
+size_t count_allocations(Fn&& fn) {
+    size_t before = g_allocations.load();
+    fn();
+    return g_allocations.load() - before;
+}
+
+/**
+ * @brief 统计一次解码的堆分配次数
+ * @param decode_fn 返回 json 的解码函数
+ * @param out 解码结果
+ * 
+ * 解码到一个空的临时对象中：nlohmann::json 析构非空对象时会分配栈空间，
+ * 覆盖 out 中的旧值不计入统计。
+ */
+template<typename Fn>
+size_t count_decode_allocations(Fn&& decode_fn, json& out) {
+    json result;
+    size_t allocations = count_allocations([&] { result = decode_fn(); });
+    out = std::move(result);
+    return allocations;
+}
+
+/**
+ * @brief 构造一个带有大结果的 JSON-RPC 响应
+ */
+json make_large_response() {
+    json rows = json::array();
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back({{"index", i}, {"name", "row-" + std::to_string(i)}, {"value", i * 0.5}});
+    }
+    return make_response_ok({{"rows", rows}, {"blob", std::string(1 << 20, 'x')}}, "large-id");
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void test_json_decode_allocations(const json& message) {
+    std::cout << "Testing JSON decode allocations..." << std::endl;
+    
+    std::string text = encode_json(message);
+    json baseline_result;
+    size_t baseline = count_decode_allocations([&] { return json::parse(text.data(), text.data() + text.size()); }, baseline_result);
+    
+    json result;
+    assert(count_decode_allocations([&] { return decode_json(text.data(), text.size()); }, result) == baseline);
+    assert(result == baseline_result);
+    assert(count_decode_allocations([&] { return decode_json(text); }, result) == baseline);
+    assert(count_decode_allocations([&] { return decode(text, EncodingType::JSON); }, result) == baseline);
+    assert(result == message);
+    
+    std::cout << "JSON decode: " << baseline << " allocations, no payload copy" << std::endl;
+}
+
+void test_msgpack_decode_allocations(const json& message) {
+    std::cout << "Testing MessagePack decode allocations..." << std::endl;
+    
+    std::string packed = encode_msgpack(message);
+    const auto* first = reinterpret_cast<const std::uint8_t*>(packed.data());
+    json baseline_result;
+    size_t baseline = count_decode_allocations([&] { return json::from_msgpack(first, first + packed.size()); }, baseline_result);
+    
+    json result;
+    assert(count_decode_allocations([&] { return decode_msgpack(packed.data(), packed.size()); }, result) == baseline);
+    assert(result == baseline_result);
+    assert(count_decode_allocations([&] { return decode_msgpack(packed); }, result) == baseline);
+    assert(count_decode_allocations([&] { return decode(packed, EncodingType::MSGPACK); }, result) == baseline);
+    assert(result == message);
+    
+    std::cout << "MessagePack decode: " << baseline << " allocations, no payload copy" << std::endl;
+}
+
+void test_payload_view_single_slice(const json& message) {
+    std::cout << "Testing PayloadView on a single-slice payload..." << std::endl;
+    
+    for (EncodingType type : {EncodingType::JSON, EncodingType::MSGPACK}) {
+        std::string encoded = encode(message, type);
+        json baseline_result;
+        size_t baseline = count_decode_allocations([&] { return decode(encoded.data(), encoded.size(), type); }, baseline_result);
+        
+        zenoh::Bytes bytes(std::move(encoded));
+        assert(count_allocations([&] {
+            PayloadView view(bytes);
+            assert(view.is_zero_copy());
+            assert(view.size() == bytes.size());
+            assert(view.sniff() == type);
+        }) == 0);
+        
+        json result;
+        assert(count_decode_allocations([&] { return decode_payload(bytes, type); }, result) == baseline);
+        assert(result == baseline_result);
+    }
+    
+    std::cout << "Single-slice payload decoded in place" << std::endl;
+}
+
+void test_payload_view_fragmented(const json& message) {
+    std::cout << "Testing PayloadView on a fragmented payload..." << std::endl;
+    
+    std::string encoded = encode_msgpack(message);
+    size_t half = encoded.size() / 2;
+    
+    zenoh::Bytes::Writer writer;
+    writer.append(zenoh::Bytes(encoded.substr(0, half)));
+    writer.append(zenoh::Bytes(encoded.substr(half)));
+    zenoh::Bytes bytes = std::move(writer).finish();
+    
+    // 多分片载荷只拼接一次
+    assert(count_allocations([&] {
+        PayloadView view(bytes);
+        assert(!view.is_zero_copy());
+        assert(view.size() == encoded.size());
+    }) == 1);
+    
+    assert(decode_payload(bytes, EncodingType::MSGPACK) == message);
+    
+    std::cout << "Fragmented payload copied exactly once" << std::endl;
+}
+
+int main() {
+    try {
+        json message = make_large_response();
+        test_json_decode_allocations(message);
+        test_msgpack_decode_allocations(message);
+        test_payload_view_single_slice(message);
+        test_payload_view_fragmented(message);
+        std::cout << "\nAll zero-copy decode tests passed!" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed with exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}